@@ -31,6 +31,12 @@ public class RD : ModuleRules
 
 		PublicDefinitions.Add("_SILENCE_ALL_CXX17_DEPRECATION_WARNINGS");
 
+		// RD_LOG_* calls below this level are compiled out
+		if (Target.Configuration == UnrealTargetConfiguration.Shipping)
+		{
+			PublicDefinitions.Add("RD_ACTIVE_LOG_LEVEL=SPDLOG_LEVEL_WARN");
+		}
+
 		if (Target.Platform == UnrealTargetPlatform.Win64)
 		{
 			PublicDefinitions.Add("_WINSOCK_DEPRECATED_NO_WARNINGS");
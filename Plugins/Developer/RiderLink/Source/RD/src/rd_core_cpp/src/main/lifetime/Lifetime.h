@@ -9,6 +9,7 @@
 #include "LifetimeImpl.h"
 
 #include <std/hash.h>
+#include <util/pool_allocator.h>
 
 #include <memory>
 
@@ -27,7 +28,7 @@ struct RD_CORE_API hash<Lifetime>
 class RD_CORE_API Lifetime final
 {
 private:
-	using Allocator = std::allocator<LifetimeImpl>;
+	using Allocator = util::pool_allocator<LifetimeImpl>;
 
 	static /*thread_local */ Allocator allocator;
 
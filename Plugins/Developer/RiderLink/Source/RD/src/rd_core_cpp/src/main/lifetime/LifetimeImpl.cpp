@@ -1,15 +1,119 @@
 #include "LifetimeImpl.h"
 
+#include <util/pool_allocator.h>
+
 #include <utility>
 
 namespace rd
 {
 #if __cplusplus < 201703L
-LifetimeImpl::counter_t LifetimeImpl::get_id = 0;
+std::atomic<LifetimeImpl::counter_t> LifetimeImpl::get_id{0};
 #endif
 
-LifetimeImpl::LifetimeImpl(bool is_eternal) : eternaled(is_eternal), id(LifetimeImpl::get_id++)
+namespace
+{
+constexpr int32_t min_dead_actions_to_sweep = 16;
+}	 // namespace
+
+LifetimeImpl::LifetimeImpl(bool is_eternal) : eternaled(is_eternal), id(get_id.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+void LifetimeImpl::ActionNode::reset()
+{
+	if (invoke != nullptr)
+	{
+		destroy(storage);
+		invoke = nullptr;
+		destroy = nullptr;
+	}
+	nested.reset();
+}
+
+LifetimeImpl::ActionNode* LifetimeImpl::new_node()
+{
+	return new (util::fixed_block_pool<sizeof(ActionNode), alignof(ActionNode)>::instance().allocate()) ActionNode();
+}
+
+void LifetimeImpl::free_node(ActionNode* node) noexcept
+{
+	node->reset();
+	node->~ActionNode();
+	util::fixed_block_pool<sizeof(ActionNode), alignof(ActionNode)>::instance().deallocate(node);
+}
+
+LifetimeImpl::ActionHandle LifetimeImpl::link(ActionNode* node)
+{
+	if (dead_actions >= min_dead_actions_to_sweep && dead_actions > live_actions)
+	{
+		for (ActionNode** it = &actions; *it != nullptr;)
+		{
+			ActionNode* current = *it;
+			if (current->is_tombstone())
+			{
+				*it = current->next;
+				free_node(current);
+			}
+			else
+			{
+				it = &current->next;
+			}
+		}
+		dead_actions = 0;
+	}
+
+	node->id = action_id_in_map++;
+	node->next = actions;
+	actions = node;
+	++live_actions;
+	return {node, node->id};
+}
+
+void LifetimeImpl::tombstone(ActionNode* node)
+{
+	node->reset();
+	--live_actions;
+	++dead_actions;
+}
+
+void LifetimeImpl::remove_action(ActionHandle const& handle)
 {
+	std::lock_guard<decltype(actions_lock)> guard(actions_lock);
+
+	// a node is only freed after it was removed or taken by terminate
+	if (handle.node == nullptr || actions_taken)
+	{
+		return;
+	}
+	if (handle.node->id == handle.id && !handle.node->is_tombstone())
+	{
+		tombstone(handle.node);
+	}
+}
+
+std::shared_ptr<LifetimeImpl> LifetimeImpl::detach_from_parent()
+{
+	if (parent.load() == nullptr)
+	{
+		return nullptr;
+	}
+	std::shared_ptr<LifetimeImpl> p = parent_ref.lock();
+	if (p == nullptr)
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<LifetimeImpl> self;
+	std::lock_guard<decltype(actions_lock)> guard(p->actions_lock);
+	// the parent clears the link under its lock when it terminates first
+	if (parent.load() == p.get())
+	{
+		self = std::move(parent_node->nested);
+		p->tombstone(parent_node);
+		parent = nullptr;
+		parent_node = nullptr;
+	}
+	return self;
 }
 
 void LifetimeImpl::terminate()
@@ -19,20 +123,44 @@ void LifetimeImpl::terminate()
 
 	terminated = true;
 
+	// keeps this alive if the parent held the last reference
+	std::shared_ptr<LifetimeImpl> self = detach_from_parent();
+
 	// region thread-safety section
 
-	actions_t actions_copy;
+	ActionNode* head = nullptr;
 	{
 		std::lock_guard<decltype(actions_lock)> guard(actions_lock);
-		actions_copy = std::move(actions);
+		head = actions;
+		actions = nullptr;
+		actions_taken = true;
+		live_actions = 0;
+		dead_actions = 0;
 
-		actions.clear();
+		for (ActionNode* node = head; node != nullptr; node = node->next)
+		{
+			if (node->nested != nullptr)
+			{
+				node->nested->parent = nullptr;
+				node->nested->parent_node = nullptr;
+			}
+		}
 	}
 	// endregion
 
-	for (auto it = actions_copy.rbegin(); it != actions_copy.rend(); ++it)
+	while (head != nullptr)
 	{
-		it->second();
+		ActionNode* node = head;
+		head = node->next;
+		if (node->nested != nullptr)
+		{
+			node->nested->terminate();
+		}
+		else if (node->invoke != nullptr)
+		{
+			node->invoke(node->storage);
+		}
+		free_node(node);
 	}
 }
 
@@ -51,9 +179,20 @@ void LifetimeImpl::attach_nested(std::shared_ptr<LifetimeImpl> nested)
 	if (nested->is_terminated() || is_eternal())
 		return;
 
-	std::function<void()> action = [nested] { nested->terminate(); };
-	counter_t action_id = add_action(action);
-	nested->add_action([this, id = action_id] { actions.erase(id); });
+	std::lock_guard<decltype(actions_lock)> guard(actions_lock);
+
+	if (is_terminated())
+	{
+		throw std::invalid_argument("Already Terminated");
+	}
+
+	ActionNode* node = new_node();
+	LifetimeImpl* child = nested.get();
+	node->nested = std::move(nested);
+	link(node);
+	child->parent_ref = shared_from_this();
+	child->parent_node = node;
+	child->parent = this;
 }
 
 LifetimeImpl::~LifetimeImpl()
@@ -62,5 +201,19 @@ LifetimeImpl::~LifetimeImpl()
 		spdlog::error("forget to terminate lifetime with id: {}", to_string(id));
 		terminate();
 	}*/
+
+	// actions of a lifetime which was never terminated are dropped without running
+	while (actions != nullptr)
+	{
+		ActionNode* node = actions;
+		actions = node->next;
+		if (node->nested != nullptr)
+		{
+			std::lock_guard<decltype(actions_lock)> guard(actions_lock);
+			node->nested->parent = nullptr;
+			node->nested->parent_node = nullptr;
+		}
+		free_node(node);
+	}
 }
 }	 // namespace rd
@@ -3,14 +3,18 @@
 
 #if defined(_MSC_VER)
 #pragma warning(push)
-#pragma warning(disable:4251)
+#pragma warning(disable:4251 4275)
 #endif
 
 #include <std/hash.h>
 
+#include <cstddef>
 #include <functional>
 #include <map>
 #include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
 #include <mutex>
 #include <atomic>
 #include <utility>
@@ -21,7 +25,12 @@
 
 namespace rd
 {
-class RD_CORE_API LifetimeImpl final
+/**
+ * \brief Actions are kept in an intrusive singly-linked list, newest first, so termination runs them in reverse order of
+ * addition. Nested lifetimes are linked into the same list directly. Removed actions and terminated nested lifetimes
+ * leave tombstones which are swept once they outnumber the live nodes.
+ */
+class RD_CORE_API LifetimeImpl final : public std::enable_shared_from_this<LifetimeImpl>
 {
 public:
 	friend class LifetimeDefinition;
@@ -30,6 +39,70 @@ public:
 
 	using counter_t = int32_t;
 
+private:
+	class ActionNode
+	{
+	public:
+		static constexpr size_t inline_size = 4 * sizeof(void*);
+
+		ActionNode* next = nullptr;
+		counter_t id = 0;
+		void (*invoke)(void* storage) = nullptr;
+		void (*destroy)(void* storage) = nullptr;
+		std::shared_ptr<LifetimeImpl> nested;
+		alignas(std::max_align_t) unsigned char storage[inline_size];
+
+		template <typename F>
+		void emplace(F&& action)
+		{
+			using Fn = typename std::decay<F>::type;
+			emplace<Fn>(std::forward<F>(action),
+				std::integral_constant<bool, sizeof(Fn) <= inline_size && alignof(Fn) <= alignof(std::max_align_t)>{});
+		}
+
+		template <typename Fn, typename F>
+		void emplace(F&& action, std::true_type /*fits in place*/)
+		{
+			new (storage) Fn(std::forward<F>(action));
+			invoke = [](void* s) { (*static_cast<Fn*>(s))(); };
+			destroy = [](void* s) { static_cast<Fn*>(s)->~Fn(); };
+		}
+
+		template <typename Fn, typename F>
+		void emplace(F&& action, std::false_type /*fits in place*/)
+		{
+			*reinterpret_cast<Fn**>(storage) = new Fn(std::forward<F>(action));
+			invoke = [](void* s) { (**static_cast<Fn**>(s))(); };
+			destroy = [](void* s) { delete *static_cast<Fn**>(s); };
+		}
+
+		bool is_tombstone() const
+		{
+			return invoke == nullptr && nested == nullptr;
+		}
+
+		void reset();
+	};
+
+public:
+	/**
+	 * \brief Identifies an action for [remove_action]. Empty for actions of an eternal lifetime.
+	 */
+	class ActionHandle
+	{
+		friend class LifetimeImpl;
+
+		ActionNode* node = nullptr;
+		counter_t id = 0;
+
+		ActionHandle(ActionNode* node, counter_t id) : node(node), id(id)
+		{
+		}
+
+	public:
+		ActionHandle() = default;
+	};
+
 private:
 	bool eternaled = false;
 	std::atomic<bool> terminated{false};
@@ -37,13 +110,31 @@ private:
 	counter_t id = 0;
 
 	counter_t action_id_in_map = 0;
-	using actions_t = ordered_map<int, std::function<void()>, rd::hash<int>>;
-	actions_t actions;
+	ActionNode* actions = nullptr;
+	int32_t live_actions = 0;
+	int32_t dead_actions = 0;
+	bool actions_taken = false;
+
+	// set once by attach_nested, keeps the parent's actions_lock alive while detaching
+	std::weak_ptr<LifetimeImpl> parent_ref;
+	// guarded by the parent's actions_lock
+	std::atomic<LifetimeImpl*> parent{nullptr};
+	ActionNode* parent_node = nullptr;
 
 	void terminate();
 
 	std::mutex actions_lock;
 
+	static ActionNode* new_node();
+
+	static void free_node(ActionNode* node) noexcept;
+
+	ActionHandle link(ActionNode* node);
+
+	void tombstone(ActionNode* node);
+
+	std::shared_ptr<LifetimeImpl> detach_from_parent();
+
 public:
 	// region ctor/dtor
 	explicit LifetimeImpl(bool is_eternal = false);
@@ -54,34 +145,41 @@ public:
 	// endregion
 
 	template <typename F>
-	counter_t add_action(F&& action)
+	ActionHandle add_action(F&& action)
 	{
 		std::lock_guard<decltype(actions_lock)> guard(actions_lock);
 
 		if (is_eternal())
 		{
-			return -1;
+			return {};
 		}
 		if (is_terminated())
 		{
 			throw std::invalid_argument("Already Terminated");
 		}
 
-		actions[action_id_in_map] = std::forward<F>(action);
-		return action_id_in_map++;
+		ActionNode* node = new_node();
+		try
+		{
+			node->emplace(std::forward<F>(action));
+		}
+		catch (...)
+		{
+			free_node(node);
+			throw;
+		}
+		return link(node);
 	}
 
-	void remove_action(counter_t i)
-	{
-		std::lock_guard<decltype(actions_lock)> guard(actions_lock);
-
-		actions.erase(i);
-	}
+	/**
+	 * \brief Removes an action which has not run yet in O(1). Does nothing once termination has taken the actions.
+	 */
+	void remove_action(ActionHandle const& handle);
 
 #if __cplusplus >= 201703L
-	static inline counter_t get_id = 0;
+	static inline std::atomic<counter_t> get_id{0};
 #else
-	static counter_t get_id;
+	static std::atomic<counter_t> get_id;
 #endif
 
 	template <typename F, typename G>
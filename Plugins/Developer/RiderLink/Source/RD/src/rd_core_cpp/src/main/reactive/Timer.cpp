@@ -0,0 +1,95 @@
+#include "Timer.h"
+
+#include <algorithm>
+
+namespace rd
+{
+Timer::~Timer()
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		stopping = true;
+	}
+	cv.notify_all();
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+}
+
+Timer& Timer::shared()
+{
+	// never destroyed: tasks may be cancelled during static destruction
+	static Timer* timer = new Timer();
+	return *timer;
+}
+
+void Timer::ThreadProc()
+{
+	std::unique_lock<decltype(lock)> guard(lock);
+	while (!stopping)
+	{
+		if (armed.empty())
+		{
+			cv.wait(guard);
+			continue;
+		}
+
+		auto next = std::min_element(
+			armed.begin(), armed.end(), [](Task const* lhs, Task const* rhs) { return lhs->deadline < rhs->deadline; });
+		if (clock::now() < (*next)->deadline)
+		{
+			cv.wait_until(guard, (*next)->deadline);
+			continue;
+		}
+
+		Task* task = *next;
+		*next = armed.back();
+		armed.pop_back();
+		task->armed = false;
+
+		running = task;
+		guard.unlock();
+		task->on_timer();
+		guard.lock();
+		running = nullptr;
+		idle_cv.notify_all();
+	}
+}
+
+void Timer::schedule(Task* task, clock::time_point deadline)
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (stopping)
+		{
+			return;
+		}
+		if (!thread.joinable())
+		{
+			thread = std::thread(&Timer::ThreadProc, this);
+		}
+		task->deadline = deadline;
+		if (!task->armed)
+		{
+			task->armed = true;
+			armed.push_back(task);
+		}
+	}
+	cv.notify_all();
+}
+
+void Timer::cancel(Task* task)
+{
+	std::unique_lock<decltype(lock)> guard(lock);
+	if (task->armed)
+	{
+		task->armed = false;
+		armed.erase(std::find(armed.begin(), armed.end(), task));
+	}
+	if (std::this_thread::get_id() != thread.get_id())
+	{
+		idle_cv.wait(guard, [this, task] { return running != task; });
+	}
+}
+}	 // namespace rd
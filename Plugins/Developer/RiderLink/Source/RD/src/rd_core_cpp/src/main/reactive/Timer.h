@@ -0,0 +1,90 @@
+#ifndef RD_CPP_CORE_TIMER_H
+#define RD_CPP_CORE_TIMER_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <rd_core_export.h>
+
+namespace rd
+{
+/**
+ * \brief Runs tasks at their deadlines on a single background thread.
+ *
+ * Tasks are owned by the caller and armed at most once at a time, so scheduling never allocates once the armed list
+ * has grown to the number of tasks in use. [Task::on_timer] runs on the timer thread and should only hand the work
+ * over to a scheduler.
+ */
+class RD_CORE_API Timer
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+	class RD_CORE_API Task
+	{
+		friend class Timer;
+
+		clock::time_point deadline;
+		bool armed = false;
+
+	public:
+		virtual ~Task() = default;
+
+		virtual void on_timer() = 0;
+	};
+
+private:
+	std::mutex lock;
+	std::condition_variable cv;
+	std::condition_variable idle_cv;
+
+	std::vector<Task*> armed;
+	Task* running = nullptr;
+	bool stopping = false;
+
+	std::thread thread;
+
+	void ThreadProc();
+
+public:
+	// region ctor/dtor
+
+	Timer() = default;
+
+	Timer(Timer const&) = delete;
+
+	Timer& operator=(Timer const&) = delete;
+
+	virtual ~Timer();
+	// endregion
+
+	/**
+	 * \brief Process-wide timer, never destroyed.
+	 */
+	static Timer& shared();
+
+	/**
+	 * \brief Arms [task] to run at [deadline]. Moves the deadline if the task is already armed.
+	 */
+	void schedule(Task* task, clock::time_point deadline);
+
+	/**
+	 * \brief Disarms [task] and waits for its [Task::on_timer] to return if it is running on another thread.
+	 */
+	void cancel(Task* task);
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+
+#endif	  // RD_CPP_CORE_TIMER_H
@@ -5,6 +5,8 @@
 #include "reactive/base/SignalX.h"
 #include "util/core_util.h"
 
+#include <std/unordered_set.h>
+
 #include <algorithm>
 #include <iterator>
 #include <utility>
@@ -34,6 +36,37 @@ protected:
 		return list;
 	}
 
+private:
+	bool contains_any(std::vector<WT> const& elements, std::vector<bool>& found, std::true_type /*hashable*/) const
+	{
+		rd::unordered_set<T const*, wrapper::TransparentHash<T>, wrapper::TransparentKeyEqual<T>> set;
+		set.reserve(elements.size());
+		for (auto const& element : elements)
+		{
+			set.insert(&wrapper::get<T>(element));
+		}
+		bool res = false;
+		for (size_t i = 0; i < list.size(); ++i)
+		{
+			found[i] = set.count(&*list[i]) > 0;
+			res |= found[i];
+		}
+		return res;
+	}
+
+	bool contains_any(std::vector<WT> const& elements, std::vector<bool>& found, std::false_type /*hashable*/) const
+	{
+		bool res = false;
+		for (size_t i = 0; i < list.size(); ++i)
+		{
+			auto const& x = list[i];
+			found[i] = std::any_of(elements.begin(), elements.end(),
+				[&x](auto const& elem) { return wrapper::TransparentKeyEqual<T>()(elem, x); });
+			res |= found[i];
+		}
+		return res;
+	}
+
 public:
 	// region ctor/dtor
 
@@ -207,13 +240,30 @@ public:
 	{
 		if (lifetime->is_terminated())
 			return;
-		change.advise(lifetime, handler);
+		change.advise(lifetime, [handler](Event const& e) { e.for_each_element(handler); });
 		for (int32_t i = 0; i < static_cast<int32_t>(size()); ++i)
 		{
 			handler(typename Event::Add(i, &(*list[i])));
 		}
 	}
 
+	void advise_ranges(Lifetime lifetime, std::function<void(Event const&)> handler) const override
+	{
+		if (lifetime->is_terminated())
+			return;
+		change.advise(lifetime, handler);
+		if (!list.empty())
+		{
+			std::vector<T const*> values;
+			values.reserve(list.size());
+			for (auto const& x : list)
+			{
+				values.push_back(&*x);
+			}
+			handler(typename Event::AddRange(0, std::move(values)));
+		}
+	}
+
 	bool add(WT element) const override
 	{
 		list.emplace_back(std::move(element));
@@ -263,54 +313,127 @@ public:
 
 	bool addAll(size_t index, std::vector<WT> elements) const override
 	{
-		for (auto& element : elements)
-		{
-			ViewableList::add(index, std::move(element));
-			++index;
-		}
+		ViewableList::addRange(index, std::move(elements));
 		return true;
 	}
 
 	bool addAll(std::vector<WT> elements) const override
 	{
-		for (auto&& element : elements)
+		ViewableList::addRange(size(), std::move(elements));
+		return true;
+	}
+
+	void clear() const override
+	{
+		ViewableList::removeRange(0, size());
+	}
+
+	bool removeAll(std::vector<WT> elements) const override
+	{
+		std::vector<bool> found(list.size());
+		if (!contains_any(elements, found, util::is_hashable<T>{}))
+		{
+			return false;
+		}
+		// compact in one pass, then report each run of removed elements from the back so that earlier indices stay valid
+		std::vector<Wrapper<T>> removed;
+		std::vector<std::pair<size_t, size_t>> runs;	// original index and length
+		size_t kept = 0;
+		for (size_t i = 0; i < list.size(); ++i)
+		{
+			if (found[i])
+			{
+				if (!runs.empty() && runs.back().first + runs.back().second == i)
+				{
+					++runs.back().second;
+				}
+				else
+				{
+					runs.emplace_back(i, 1);
+				}
+				removed.push_back(std::move(list[i]));
+			}
+			else
+			{
+				list[kept++] = std::move(list[i]);
+			}
+		}
+		list.erase(list.begin() + kept, list.end());
+
+		size_t end = removed.size();
+		for (auto run = runs.rbegin(); run != runs.rend(); ++run)
 		{
-			ViewableList::add(std::move(element));
+			std::vector<T const*> values;
+			values.reserve(run->second);
+			for (size_t i = end - run->second; i < end; ++i)
+			{
+				values.push_back(&*removed[i]);
+			}
+			end -= run->second;
+			change.fire(typename Event::RemoveRange(static_cast<int32_t>(run->first), std::move(values)));
 		}
 		return true;
 	}
 
-	void clear() const override
+	bool addRange(size_t index, std::vector<WT> elements) const override
 	{
-		std::vector<Event> changes;
-		for (size_t i = size(); i > 0; --i)
+		if (elements.empty())
 		{
-			changes.push_back(typename Event::Remove(static_cast<int32_t>(i - 1), &(*list[i - 1])));
+			return false;
 		}
-		for (auto const& e : changes)
+		list.insert(list.begin() + index, std::make_move_iterator(elements.begin()), std::make_move_iterator(elements.end()));
+
+		std::vector<T const*> values;
+		values.reserve(elements.size());
+		for (size_t i = index; i < index + elements.size(); ++i)
 		{
-			change.fire(e);
+			values.push_back(&*list[i]);
 		}
-		list.clear();
+		change.fire(typename Event::AddRange(static_cast<int32_t>(index), std::move(values)));
+		return true;
 	}
 
-	bool removeAll(std::vector<WT> elements) const override
+	bool removeRange(size_t index, size_t count) const override
 	{
-		// TO-DO faster
-		//        std::unordered_set<T> set(elements.begin(), elements.end());
+		if (count == 0)
+		{
+			return false;
+		}
+		auto first = list.begin() + index;
+		std::vector<Wrapper<T>> removed(std::make_move_iterator(first), std::make_move_iterator(first + count));
+		list.erase(first, first + count);
 
-		bool res = false;
-		for (size_t i = list.size(); i > 0; --i)
+		std::vector<T const*> values;
+		values.reserve(count);
+		for (auto const& x : removed)
 		{
-			auto const& x = list[i - 1];
-			if (std::count_if(elements.begin(), elements.end(),
-					[&x](auto const& elem) { return wrapper::TransparentKeyEqual<T>()(elem, x); }) > 0)
-			{
-				removeAt(i - 1);
-				res = true;
-			}
+			values.push_back(&*x);
 		}
-		return res;
+		change.fire(typename Event::RemoveRange(static_cast<int32_t>(index), std::move(values)));
+		return true;
+	}
+
+	bool replaceAll(std::vector<WT> elements) const override
+	{
+		const size_t old_size = list.size();
+		const size_t new_size = elements.size();
+		size_t prefix = 0;
+		while (prefix < old_size && prefix < new_size && *list[prefix] == wrapper::get<T>(elements[prefix]))
+		{
+			++prefix;
+		}
+		size_t suffix = 0;
+		while (suffix < old_size - prefix && suffix < new_size - prefix &&
+			   *list[old_size - 1 - suffix] == wrapper::get<T>(elements[new_size - 1 - suffix]))
+		{
+			++suffix;
+		}
+
+		bool removed = ViewableList::removeRange(prefix, old_size - prefix - suffix);
+		elements.erase(elements.begin() + (new_size - suffix), elements.end());
+		elements.erase(elements.begin(), elements.begin() + prefix);
+		bool added = ViewableList::addRange(prefix, std::move(elements));
+		return removed || added;
 	}
 
 	size_t size() const override
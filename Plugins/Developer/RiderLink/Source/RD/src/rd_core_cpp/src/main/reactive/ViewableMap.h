@@ -5,6 +5,7 @@
 #include "reactive/base/SignalX.h"
 
 #include <util/core_util.h>
+#include <util/inline_ordered_map.h>
 #include <std/unordered_map.h>
 
 #include <thirdparty.hpp>
@@ -16,6 +17,9 @@ namespace rd
 {
 /**
  * \brief complete class which has @code IViewableMap<K, V>'s properties
+ *
+ * When both keys and values are \a util::inline_storable they are kept in place in a \a util::inline_ordered_map,
+ * otherwise each one is held by a \a Wrapper. Its iterators are bidirectional only.
  */
 template <typename K, typename V, typename KA = std::allocator<K>, typename VA = std::allocator<V>>
 class ViewableMap : public IViewableMap<K, V>
@@ -32,9 +36,26 @@ private:
 
 	Signal<Event> change;
 
-	using data_t = ordered_map<Wrapper<K>, Wrapper<V>, wrapper::TransparentHash<K>, wrapper::TransparentKeyEqual<K>, PA>;
+public:
+	static constexpr bool inline_storage = util::inline_storable_v<K> && util::inline_storable_v<V>;
+
+private:
+	using SV = std::conditional_t<inline_storage, V, Wrapper<V>>;
+
+	using data_t = std::conditional_t<inline_storage, util::inline_ordered_map<K, V>,
+		ordered_map<Wrapper<K>, Wrapper<V>, wrapper::TransparentHash<K>, wrapper::TransparentKeyEqual<K>, PA>>;
 	mutable data_t map;
 
+	static OV unwrap(Wrapper<V>&& value)
+	{
+		return wrapper::unwrap<V>(std::move(value));
+	}
+
+	static OV unwrap(V&& value)
+	{
+		return OV(std::move(value));
+	}
+
 public:
 	// region ctor/dtor
 
@@ -163,22 +184,22 @@ public:
 
 		reference operator*() const noexcept
 		{
-			return *it_.value();
+			return wrapper::get<V>(it_.value());
 		}
 
 		pointer operator->() const noexcept
 		{
-			return it_.value().get();
+			return &wrapper::get<V>(it_.value());
 		}
 
 		key_type const& key() const
 		{
-			return *it_.key();
+			return wrapper::get<K>(it_.key());
 		}
 
 		value_type const& value() const
 		{
-			return *it_.value();
+			return wrapper::get<V>(it_.value());
 		}
 	};
 
@@ -248,7 +269,7 @@ public:
 		{
 			auto& key = it.first;
 			auto& value = it.second;
-			handler(Event(typename Event::Add(&(*key), &(*value))));
+			handler(Event(typename Event::Add(&wrapper::get<K>(key), &wrapper::get<V>(value))));
 			;
 		}
 	}
@@ -260,7 +281,7 @@ public:
 		{
 			return nullptr;
 		}
-		return &(*it->second);
+		return &wrapper::get<V>(it->second);
 	}
 
 	const V* set(WK key, WV value) const override
@@ -272,7 +293,7 @@ public:
 			auto& it = node.first;
 			auto const& key_ptr = it->first;
 			auto const& value_ptr = it->second;
-			change.fire(typename Event::Add(&(*key_ptr), &(*value_ptr)));
+			change.fire(typename Event::Add(&wrapper::get<K>(key_ptr), &wrapper::get<V>(value_ptr)));
 			return nullptr;
 		}
 		else
@@ -281,14 +302,15 @@ public:
 			auto const& key_ptr = it->first;
 			auto const& value_ptr = it->second;
 
-			if (*value_ptr != wrapper::get<V>(value))
+			if (wrapper::get<V>(value_ptr) != wrapper::get<V>(value))
 			{	 // TO-DO more effective
-				Wrapper<V> old_value = std::move(map.at(key));
+				SV old_value = std::move(map.at(key));
 
-				map.at(key_ptr) = Wrapper<V>(std::move(value));
-				change.fire(typename Event::Update(&(*key_ptr), &(*old_value), &(*value_ptr)));
+				map.at(key_ptr) = SV(std::move(value));
+				change.fire(typename Event::Update(
+					&wrapper::get<K>(key_ptr), &wrapper::get<V>(old_value), &wrapper::get<V>(value_ptr)));
 			}
-			return &*(value_ptr);
+			return &wrapper::get<V>(value_ptr);
 		}
 	}
 
@@ -296,10 +318,10 @@ public:
 	{
 		if (map.count(key) > 0)
 		{
-			Wrapper<V> old_value = std::move(map.at(key));
-			change.fire(typename Event::Remove(&key, &(*old_value)));
+			SV old_value = std::move(map.at(key));
+			change.fire(typename Event::Remove(&key, &wrapper::get<V>(old_value)));
 			map.erase(key);
-			return wrapper::unwrap<V>(std::move(old_value));
+			return unwrap(std::move(old_value));
 		}
 		return nullopt;
 	}
@@ -310,7 +332,7 @@ public:
 		/*for (auto const &[key, value] : map) {*/
 		for (auto const& it : map)
 		{
-			changes.push_back(typename Event::Remove(&(*it.first), &(*it.second)));
+			changes.push_back(typename Event::Remove(&wrapper::get<K>(it.first), &wrapper::get<V>(it.second)));
 		}
 		for (auto const& it : changes)
 		{
@@ -6,11 +6,15 @@
 
 #include <std/allocator.h>
 #include <util/core_util.h>
+#include <util/inline_ordered_map.h>
 
 namespace rd
 {
 /**
  * \brief complete class which has @code IViewableSet<T>'s properties
+ *
+ * \a util::inline_storable elements are kept in place in a \a util::inline_ordered_set, otherwise each one is held by a
+ * \a Wrapper. Its iterators are bidirectional only.
  * \tparam T
  */
 template <typename T, typename A = allocator<T>>
@@ -26,7 +30,8 @@ private:
 	using WA = typename A::template rebind<Wrapper<T>>::other;
 
 	Signal<Event> change;
-	using data_t = ordered_set<Wrapper<T>, wrapper::TransparentHash<T>, wrapper::TransparentKeyEqual<T>, WA>;
+	using data_t = std::conditional_t<util::inline_storable_v<T>, util::inline_ordered_set<T>,
+		ordered_set<Wrapper<T>, wrapper::TransparentHash<T>, wrapper::TransparentKeyEqual<T>, WA>>;
 	mutable data_t set;
 
 public:
@@ -54,7 +59,7 @@ public:
 		}
 
 	public:
-		using iterator_category = std::random_access_iterator_tag;
+		using iterator_category = typename data_t::iterator::iterator_category;
 		using value_type = T;
 		using difference_type = std::ptrdiff_t;
 		using pointer = T const*;
@@ -155,12 +160,12 @@ public:
 
 		reference operator*() const noexcept
 		{
-			return **it_;
+			return wrapper::get<T>(*it_);
 		}
 
 		pointer operator->() const noexcept
 		{
-			return (*it_).get();
+			return &wrapper::get<T>(*it_);
 		}
 	};
 
@@ -214,7 +219,7 @@ public:
 		std::vector<Event> changes;
 		for (auto const& element : set)
 		{
-			changes.push_back(Event(AddRemove::REMOVE, &(*element)));
+			changes.push_back(Event(AddRemove::REMOVE, &wrapper::get<T>(element)));
 		}
 		for (auto const& e : changes)
 		{
@@ -239,7 +244,7 @@ public:
 	{
 		for (auto const& x : set)
 		{
-			handler(Event(AddRemove::ADD, &(*x)));
+			handler(Event(AddRemove::ADD, &wrapper::get<T>(x)));
 		}
 		change.advise(lifetime, handler);
 	}
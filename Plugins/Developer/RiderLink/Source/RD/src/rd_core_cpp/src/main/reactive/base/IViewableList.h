@@ -58,7 +58,35 @@ public:
 		}
 	};
 
-	variant<Add, Update, Remove> v;
+	/**
+	 * \brief Elements inserted one after another starting at [index].
+	 */
+	class AddRange
+	{
+	public:
+		int32_t index;
+		std::vector<T const*> new_values;
+
+		AddRange(int32_t index, std::vector<T const*> new_values) : index(index), new_values(std::move(new_values))
+		{
+		}
+	};
+
+	/**
+	 * \brief Elements removed from [index] on, in the order they were stored.
+	 */
+	class RemoveRange
+	{
+	public:
+		int32_t index;
+		std::vector<T const*> old_values;
+
+		RemoveRange(int32_t index, std::vector<T const*> old_values) : index(index), old_values(std::move(old_values))
+		{
+		}
+	};
+
+	variant<Add, Update, Remove, AddRange, RemoveRange> v;
 
 	ListEvent(Add x) : v(x)
 	{
@@ -72,20 +100,68 @@ public:
 	{
 	}
 
+	ListEvent(AddRange x) : v(std::move(x))
+	{
+	}
+
+	ListEvent(RemoveRange x) : v(std::move(x))
+	{
+	}
+
+	bool is_range() const
+	{
+		return v.index() >= 3;
+	}
+
 	int32_t get_index() const
 	{
 		return visit(util::make_visitor([](Add const& e) { return e.index; }, [](Update const& e) { return e.index; },
-						 [](Remove const& e) { return e.index; }),
+						 [](Remove const& e) { return e.index; }, [](AddRange const& e) { return e.index; },
+						 [](RemoveRange const& e) { return e.index; }),
 			v);
 	}
 
+	/**
+	 * \brief New value of a single element event, nullptr for removals and range events.
+	 */
 	T const* get_new_value() const
 	{
 		return visit(util::make_visitor([](Add const& e) { return e.new_value; }, [](Update const& e) { return e.new_value; },
-						 [](Remove const& /*e*/) { return static_cast<T const*>(nullptr); }),
+						 [](Remove const& /*e*/) { return static_cast<T const*>(nullptr); },
+						 [](AddRange const& /*e*/) { return static_cast<T const*>(nullptr); },
+						 [](RemoveRange const& /*e*/) { return static_cast<T const*>(nullptr); }),
 			v);
 	}
 
+	/**
+	 * \brief Calls [f] with the single element events equivalent to this one: additions in ascending order, removals from
+	 * the last element down so that every index is valid at the time of its event.
+	 */
+	template <typename F>
+	void for_each_element(F&& f) const
+	{
+		if (v.index() == 3)
+		{
+			auto const& e = get<AddRange>(v);
+			for (size_t i = 0; i < e.new_values.size(); ++i)
+			{
+				f(ListEvent(Add(e.index + static_cast<int32_t>(i), e.new_values[i])));
+			}
+		}
+		else if (v.index() == 4)
+		{
+			auto const& e = get<RemoveRange>(v);
+			for (size_t i = e.old_values.size(); i > 0; --i)
+			{
+				f(ListEvent(Remove(e.index + static_cast<int32_t>(i - 1), e.old_values[i - 1])));
+			}
+		}
+		else
+		{
+			f(*this);
+		}
+	}
+
 	friend std::string to_string(ListEvent const& e)
 	{
 		std::string res = visit(
@@ -96,7 +172,13 @@ public:
 						   //                       to_string(e.old_value) + ":" +
 						   to_string(*e.new_value);
 				},
-				[](typename ListEvent::Remove const& e) { return "Remove " + std::to_string(e.index); }),
+				[](typename ListEvent::Remove const& e) { return "Remove " + std::to_string(e.index); },
+				[](typename ListEvent::AddRange const& e) {
+					return "AddRange " + std::to_string(e.index) + ":" + std::to_string(e.new_values.size());
+				},
+				[](typename ListEvent::RemoveRange const& e) {
+					return "RemoveRange " + std::to_string(e.index) + ":" + std::to_string(e.old_values.size());
+				}),
 			e.v);
 		return res;
 	}
@@ -114,7 +196,8 @@ protected:
 
 public:
 	/**
-	 * \brief Represents an addition, update or removal of an element in the list.
+	 * \brief Represents an addition, update or removal of an element in the list, or of a range of elements.
+	 * Range events are only delivered to \a advise_ranges subscribers.
 	 */
 	using Event = typename detail::ListEvent<T>;
 
@@ -147,7 +230,9 @@ public:
 						  handler(AddRemove::REMOVE, e.index, *e.old_value);
 						  handler(AddRemove::ADD, e.index, *e.new_value);
 					  },
-					  [handler](typename Event::Remove const& e) { handler(AddRemove::REMOVE, e.index, *e.old_value); }),
+					  [handler](typename Event::Remove const& e) { handler(AddRemove::REMOVE, e.index, *e.old_value); },
+					  // advise delivers single element events only
+					  [](typename Event::AddRange const&) {}, [](typename Event::RemoveRange const&) {}),
 				e.v);
 		});
 	}
@@ -190,8 +275,17 @@ public:
 		});
 	}
 
+	/**
+	 * \brief Adds a subscription to single element events. Range changes are delivered element by element.
+	 */
 	void advise(Lifetime lifetime, std::function<void(Event const&)> handler) const override = 0;
 
+	/**
+	 * \brief Adds a subscription which receives range changes as one \a Event::AddRange or \a Event::RemoveRange.
+	 * The current contents are reported as a single \a Event::AddRange.
+	 */
+	virtual void advise_ranges(Lifetime lifetime, std::function<void(Event const&)> handler) const = 0;
+
 	virtual bool add(WT element) const = 0;
 
 	virtual bool add(size_t index, WT element) const = 0;
@@ -212,6 +306,22 @@ public:
 
 	virtual bool removeAll(std::vector<WT> elements) const = 0;
 
+	/**
+	 * \brief Inserts [elements] at [index], firing one \a Event::AddRange.
+	 */
+	virtual bool addRange(size_t index, std::vector<WT> elements) const = 0;
+
+	/**
+	 * \brief Removes [count] elements starting at [index], firing one \a Event::RemoveRange.
+	 */
+	virtual bool removeRange(size_t index, size_t count) const = 0;
+
+	/**
+	 * \brief Makes the list equal to [elements]. Elements of the common prefix and suffix are kept, the rest is replaced
+	 * with at most one \a Event::RemoveRange and one \a Event::AddRange.
+	 */
+	virtual bool replaceAll(std::vector<WT> elements) const = 0;
+
 	virtual size_t size() const = 0;
 
 	virtual bool empty() const = 0;
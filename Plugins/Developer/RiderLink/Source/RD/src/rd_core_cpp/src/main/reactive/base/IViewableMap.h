@@ -79,7 +79,7 @@ public:
 	{
 		return visit(util::make_visitor([](typename MapEvent::Add const& e) { return static_cast<V const*>(nullptr); },
 						 [](typename MapEvent::Update const& e) { return e.old_value; },
-						 [](typename MapEvent::Remove const& e) { e.old_value; }),
+						 [](typename MapEvent::Remove const& e) { return e.old_value; }),
 			v);
 	}
 
@@ -169,7 +169,7 @@ public:
 					RD_ASSERT_MSG(lifetimes.at(lifetime).count(key) > 0,
 						"attempting to remove non-existing lifetime in viewable map by key:" + to_string(key));
 					LifetimeDefinition def = std::move(lifetimes.at(lifetime).at(key));
-					lifetimes.at(lifetime).erase(key);
+					lifetimes.at(lifetime).unordered_erase(key);
 					def.terminate();
 					break;
 				}
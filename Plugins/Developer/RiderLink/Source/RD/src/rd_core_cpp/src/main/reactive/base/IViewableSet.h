@@ -103,7 +103,7 @@ public:
 					RD_ASSERT_MSG(lifetimes.at(lifetime).count(key) > 0,
 						"attempting to remove non-existing lifetime in viewable set by key:" + to_string(key));
 					LifetimeDefinition def = std::move(lifetimes.at(lifetime).at(key));
-					lifetimes.at(lifetime).erase(key);
+					lifetimes.at(lifetime).unordered_erase(key);
 					def.terminate();
 					break;
 				}
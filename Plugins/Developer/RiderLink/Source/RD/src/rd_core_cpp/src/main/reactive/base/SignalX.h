@@ -7,14 +7,23 @@
 #include <lifetime/Lifetime.h>
 #include <util/core_util.h>
 
+#include <algorithm>
 #include <utility>
 #include <functional>
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace rd
 {
 /**
  * \brief complete class which has \a Signal<T> 's properties
+ *
+ * Listeners are kept in a contiguous array which is replaced copy-on-write: [fire] never takes a lock and may run
+ * concurrently with [advise]. Listeners of terminated lifetimes stay as tombstones until the array runs out of capacity,
+ * then the alive ones are compacted into a new array. Replaced arrays are freed by the advise which replaces them if no
+ * fire is in progress, otherwise by the last fire in progress when it finishes.
  */
 template <typename T>
 class Signal final : public ISignal<T>
@@ -37,6 +46,8 @@ private:
 		{
 		}
 
+		Event(Event const&) = default;
+
 		Event(Event&&) = default;
 		// endregion
 
@@ -54,35 +65,124 @@ private:
 		}
 	};
 
-	using counter_t = int32_t;
-	using listeners_t = std::map<counter_t, Event>;
+	/**
+	 * \brief Events are only appended within the reserved capacity, so the elements below [published] never move.
+	 */
+	class Listeners
+	{
+	public:
+		std::vector<Event> events;
+		std::atomic<size_t> published{0};
 
-	mutable counter_t advise_id = 0;
-	mutable listeners_t listeners, priority_listeners;
+		explicit Listeners(size_t capacity)
+		{
+			events.reserve(capacity);
+		}
+	};
 
-	static void cleanup(listeners_t& queue)
+	class FiringGuard
 	{
-		util::erase_if(queue, [](Event const& e) -> bool { return !e.is_alive(); });
-	}
+		Signal const& signal;
 
-	void fire_impl(T const& value, listeners_t& queue) const
+	public:
+		explicit FiringGuard(Signal const& signal) : signal(signal)
+		{
+			++signal.firing;
+		}
+
+		~FiringGuard()
+		{
+			// the last fire to finish frees the arrays replaced meanwhile, unless an advise holding the lock will
+			if (--signal.firing == 0 && signal.retired.load())
+			{
+				std::unique_lock<std::mutex> guard(signal.advise_lock, std::try_to_lock);
+				if (guard.owns_lock())
+				{
+					signal.reclaim();
+				}
+			}
+		}
+	};
+
+	mutable std::mutex advise_lock;
+	mutable std::vector<std::unique_ptr<Listeners>> arrays;	   // current and not yet freed replaced ones
+	mutable std::atomic<Listeners*> listeners{nullptr}, priority_listeners{nullptr};
+	mutable std::atomic<int32_t> firing{0};
+	mutable std::atomic<bool> retired{false};	 // [arrays] holds replaced ones
+
+	static void fire_impl(T const& value, Listeners const* queue)
 	{
-		for (auto const& p : queue)
+		if (queue == nullptr)
+		{
+			return;
+		}
+		// listeners advised during the fire don't receive the value
+		const size_t size = queue->published.load(std::memory_order_acquire);
+		for (size_t i = 0; i < size; ++i)
 		{
-			auto const& event = p.second;
-			event.execute_if_alive(value);
+			queue->events[i].execute_if_alive(value);
 		}
-		cleanup(queue);
 	}
 
 	template <typename F>
-	void advise0(const Lifetime& lifetime, F&& handler, listeners_t& queue) const
+	void advise0(const Lifetime& lifetime, F&& handler, std::atomic<Listeners*>& queue_ref) const
 	{
 		if (lifetime->is_terminated())
 			return;
-		counter_t id = advise_id /*.load()*/;
-		queue.emplace(id, Event(std::forward<F>(handler), lifetime));
-		++advise_id;
+
+		std::lock_guard<std::mutex> guard(advise_lock);
+		Listeners* queue = queue_ref.load();
+		if (queue != nullptr && queue->events.size() < queue->events.capacity())
+		{
+			queue->events.emplace_back(std::forward<F>(handler), lifetime);
+			queue->published.store(queue->events.size(), std::memory_order_release);
+			return;
+		}
+
+		size_t alive = 0;
+		if (queue != nullptr)
+		{
+			for (auto const& event : queue->events)
+			{
+				alive += event.is_alive() ? 1 : 0;
+			}
+		}
+		auto compacted = std::make_unique<Listeners>((std::max)(size_t{4}, 2 * (alive + 1)));
+		if (queue != nullptr)
+		{
+			for (auto const& event : queue->events)
+			{
+				if (event.is_alive())
+				{
+					compacted->events.push_back(event);
+				}
+			}
+		}
+		compacted->events.emplace_back(std::forward<F>(handler), lifetime);
+		compacted->published.store(compacted->events.size());
+		queue_ref.store(compacted.get());
+		arrays.push_back(std::move(compacted));
+		if (queue != nullptr)
+		{
+			retired.store(true);
+		}
+		reclaim();
+	}
+
+	// must be called under [advise_lock]
+	void reclaim() const
+	{
+		// a fire started after the arrays were replaced sees the new ones, so nothing else can reach replaced ones
+		if (firing.load() != 0)
+		{
+			return;
+		}
+		arrays.erase(std::remove_if(arrays.begin(), arrays.end(),
+						 [this](std::unique_ptr<Listeners> const& array) {
+							 return array.get() != listeners.load() && array.get() != priority_listeners.load();
+						 }),
+			arrays.end());
+		retired.store(false);
 	}
 
 public:
@@ -94,9 +194,26 @@ public:
 
 	Signal& operator=(Signal const& other) = delete;
 
-	Signal(Signal&&) = default;
+	Signal(Signal&& other) noexcept
+		: arrays(std::move(other.arrays))
+		, listeners(other.listeners.load())
+		, priority_listeners(other.priority_listeners.load())
+		, retired(other.retired.load())
+	{
+		other.listeners = nullptr;
+		other.priority_listeners = nullptr;
+	}
 
-	Signal& operator=(Signal&&) = default;
+	Signal& operator=(Signal&& other) noexcept
+	{
+		arrays = std::move(other.arrays);
+		listeners = other.listeners.load();
+		priority_listeners = other.priority_listeners.load();
+		retired = other.retired.load();
+		other.listeners = nullptr;
+		other.priority_listeners = nullptr;
+		return *this;
+	}
 
 	virtual ~Signal() = default;
 
@@ -106,8 +223,13 @@ public:
 
 	void fire(T const& value) const override
 	{
-		fire_impl(value, priority_listeners);
-		fire_impl(value, listeners);
+		if (listeners.load(std::memory_order_relaxed) == nullptr && priority_listeners.load(std::memory_order_relaxed) == nullptr)
+		{
+			return;
+		}
+		FiringGuard guard(*this);
+		fire_impl(value, priority_listeners.load());
+		fire_impl(value, listeners.load());
 	}
 
 	using ISignal<T>::advise;
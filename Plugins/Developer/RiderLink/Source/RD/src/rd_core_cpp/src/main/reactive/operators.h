@@ -0,0 +1,370 @@
+#ifndef RD_CPP_CORE_OPERATORS_H
+#define RD_CPP_CORE_OPERATORS_H
+
+#include "base/SignalX.h"
+#include "Timer.h"
+
+#include <lifetime/Lifetime.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rd
+{
+namespace reactive
+{
+/**
+ * \brief Source produced by an operator. It is fed by a subscription to the upstream source, which keeps it alive until
+ * the operator's lifetime is terminated.
+ */
+template <typename T>
+class DerivedSource final : public ISource<T>
+{
+	Signal<T> signal;
+
+public:
+	using ISource<T>::advise;
+
+	void advise(Lifetime lifetime, std::function<void(T const&)> handler) const override
+	{
+		signal.advise(lifetime, std::move(handler));
+	}
+
+	void fire(T const& value) const
+	{
+		signal.fire(value);
+	}
+};
+
+template <typename T>
+using DerivedSourcePtr = std::shared_ptr<DerivedSource<T>>;
+
+namespace detail
+{
+template <typename T>
+void assign(optional<T>& slot, T const& value)
+{
+	// reuse whatever the stored value has already allocated
+	if (slot)
+	{
+		*slot = value;
+	}
+	else
+	{
+		slot = value;
+	}
+}
+
+/**
+ * \brief State of an operator driven by a [Timer]. The timer thread only queues [Self::tick] on the scheduler, so
+ * values are emitted on the scheduler's thread. Terminating the lifetime disarms the timer and drops queued ticks.
+ */
+template <typename Self, typename Scheduler>
+class timed_operator : public Timer::Task, public std::enable_shared_from_this<Self>
+{
+protected:
+	Scheduler& scheduler;
+	Timer& timer;
+	Timer::clock::duration period;
+
+	std::mutex lock;
+	bool terminated = false;
+
+	void schedule_after_period()
+	{
+		timer.schedule(this, Timer::clock::now() + period);
+	}
+
+public:
+	timed_operator(Scheduler& scheduler, Timer& timer, Timer::clock::duration period)
+		: scheduler(scheduler), timer(timer), period(period)
+	{
+	}
+
+	void on_timer() override
+	{
+		scheduler.queue([self = this->shared_from_this()] { self->tick(); });
+	}
+
+	void bind(Lifetime const& lifetime)
+	{
+		lifetime->add_action([self = this->shared_from_this()] { self->terminate(); });
+	}
+
+	void terminate()
+	{
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			terminated = true;
+		}
+		timer.cancel(this);
+	}
+};
+
+template <typename T, typename Scheduler>
+class debounce_operator final : public timed_operator<debounce_operator<T, Scheduler>, Scheduler>
+{
+	using base = timed_operator<debounce_operator<T, Scheduler>, Scheduler>;
+
+	DerivedSourcePtr<T> out;
+	optional<T> latest;
+	optional<T> emitting;
+	Timer::clock::time_point deadline;
+	bool scheduled = false;
+
+public:
+	debounce_operator(DerivedSourcePtr<T> out, Scheduler& scheduler, Timer& timer, Timer::clock::duration period)
+		: base(scheduler, timer, period), out(std::move(out))
+	{
+	}
+
+	void on_next(T const& value)
+	{
+		std::lock_guard<decltype(this->lock)> guard(this->lock);
+		assign(latest, value);
+		deadline = Timer::clock::now() + this->period;
+		if (!scheduled)
+		{
+			scheduled = true;
+			this->timer.schedule(this, deadline);
+		}
+	}
+
+	void tick()
+	{
+		{
+			std::lock_guard<decltype(this->lock)> guard(this->lock);
+			if (this->terminated || !scheduled)
+			{
+				return;
+			}
+			if (Timer::clock::now() < deadline)
+			{
+				this->timer.schedule(this, deadline);
+				return;
+			}
+			scheduled = false;
+			std::swap(latest, emitting);
+		}
+		out->fire(*emitting);
+	}
+};
+
+template <typename T, typename Scheduler>
+class throttle_operator final : public timed_operator<throttle_operator<T, Scheduler>, Scheduler>
+{
+	using base = timed_operator<throttle_operator<T, Scheduler>, Scheduler>;
+
+	DerivedSourcePtr<T> out;
+	optional<T> latest;
+	optional<T> emitting;
+	bool window_open = false;
+	bool has_latest = false;
+
+public:
+	throttle_operator(DerivedSourcePtr<T> out, Scheduler& scheduler, Timer& timer, Timer::clock::duration period)
+		: base(scheduler, timer, period), out(std::move(out))
+	{
+	}
+
+	void on_next(T const& value)
+	{
+		{
+			std::lock_guard<decltype(this->lock)> guard(this->lock);
+			assign(latest, value);
+			has_latest = true;
+			if (window_open)
+			{
+				return;
+			}
+			window_open = true;
+		}
+		// the first value of a window goes through the scheduler as well, with no delay
+		this->on_timer();
+	}
+
+	void tick()
+	{
+		{
+			std::lock_guard<decltype(this->lock)> guard(this->lock);
+			if (this->terminated)
+			{
+				return;
+			}
+			if (!has_latest)
+			{
+				window_open = false;
+				return;
+			}
+			has_latest = false;
+			std::swap(latest, emitting);
+			this->schedule_after_period();
+		}
+		out->fire(*emitting);
+	}
+};
+
+template <typename T, typename Scheduler>
+class buffer_operator final : public timed_operator<buffer_operator<T, Scheduler>, Scheduler>
+{
+	using base = timed_operator<buffer_operator<T, Scheduler>, Scheduler>;
+
+	DerivedSourcePtr<std::vector<T>> out;
+	std::vector<T> pending;
+	std::vector<T> emitting;
+	bool scheduled = false;
+
+public:
+	buffer_operator(DerivedSourcePtr<std::vector<T>> out, Scheduler& scheduler, Timer& timer, Timer::clock::duration period)
+		: base(scheduler, timer, period), out(std::move(out))
+	{
+	}
+
+	void on_next(T const& value)
+	{
+		std::lock_guard<decltype(this->lock)> guard(this->lock);
+		pending.push_back(value);
+		if (!scheduled)
+		{
+			scheduled = true;
+			this->schedule_after_period();
+		}
+	}
+
+	void tick()
+	{
+		{
+			std::lock_guard<decltype(this->lock)> guard(this->lock);
+			if (this->terminated)
+			{
+				return;
+			}
+			scheduled = false;
+			pending.swap(emitting);
+		}
+		out->fire(emitting);
+		// keeps the capacity for the next swap
+		emitting.clear();
+	}
+};
+
+template <template <typename, typename> class Operator, typename R, typename T, typename Scheduler, typename Rep,
+	typename Period>
+DerivedSourcePtr<R> make_timed(Lifetime lifetime, ISource<T> const& source, Scheduler& scheduler,
+	std::chrono::duration<Rep, Period> period, Timer& timer)
+{
+	auto out = std::make_shared<DerivedSource<R>>();
+	auto state = std::make_shared<Operator<T, Scheduler>>(
+		out, scheduler, timer, std::chrono::duration_cast<Timer::clock::duration>(period));
+	state->bind(lifetime);
+	source.advise(lifetime, [state](T const& value) { state->on_next(value); });
+	return out;
+}
+}	 // namespace detail
+
+/**
+ * \brief Emits [f] applied to every value of [source].
+ */
+template <typename T, typename F>
+auto map(Lifetime lifetime, ISource<T> const& source, F&& f)
+{
+	using R = std::decay_t<decltype(f(std::declval<T const&>()))>;
+	auto out = std::make_shared<DerivedSource<R>>();
+	source.advise(lifetime, [out, f = std::forward<F>(f)](T const& value) mutable { out->fire(f(value)); });
+	return out;
+}
+
+/**
+ * \brief Emits the values of [source] which satisfy [predicate].
+ */
+template <typename T, typename F>
+DerivedSourcePtr<T> filter(Lifetime lifetime, ISource<T> const& source, F&& predicate)
+{
+	auto out = std::make_shared<DerivedSource<T>>();
+	source.advise(lifetime, [out, predicate = std::forward<F>(predicate)](T const& value) mutable {
+		if (predicate(value))
+		{
+			out->fire(value);
+		}
+	});
+	return out;
+}
+
+/**
+ * \brief Emits the values of [source] which differ from the previous one.
+ */
+template <typename T>
+DerivedSourcePtr<T> distinct_until_changed(Lifetime lifetime, ISource<T> const& source)
+{
+	auto out = std::make_shared<DerivedSource<T>>();
+	source.advise(lifetime, [out, last = optional<T>()](T const& value) mutable {
+		if (!last || !(*last == value))
+		{
+			detail::assign(last, value);
+			out->fire(value);
+		}
+	});
+	return out;
+}
+
+/**
+ * \brief Emits the values of [source] in groups of [count]. A trailing incomplete group is not emitted.
+ */
+template <typename T>
+DerivedSourcePtr<std::vector<T>> buffer(Lifetime lifetime, ISource<T> const& source, size_t count)
+{
+	auto out = std::make_shared<DerivedSource<std::vector<T>>>();
+	std::vector<T> pending;
+	pending.reserve(count);
+	source.advise(lifetime, [out, count, pending = std::move(pending)](T const& value) mutable {
+		pending.push_back(value);
+		if (pending.size() >= count)
+		{
+			out->fire(pending);
+			pending.clear();
+		}
+	});
+	return out;
+}
+
+/**
+ * \brief Emits the values of [source] collected during [period] after the first value of each group, on [scheduler].
+ * \param scheduler any IScheduler.
+ */
+template <typename T, typename Scheduler, typename Rep, typename Period>
+DerivedSourcePtr<std::vector<T>> buffer(Lifetime lifetime, ISource<T> const& source, Scheduler& scheduler,
+	std::chrono::duration<Rep, Period> period, Timer& timer = Timer::shared())
+{
+	return detail::make_timed<detail::buffer_operator, std::vector<T>>(lifetime, source, scheduler, period, timer);
+}
+
+/**
+ * \brief Emits the last value of [source] once no new value has arrived for [period], on [scheduler].
+ * \param scheduler any IScheduler.
+ */
+template <typename T, typename Scheduler, typename Rep, typename Period>
+DerivedSourcePtr<T> debounce(Lifetime lifetime, ISource<T> const& source, Scheduler& scheduler,
+	std::chrono::duration<Rep, Period> period, Timer& timer = Timer::shared())
+{
+	return detail::make_timed<detail::debounce_operator, T>(lifetime, source, scheduler, period, timer);
+}
+
+/**
+ * \brief Emits a value of [source] without delay, then at most the latest one per [period] while values keep arriving,
+ * all of them on [scheduler].
+ * \param scheduler any IScheduler.
+ */
+template <typename T, typename Scheduler, typename Rep, typename Period>
+DerivedSourcePtr<T> throttle(Lifetime lifetime, ISource<T> const& source, Scheduler& scheduler,
+	std::chrono::duration<Rep, Period> period, Timer& timer = Timer::shared())
+{
+	return detail::make_timed<detail::throttle_operator, T>(lifetime, source, scheduler, period, timer);
+}
+}	 // namespace reactive
+}	 // namespace rd
+
+#endif	  // RD_CPP_CORE_OPERATORS_H
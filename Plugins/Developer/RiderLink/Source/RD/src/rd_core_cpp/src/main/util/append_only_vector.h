@@ -0,0 +1,226 @@
+#ifndef RD_CPP_APPEND_ONLY_VECTOR_H
+#define RD_CPP_APPEND_ONLY_VECTOR_H
+
+#include "core_util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Vector which is appended to at the end and freed from the start, readable without locks while another thread
+ * appends.
+ *
+ * Elements live in segments of 2^SegmentShift which are never moved, so a reference to an element stays valid until its
+ * segment is freed by [free_below] or [clear]. The segments are found through a ring of pointers which doubles when the
+ * live ones don't fit, so memory follows the number of live elements rather than the highest index. Writers must be
+ * serialized by the caller. A reader may access any index below [size] which isn't freed.
+ */
+template <typename T, size_t SegmentShift = 6>
+class append_only_vector
+{
+	static constexpr size_t segment_size = size_t(1) << SegmentShift;
+
+	struct Segment
+	{
+		size_t number = 0;
+		T items[segment_size];
+	};
+
+	// replaced rings are kept until [clear], a reader may still be looking into one
+	struct Ring
+	{
+		size_t mask;
+		std::unique_ptr<std::atomic<Segment*>[]> slots;
+		std::unique_ptr<Ring> previous;
+
+		explicit Ring(size_t size) : mask(size - 1), slots(new std::atomic<Segment*>[size])
+		{
+			for (size_t i = 0; i < size; ++i)
+			{
+				slots[i].store(nullptr, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	std::unique_ptr<Ring> ring;
+	std::atomic<Ring*> current{nullptr};
+	std::atomic<size_t> count{0};
+	// first segment which isn't freed, only used by writers
+	size_t first_live = 0;
+
+	Segment* segment_of(size_t number) const
+	{
+		Ring const* r = current.load(std::memory_order_acquire);
+		if (r == nullptr)
+		{
+			return nullptr;
+		}
+		Segment* segment = r->slots[number & r->mask].load(std::memory_order_acquire);
+		return segment != nullptr && segment->number == number ? segment : nullptr;
+	}
+
+	void grow(size_t live)
+	{
+		size_t size = ring ? (ring->mask + 1) * 2 : 1;
+		while (size < live)
+		{
+			size *= 2;
+		}
+		auto next = std::make_unique<Ring>(size);
+		if (ring)
+		{
+			for (size_t i = 0; i <= ring->mask; ++i)
+			{
+				if (Segment* segment = ring->slots[i].load(std::memory_order_relaxed))
+				{
+					next->slots[segment->number & next->mask].store(segment, std::memory_order_relaxed);
+				}
+			}
+		}
+		next->previous = std::move(ring);
+		ring = std::move(next);
+		current.store(ring.get(), std::memory_order_release);
+	}
+
+	void free_segment(size_t number)
+	{
+		Segment* segment = segment_of(number);
+		if (segment == nullptr)
+		{
+			return;
+		}
+		for (Ring* r = ring.get(); r != nullptr; r = r->previous.get())
+		{
+			auto& slot = r->slots[number & r->mask];
+			if (slot.load(std::memory_order_relaxed) == segment)
+			{
+				slot.store(nullptr, std::memory_order_release);
+			}
+		}
+		delete segment;
+	}
+
+public:
+	// region ctor/dtor
+
+	append_only_vector() = default;
+
+	append_only_vector(append_only_vector const&) = delete;
+
+	append_only_vector& operator=(append_only_vector const&) = delete;
+
+	~append_only_vector()
+	{
+		clear();
+	}
+	// endregion
+
+	size_t size() const
+	{
+		return count.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * \return the element at [index], or nullptr if it is out of range or freed.
+	 */
+	T const* find(size_t index) const
+	{
+		if (index >= size())
+		{
+			return nullptr;
+		}
+		Segment const* segment = segment_of(index >> SegmentShift);
+		return segment != nullptr ? &segment->items[index & (segment_size - 1)] : nullptr;
+	}
+
+	T const& operator[](size_t index) const
+	{
+		T const* item = find(index);
+		RD_ASSERT_MSG(item != nullptr, "append_only_vector index out of range or freed: " + std::to_string(index));
+		return *item;
+	}
+
+	/**
+	 * \brief Stores [value] at [index], growing the vector to it if needed. Skipped indexes hold default values.
+	 * \return false if [index] is already freed, then nothing is stored.
+	 */
+	bool set(size_t index, T value)
+	{
+		const size_t number = index >> SegmentShift;
+		if (number < first_live)
+		{
+			return false;
+		}
+		if (!ring || number - first_live > ring->mask)
+		{
+			grow(number - first_live + 1);
+		}
+		auto& slot = ring->slots[number & ring->mask];
+		Segment* segment = slot.load(std::memory_order_relaxed);
+		if (segment == nullptr)
+		{
+			segment = new Segment();
+			segment->number = number;
+			slot.store(segment, std::memory_order_release);
+		}
+		segment->items[index & (segment_size - 1)] = std::move(value);
+		if (index >= count.load(std::memory_order_relaxed))
+		{
+			count.store(index + 1, std::memory_order_release);
+		}
+		return true;
+	}
+
+	/**
+	 * \return index of the appended [value].
+	 */
+	size_t push_back(T value)
+	{
+		const size_t index = count.load(std::memory_order_relaxed);
+		set(index, std::move(value));
+		return index;
+	}
+
+	/**
+	 * \brief Frees the segments which only hold indexes below [index]. Readers must not access them any more, the
+	 * indexes keep their numbers and [size] doesn't change.
+	 */
+	void free_below(size_t index)
+	{
+		const size_t end = (std::min)(index, size()) >> SegmentShift;
+		for (; first_live < end; ++first_live)
+		{
+			free_segment(first_live);
+		}
+	}
+
+	/**
+	 * \brief Frees all elements. Must not run concurrently with readers.
+	 */
+	void clear()
+	{
+		if (ring)
+		{
+			for (size_t i = 0; i <= ring->mask; ++i)
+			{
+				delete ring->slots[i].exchange(nullptr, std::memory_order_relaxed);
+			}
+		}
+		current.store(nullptr, std::memory_order_relaxed);
+		ring.reset();
+		first_live = 0;
+		count.store(0, std::memory_order_release);
+	}
+};
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_APPEND_ONLY_VECTOR_H
@@ -3,6 +3,7 @@
 
 #include <types/Void.h>
 
+#include <functional>
 #include <type_traits>
 #include <string>
 
@@ -96,6 +97,36 @@ static_assert(!in_heap_v<int>, "int shouldn't be placed in shared memory");
 
 // endregion
 
+// region is_hashable
+
+/**
+ * \brief Whether \a rd::hash<T> can be used: std::hash is enabled for T or T is a generated polymorphic type, which gets a
+ * \a rd::hash specialization calling hashCode.
+ */
+template <typename T>
+using is_hashable = disjunction<std::is_default_constructible<std::hash<T>>, std::is_base_of<IPolymorphicSerializable, T>>;
+
+template <typename T>
+/*inline */ constexpr bool is_hashable_v = is_hashable<T>::value;
+
+// endregion
+
+// region inline_storable
+
+/**
+ * \brief Small trivially copyable types which viewable collections store in place rather than behind a \a Wrapper.
+ */
+template <typename T>
+using inline_storable = conjunction<std::is_trivially_copyable<T>, negation<in_heap<T>>, std::integral_constant<bool, sizeof(T) <= 32>>;
+
+template <typename T>
+/*inline */ constexpr bool inline_storable_v = inline_storable<T>::value;
+
+static_assert(inline_storable_v<int>, "int should be stored in place");
+static_assert(!inline_storable_v<std::wstring>, "std::wstring shouldn't be stored in place");
+
+// endregion
+
 // region literal
 
 template <typename T>
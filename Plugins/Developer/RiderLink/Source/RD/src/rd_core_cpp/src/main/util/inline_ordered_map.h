@@ -0,0 +1,431 @@
+#ifndef RD_CPP_INLINE_ORDERED_MAP_H
+#define RD_CPP_INLINE_ORDERED_MAP_H
+
+#include <std/hash.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rd
+{
+namespace util
+{
+namespace detail
+{
+template <typename K, typename V>
+struct inline_map_entry
+{
+	K first;
+	V second;
+};
+
+template <typename K, typename V>
+struct inline_map_key_of
+{
+	static K const& key(inline_map_entry<K, V> const& entry)
+	{
+		return entry.first;
+	}
+};
+
+template <typename T>
+struct inline_set_key_of
+{
+	static T const& key(T const& entry)
+	{
+		return entry;
+	}
+};
+
+/**
+ * \brief Hash table of trivially copyable entries stored in place, iterated in insertion order.
+ *
+ * Entries live in fixed-size chunks and never move, so pointers to them stay valid until the entry is erased. Erased
+ * entries are recycled. The index is an open-addressing table of 32-bit entry numbers with linear probing and
+ * backward-shift deletion, so there are no tombstones. Insertion order is kept in a doubly-linked list through the entries.
+ */
+template <typename K, typename Entry, typename KeyOf, typename Hash, typename KeyEqual>
+class inline_ordered_table
+{
+	static_assert(std::is_trivially_copyable<Entry>::value, "entries must be trivially copyable");
+
+	static constexpr uint32_t npos = UINT32_MAX;
+	static constexpr uint32_t chunk_shift = 6;
+	static constexpr uint32_t chunk_size = 1u << chunk_shift;
+
+	struct node
+	{
+		Entry entry;
+		uint32_t prev;
+		uint32_t next;
+	};
+
+	using chunk_t = typename std::aligned_storage<sizeof(node) * chunk_size, alignof(node)>::type;
+
+	std::vector<std::unique_ptr<chunk_t>> chunks;
+	std::vector<uint32_t> slots;	// 0 is empty, otherwise node number + 1
+	uint32_t slot_shift = 64;
+	uint32_t head = npos, tail = npos, free_head = npos;
+	uint32_t allocated = 0;
+	size_t count = 0;
+
+	Hash hasher;
+	KeyEqual key_equal;
+
+	node& at_node(uint32_t n) const
+	{
+		return reinterpret_cast<node*>(chunks[n >> chunk_shift].get())[n & (chunk_size - 1)];
+	}
+
+	size_t ideal_slot(K const& key) const
+	{
+		// fibonacci hashing spreads identity hashes of small integers over the whole table
+		return static_cast<size_t>((static_cast<uint64_t>(hasher(key)) * 0x9E3779B97F4A7C15ull) >> slot_shift);
+	}
+
+	size_t find_slot(K const& key) const
+	{
+		if (count == 0)
+		{
+			return npos;
+		}
+		const size_t mask = slots.size() - 1;
+		for (size_t i = ideal_slot(key);; i = (i + 1) & mask)
+		{
+			const uint32_t s = slots[i];
+			if (s == 0)
+			{
+				return npos;
+			}
+			if (key_equal(KeyOf::key(at_node(s - 1).entry), key))
+			{
+				return i;
+			}
+		}
+	}
+
+	void place(uint32_t n)
+	{
+		const size_t mask = slots.size() - 1;
+		size_t i = ideal_slot(KeyOf::key(at_node(n).entry));
+		while (slots[i] != 0)
+		{
+			i = (i + 1) & mask;
+		}
+		slots[i] = n + 1;
+	}
+
+	void rehash(size_t slot_count)
+	{
+		slots.assign(slot_count, 0);
+		slot_shift = 64;
+		for (size_t c = slot_count; c > 1; c >>= 1)
+		{
+			--slot_shift;
+		}
+		for (uint32_t n = head; n != npos; n = at_node(n).next)
+		{
+			place(n);
+		}
+	}
+
+	uint32_t allocate_node()
+	{
+		if (free_head != npos)
+		{
+			const uint32_t n = free_head;
+			free_head = at_node(n).next;
+			return n;
+		}
+		if ((allocated & (chunk_size - 1)) == 0)
+		{
+			chunks.emplace_back(new chunk_t);
+		}
+		return allocated++;
+	}
+
+	void erase_slot(size_t i)
+	{
+		const uint32_t n = slots[i] - 1;
+		const size_t mask = slots.size() - 1;
+		for (size_t j = (i + 1) & mask; slots[j] != 0; j = (j + 1) & mask)
+		{
+			const size_t k = ideal_slot(KeyOf::key(at_node(slots[j] - 1).entry));
+			// move the entry back unless its ideal slot lies cyclically in (i, j]
+			const bool stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+			if (!stays)
+			{
+				slots[i] = slots[j];
+				i = j;
+			}
+		}
+		slots[i] = 0;
+
+		node& x = at_node(n);
+		(x.prev == npos ? head : at_node(x.prev).next) = x.next;
+		(x.next == npos ? tail : at_node(x.next).prev) = x.prev;
+		x.next = free_head;
+		free_head = n;
+		--count;
+	}
+
+	template <bool Const>
+	class basic_iterator
+	{
+		friend class inline_ordered_table;
+
+		template <bool>
+		friend class basic_iterator;
+
+		using table_t = typename std::conditional<Const, inline_ordered_table const, inline_ordered_table>::type;
+
+		table_t* table = nullptr;
+		uint32_t n = npos;
+
+		basic_iterator(table_t* table, uint32_t n) : table(table), n(n)
+		{
+		}
+
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = Entry;
+		using difference_type = std::ptrdiff_t;
+		using reference = typename std::conditional<Const, Entry const&, Entry&>::type;
+		using pointer = typename std::conditional<Const, Entry const*, Entry*>::type;
+
+		basic_iterator() = default;
+
+		template <bool C = Const, typename = typename std::enable_if<!C>::type>
+		operator basic_iterator<true>() const
+		{
+			return basic_iterator<true>(table, n);
+		}
+
+		reference operator*() const
+		{
+			return table->at_node(n).entry;
+		}
+
+		pointer operator->() const
+		{
+			return &table->at_node(n).entry;
+		}
+
+		K const& key() const
+		{
+			return KeyOf::key(**this);
+		}
+
+		auto& value() const
+		{
+			return (**this).second;
+		}
+
+		basic_iterator& operator++()
+		{
+			n = table->at_node(n).next;
+			return *this;
+		}
+
+		basic_iterator operator++(int)
+		{
+			auto it = *this;
+			++*this;
+			return it;
+		}
+
+		basic_iterator& operator--()
+		{
+			n = (n == npos) ? table->tail : table->at_node(n).prev;
+			return *this;
+		}
+
+		basic_iterator operator--(int)
+		{
+			auto it = *this;
+			--*this;
+			return it;
+		}
+
+		bool operator==(basic_iterator const& other) const noexcept
+		{
+			return n == other.n;
+		}
+
+		bool operator!=(basic_iterator const& other) const noexcept
+		{
+			return n != other.n;
+		}
+	};
+
+public:
+	using key_type = K;
+	using value_type = Entry;
+	using iterator = basic_iterator<std::is_same<K, Entry>::value>;
+	using const_iterator = basic_iterator<true>;
+
+	// region ctor/dtor
+
+	inline_ordered_table() = default;
+
+	inline_ordered_table(inline_ordered_table&&) noexcept = default;
+
+	inline_ordered_table& operator=(inline_ordered_table&&) noexcept = default;
+
+	// endregion
+
+	iterator begin()
+	{
+		return iterator(this, head);
+	}
+
+	iterator end()
+	{
+		return iterator(this, npos);
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(this, head);
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(this, npos);
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	iterator find(K const& key)
+	{
+		const size_t i = find_slot(key);
+		return iterator(this, i == npos ? npos : slots[i] - 1);
+	}
+
+	const_iterator find(K const& key) const
+	{
+		const size_t i = find_slot(key);
+		return const_iterator(this, i == npos ? npos : slots[i] - 1);
+	}
+
+	size_t count_of(K const& key) const
+	{
+		return find_slot(key) == npos ? 0 : 1;
+	}
+
+	template <typename... Args>
+	std::pair<iterator, bool> emplace(Args&&... args)
+	{
+		Entry entry{std::forward<Args>(args)...};
+		const size_t existing = find_slot(KeyOf::key(entry));
+		if (existing != npos)
+		{
+			return {iterator(this, slots[existing] - 1), false};
+		}
+
+		// keep the load factor at most 3/4
+		if (4 * (count + 1) > 3 * slots.size())
+		{
+			rehash(slots.empty() ? 8 : 2 * slots.size());
+		}
+
+		const uint32_t n = allocate_node();
+		new (&at_node(n)) node{entry, tail, npos};
+		(tail == npos ? head : at_node(tail).next) = n;
+		tail = n;
+		++count;
+		place(n);
+		return {iterator(this, n), true};
+	}
+
+	size_t erase(K const& key)
+	{
+		const size_t i = find_slot(key);
+		if (i == npos)
+		{
+			return 0;
+		}
+		erase_slot(i);
+		return 1;
+	}
+
+	void erase(const_iterator it)
+	{
+		erase(it.key());
+	}
+
+	void clear()
+	{
+		chunks.clear();
+		slots.clear();
+		slot_shift = 64;
+		head = tail = free_head = npos;
+		allocated = 0;
+		count = 0;
+	}
+};
+}	 // namespace detail
+
+/**
+ * \brief Insertion-ordered map of small trivially copyable keys and values, stored in place.
+ */
+template <typename K, typename V, typename Hash = rd::hash<K>, typename KeyEqual = std::equal_to<K>>
+class inline_ordered_map
+	: public detail::inline_ordered_table<K, detail::inline_map_entry<K, V>, detail::inline_map_key_of<K, V>, Hash, KeyEqual>
+{
+	using base_t =
+		detail::inline_ordered_table<K, detail::inline_map_entry<K, V>, detail::inline_map_key_of<K, V>, Hash, KeyEqual>;
+
+public:
+	using mapped_type = V;
+
+	size_t count(K const& key) const
+	{
+		return base_t::count_of(key);
+	}
+
+	V& at(K const& key)
+	{
+		auto it = base_t::find(key);
+		if (it == base_t::end())
+		{
+			throw std::out_of_range("inline_ordered_map::at");
+		}
+		return it->second;
+	}
+};
+
+/**
+ * \brief Insertion-ordered set of small trivially copyable elements, stored in place.
+ */
+template <typename T, typename Hash = rd::hash<T>, typename KeyEqual = std::equal_to<T>>
+class inline_ordered_set : public detail::inline_ordered_table<T, T, detail::inline_set_key_of<T>, Hash, KeyEqual>
+{
+	using base_t = detail::inline_ordered_table<T, T, detail::inline_set_key_of<T>, Hash, KeyEqual>;
+
+public:
+	size_t count(T const& element) const
+	{
+		return base_t::count_of(element);
+	}
+};
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_INLINE_ORDERED_MAP_H
@@ -0,0 +1,57 @@
+#ifndef RD_CPP_LOGGING_H
+#define RD_CPP_LOGGING_H
+
+#include "spdlog/spdlog.h"
+
+/**
+ * \brief Lowest level compiled in, one of SPDLOG_LEVEL_*. RD_LOG_* calls below it are removed with their arguments.
+ */
+#ifndef RD_ACTIVE_LOG_LEVEL
+#define RD_ACTIVE_LOG_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
+/**
+ * \brief Logs with [logger] (a pointer to spdlog::logger) at [level]. The message and its arguments are only evaluated
+ * if the logger is enabled for the level.
+ */
+#define RD_LOG_CALL(logger, level, ...)            \
+	do                                             \
+	{                                              \
+		auto const& rd_logger_ = (logger);         \
+		if (rd_logger_->should_log(level))         \
+		{                                          \
+			rd_logger_->log(level, __VA_ARGS__);   \
+		}                                          \
+	} while (false)
+
+#if RD_ACTIVE_LOG_LEVEL <= SPDLOG_LEVEL_TRACE
+#define RD_LOG_TRACE(logger, ...) RD_LOG_CALL(logger, spdlog::level::trace, __VA_ARGS__)
+#else
+#define RD_LOG_TRACE(logger, ...) (void) 0
+#endif
+
+#if RD_ACTIVE_LOG_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define RD_LOG_DEBUG(logger, ...) RD_LOG_CALL(logger, spdlog::level::debug, __VA_ARGS__)
+#else
+#define RD_LOG_DEBUG(logger, ...) (void) 0
+#endif
+
+#if RD_ACTIVE_LOG_LEVEL <= SPDLOG_LEVEL_INFO
+#define RD_LOG_INFO(logger, ...) RD_LOG_CALL(logger, spdlog::level::info, __VA_ARGS__)
+#else
+#define RD_LOG_INFO(logger, ...) (void) 0
+#endif
+
+#if RD_ACTIVE_LOG_LEVEL <= SPDLOG_LEVEL_WARN
+#define RD_LOG_WARN(logger, ...) RD_LOG_CALL(logger, spdlog::level::warn, __VA_ARGS__)
+#else
+#define RD_LOG_WARN(logger, ...) (void) 0
+#endif
+
+#if RD_ACTIVE_LOG_LEVEL <= SPDLOG_LEVEL_ERROR
+#define RD_LOG_ERROR(logger, ...) RD_LOG_CALL(logger, spdlog::level::err, __VA_ARGS__)
+#else
+#define RD_LOG_ERROR(logger, ...) (void) 0
+#endif
+
+#endif	  // RD_CPP_LOGGING_H
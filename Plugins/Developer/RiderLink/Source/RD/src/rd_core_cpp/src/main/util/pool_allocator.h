@@ -0,0 +1,116 @@
+#ifndef RD_CPP_POOL_ALLOCATOR_H
+#define RD_CPP_POOL_ALLOCATOR_H
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Process-wide free list of blocks of one size. Freed blocks are kept for reuse and never returned to the system.
+ *
+ * Blocks come from ::operator new, so a block may be freed into another module's pool of the same size.
+ */
+template <size_t Size, size_t Align>
+class fixed_block_pool
+{
+	union Block
+	{
+		Block* next;
+		alignas(Align) unsigned char data[Size];
+	};
+
+	std::mutex lock;
+	Block* free_list = nullptr;
+
+public:
+	static fixed_block_pool& instance()
+	{
+		// never destroyed: blocks may be freed during static destruction
+		static fixed_block_pool* pool = new fixed_block_pool();
+		return *pool;
+	}
+
+	void* allocate()
+	{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if (free_list != nullptr)
+			{
+				Block* block = free_list;
+				free_list = block->next;
+				return block;
+			}
+		}
+		return ::operator new(sizeof(Block));
+	}
+
+	void deallocate(void* p) noexcept
+	{
+		Block* block = static_cast<Block*>(p);
+		std::lock_guard<std::mutex> guard(lock);
+		block->next = free_list;
+		free_list = block;
+	}
+};
+
+/**
+ * \brief Allocator taking single objects from a \a fixed_block_pool. Arrays are allocated with ::operator new.
+ */
+template <typename T>
+class pool_allocator
+{
+	static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+
+	using pool_t = fixed_block_pool<sizeof(T), alignof(T)>;
+
+public:
+	using value_type = T;
+
+	pool_allocator() noexcept = default;
+
+	template <typename U>
+	pool_allocator(pool_allocator<U> const&) noexcept
+	{
+	}
+
+	T* allocate(size_t n)
+	{
+		if (n == 1)
+		{
+			return static_cast<T*>(pool_t::instance().allocate());
+		}
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, size_t n) noexcept
+	{
+		if (n == 1)
+		{
+			pool_t::instance().deallocate(p);
+		}
+		else
+		{
+			::operator delete(p);
+		}
+	}
+
+	template <typename U>
+	bool operator==(pool_allocator<U> const&) const noexcept
+	{
+		return true;
+	}
+
+	template <typename U>
+	bool operator!=(pool_allocator<U> const&) const noexcept
+	{
+		return false;
+	}
+};
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_POOL_ALLOCATOR_H
@@ -45,6 +45,15 @@ public:
 	 */
 	virtual void bind(Lifetime lf, IRdDynamic const* parent, string_view name) const = 0;
 
+	/**
+	 * \brief Same as [bind], but with the whole [name] of the node, e.g. of a collection entry.
+	 *
+	 * \param lf lifetime of node.
+	 * \param parent to whom bind.
+	 * \param name full name of node.
+	 */
+	virtual void bind_at(Lifetime lf, IRdDynamic const* parent, RName name) const = 0;
+
 	/**
 	 * \brief Assigns IDs to this node and its child nodes in the graph.
 	 *
@@ -96,6 +105,36 @@ typename std::enable_if_t<util::is_base_of_v<IRdBindable, T>> inline bindPolymor
 		obj.bind(lf, parent, name);
 	}
 }
+
+/**
+ * \brief Same as [bindPolymorphic] for an entry of the collection [parent], named by the key [format_key] makes when the
+ * name is first printed.
+ */
+template <typename T, typename F>
+typename std::enable_if_t<!util::is_base_of_v<IRdBindable, typename std::decay_t<T>>> inline bindPolymorphicLazily(
+	T&&, Lifetime /*lf*/, const IRdDynamic* /*parent*/, F&& /*format_key*/)
+{
+}
+
+template <typename F>
+inline void bindPolymorphicLazily(IRdBindable const& that, Lifetime lf, const IRdDynamic* parent, F&& format_key)
+{
+	that.bind_at(lf, parent, parent->location.sub_entry(std::forward<F>(format_key)));
+}
+
+template <typename T, typename F>
+typename std::enable_if_t<util::is_base_of_v<IRdBindable, T>> inline bindPolymorphicLazily(
+	std::vector<T> const& that, Lifetime lf, IRdDynamic const* parent, F&& format_key)
+{
+	if (!that.empty())
+	{
+		const RName name = parent->location.sub_entry(std::forward<F>(format_key));
+		for (auto& obj : that)
+		{
+			obj.bind_at(lf, parent, name);
+		}
+	}
+}
 }	 // namespace rd
 
 #endif	  // RD_CPP_FRAMEWORK_IRDBINDABLE_H
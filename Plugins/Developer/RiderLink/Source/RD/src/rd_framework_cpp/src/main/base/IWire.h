@@ -39,6 +39,39 @@ public:
 	 */
 	virtual void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const = 0;
 
+	/**
+	 * \brief Same as [send], but a message for [id] that is still queued may be dropped, so only this one is sent.
+	 * Only suitable for messages that carry the whole state of the recipient.
+	 * \param id of recipient.
+	 * \param writer is used to serialise data before send.
+	 */
+	virtual void send_coalesced(RdId const& id, std::function<void(Buffer& buffer)> writer) const
+	{
+		send(id, std::move(writer));
+	}
+
+	/**
+	 * \brief Serializes a message for [id] with [writer], so that it can be kept and handed to [send_packed] later.
+	 * \param id of recipient.
+	 * \param writer is used to serialise data.
+	 */
+	virtual Buffer::ByteArray pack(RdId const& /*id*/, std::function<void(Buffer& buffer)> const& writer) const
+	{
+		Buffer buffer;
+		writer(buffer);
+		return std::move(buffer).getRealArray();
+	}
+
+	/**
+	 * \brief Sends a [message] made by [pack] of this wire. Wires that can queue it as is don't copy it.
+	 * \param id of recipient.
+	 * \param message result of [pack] for [id].
+	 */
+	virtual void send_packed(RdId const& id, Buffer::ByteArray message) const
+	{
+		send(id, [&message](Buffer& buffer) { buffer.write_byte_array_raw(message); });
+	}
+
 	/**
 	 * \brief Adds a [handler] for receiving updated values of the object with the given [id]. The handler is removed
 	 * when the given [lifetime] is terminated.
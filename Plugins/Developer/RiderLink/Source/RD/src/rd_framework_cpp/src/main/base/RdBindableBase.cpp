@@ -15,12 +15,17 @@ bool RdBindableBase::is_bound() const
 }
 
 void RdBindableBase::bind(Lifetime lf, IRdDynamic const* parent, string_view name) const
+{
+	bind_at(lf, parent, parent->location.sub(name, "."));
+}
+
+void RdBindableBase::bind_at(Lifetime lf, IRdDynamic const* parent, RName name) const
 {
 	RD_ASSERT_MSG(!is_bound(), ("Trying to bound already bound this to " + to_string(parent->location)));
 	lf->bracket(
 		[this, lf, parent, &name] {
 			this->parent = parent;
-			location = parent->location.sub(name, ".");
+			location = std::move(name);
 			this->bind_lifetime = lf;
 		},
 		[this, lf]() {
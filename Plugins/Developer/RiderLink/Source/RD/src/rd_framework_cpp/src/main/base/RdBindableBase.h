@@ -31,7 +31,8 @@ public:
 
 	RdBindableBase()
 	{
-		location = RName("<<not bound>>");
+		static const RName not_bound("<<not bound>>");
+		location = not_bound;
 	};
 
 	RdBindableBase(RdBindableBase&& other) = default;
@@ -46,6 +47,8 @@ public:
 
 	void bind(Lifetime lf, IRdDynamic const* parent, string_view name) const override;
 
+	void bind_at(Lifetime lf, IRdDynamic const* parent, RName name) const override;
+
 	void identify(const Identities& identities, RdId const& id) const override;
 
 	SerializationCtx& get_serialization_context() const override;
@@ -2,9 +2,12 @@
 #define RD_CPP_RDPROPERTYBASE_H
 
 #include "base/RdReactiveBase.h"
+#include "serialization/Delta.h"
 #include "serialization/Polymorphic.h"
 #include "reactive/Property.h"
 
+#include <typeinfo>
+
 #if defined(_MSC_VER)
 #pragma warning(push)
 #pragma warning(disable : 4250)
@@ -21,12 +24,41 @@ protected:
 	mutable int32_t master_version = 0;
 	mutable bool default_value_changed = false;
 
+	// deltas
+	static constexpr int32_t deltaFlag = INT32_MIN;	   // set in the version of a numbered message, see [send_deltas]
+	static constexpr int32_t resendRequest = -1;	   // asks the other side for its full value
+	static constexpr int32_t noBase = -1;			   // base of a numbered message which carries the full value
+
+	// numbered messages sent so far and the value of the last one, which the next difference is based on
+	mutable int32_t sent_count = 0;
+	mutable property_storage<T> sent_base;
+	// number and value of the last numbered message received, which the next difference from the other side applies to
+	mutable int32_t received_number = noBase;
+	mutable property_storage<T> received_base;
+	// whether the full value is asked for and hasn't arrived yet
+	mutable bool resend_requested = false;
+
 	// init
 public:
 	mutable bool optimize_nested = false;
 
 	bool is_master = false;
 
+	/**
+	 * \brief When set, a local change drops this property's previous message if that one is still queued in the wire,
+	 * so only the latest value goes out. It is sent after everything queued before it. The version travels with the payload.
+	 */
+	bool coalesce_sends = false;
+
+	/**
+	 * \brief When set and T provides \a write_diff and \a patch (see [util::has_delta]), a local change is sent as the
+	 * fields which differ from the last value this side sent, and the other side patches the last value it received.
+	 * Messages are numbered and a difference names the message it is based on, so one which doesn't follow what the other
+	 * side received makes it ask for the full value. The first value is sent in full. The other side must support
+	 * differences for T too. Ignored together with [coalesce_sends], which drops messages on purpose.
+	 */
+	bool send_deltas = false;
+
 	// region ctor/dtor
 
 	RdPropertyBase() = default;
@@ -78,12 +110,7 @@ public:
 			{
 				master_version++;
 			}
-			get_wire()->send(rdid, [this, &v](Buffer& buffer) {
-				buffer.write_integral<int32_t>(master_version);
-				S::write(this->get_serialization_context(), buffer, v);
-				spdlog::get("logSend")->trace("SEND property {} + {}:: ver = {}, value = {}", to_string(location), to_string(rdid),
-					std::to_string(master_version), to_string(v));
-			});
+			send_value(v, false);
 		});
 
 		get_wire()->advise(lifetime, this);
@@ -101,19 +128,50 @@ public:
 
 	void on_wire_received(Buffer buffer) const override
 	{
-		int32_t version = buffer.read_integral<int32_t>();
-		WT v = S::read(this->get_serialization_context(), buffer);
+		const int32_t header = buffer.read_integral<int32_t>();
+		if (header == resendRequest)
+		{
+			if (this->has_value())
+			{
+				send_value(this->get(), true);
+			}
+			return;
+		}
+		const int32_t version = header & ~deltaFlag;
+
+		optional<WT> v;
+		if ((header & deltaFlag) == 0)
+		{
+			v = S::read(this->get_serialization_context(), buffer);
+		}
+		else
+		{
+			const int32_t number = buffer.read_integral<int32_t>();
+			const int32_t base = buffer.read_integral<int32_t>();
+			v = read_numbered(buffer, number, base, util::has_delta<T>{});
+			if (!v)
+			{
+				RD_LOG_TRACE(logReceived, "RECV property {} {}:: ver={}, difference from unknown message {}{}",
+					to_string(location), to_string(rdid), version, base, (resend_requested ? "" : ", requesting resend"));
+				if (!resend_requested)
+				{
+					resend_requested = true;
+					get_wire()->send(rdid, [](Buffer& buffer) { buffer.write_integral<int32_t>(resendRequest); });
+				}
+				return;
+			}
+		}
 
 		bool rejected = is_master && version < master_version;
-		spdlog::get("logSend")->trace("RECV property {} {}:: oldver={}, ver={}, value = {}{}", to_string(location), to_string(rdid),
-			master_version, version, to_string(v), (rejected ? ">> REJECTED" : ""));
+		RD_LOG_TRACE(logReceived, "RECV property {} {}:: oldver={}, ver={}, value = {}{}", to_string(location), to_string(rdid),
+			master_version, version, to_string(*v), (rejected ? ">> REJECTED" : ""));
 		if (rejected)
 		{
 			return;
 		}
 		master_version = version;
 
-		Property<T>::set(std::move(v));
+		Property<T>::set(std::move(*v));
 	}
 
 	void advise(Lifetime lifetime, std::function<void(T const&)> handler) const override
@@ -133,6 +191,103 @@ public:
 		});
 	}
 
+private:
+	void send_value(T const& v, bool full) const
+	{
+		const bool numbered = send_deltas && !coalesce_sends && util::has_delta<T>::value;
+		const bool delta = numbered && !full && has_delta_base(v, util::has_delta<T>{});
+		auto writer = [this, &v, numbered, delta, number = sent_count](Buffer& buffer) {
+			if (numbered)
+			{
+				buffer.write_integral<int32_t>(master_version | deltaFlag);
+				buffer.write_integral<int32_t>(number);
+				buffer.write_integral<int32_t>(delta ? number - 1 : noBase);
+			}
+			else
+			{
+				buffer.write_integral<int32_t>(master_version);
+			}
+			if (delta)
+			{
+				write_delta(buffer, v, util::has_delta<T>{});
+			}
+			else
+			{
+				S::write(this->get_serialization_context(), buffer, v);
+			}
+			RD_LOG_TRACE(logSend, "SEND property {} + {}:: ver = {}, value = {}{}", to_string(location), to_string(rdid),
+				std::to_string(master_version), to_string(v), (delta ? " as difference" : ""));
+		};
+		if (coalesce_sends)
+		{
+			get_wire()->send_coalesced(rdid, std::move(writer));
+		}
+		else
+		{
+			get_wire()->send(rdid, std::move(writer));
+		}
+		if (numbered)
+		{
+			++sent_count;
+			// shares the value when it is kept in heap
+			sent_base = this->value;
+		}
+	}
+
+	bool has_delta_base(T const& v, std::true_type) const
+	{
+		// a difference is written by the static type, so it must match the dynamic types on both sides
+		return static_cast<bool>(sent_base) && typeid(v) == typeid(*sent_base);
+	}
+
+	bool has_delta_base(T const&, std::false_type) const
+	{
+		return false;
+	}
+
+	void write_delta(Buffer& buffer, T const& v, std::true_type) const
+	{
+		v.write_diff(this->get_serialization_context(), buffer, *sent_base);
+	}
+
+	void write_delta(Buffer&, T const&, std::false_type) const
+	{
+	}
+
+	// the value of a numbered message, kept as the base of the next one even if the property rejects it
+	optional<WT> read_numbered(Buffer& buffer, int32_t number, int32_t base, std::true_type) const
+	{
+		optional<WT> v;
+		if (base == noBase)
+		{
+			v = S::read(this->get_serialization_context(), buffer);
+			resend_requested = false;
+		}
+		else if (received_base && base == received_number)
+		{
+			T value(*received_base);
+			value.patch(this->get_serialization_context(), buffer);
+			v = WT(std::move(value));
+		}
+		else
+		{
+			return nullopt;
+		}
+		received_number = number;
+		received_base = *v;
+		return v;
+	}
+
+	optional<WT> read_numbered(Buffer& buffer, int32_t /*number*/, int32_t base, std::false_type) const
+	{
+		if (base != noBase)
+		{
+			return nullopt;
+		}
+		return S::read(this->get_serialization_context(), buffer);
+	}
+
+public:
 	friend bool operator==(const RdPropertyBase& lhs, const RdPropertyBase& rhs)
 	{
 		return &lhs == &rhs;
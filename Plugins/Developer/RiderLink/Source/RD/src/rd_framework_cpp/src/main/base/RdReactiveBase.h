@@ -4,6 +4,7 @@
 #include "base/RdBindableBase.h"
 #include "base/IRdReactive.h"
 #include "guards.h"
+#include "util/logging.h"
 
 #include "spdlog/spdlog.h"
 
@@ -39,6 +40,10 @@ public:
 	virtual ~RdReactiveBase() = default;
 	// endregion
 
+	static std::shared_ptr<spdlog::logger> logReceived;
+
+	static std::shared_ptr<spdlog::logger> logSend;
+
 	const IWire* get_wire() const;
 
 	mutable bool is_local_change = false;
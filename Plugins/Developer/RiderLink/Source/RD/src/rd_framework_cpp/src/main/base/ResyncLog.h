@@ -0,0 +1,90 @@
+#ifndef RD_CPP_RESYNCLOG_H
+#define RD_CPP_RESYNCLOG_H
+
+#include "protocol/Buffer.h"
+
+#include <cstdint>
+#include <deque>
+
+namespace rd
+{
+/**
+ * \brief Change counters and a bounded log of sent changes, used by collections to bring a reconnected peer up to date.
+ *
+ * Each side counts the change messages it sends and receives. A peer asks for everything after the number of changes it
+ * has received, and gets the missing changes replayed if they are still in the log, or one snapshot otherwise.
+ */
+class ResyncLog
+{
+	int64_t sent = 0;
+	int64_t received = 0;
+	// payloads of the sent changes (sent - changes.size(), sent]
+	std::deque<Buffer::ByteArray> changes;
+
+public:
+	static Buffer::ByteArray written_since(Buffer const& buffer, size_t start)
+	{
+		return Buffer::ByteArray(buffer.data() + start, buffer.data() + buffer.get_position());
+	}
+
+	int64_t get_sent() const
+	{
+		return sent;
+	}
+
+	int64_t get_received() const
+	{
+		return received;
+	}
+
+	/**
+	 * \brief Counts a sent change and keeps the payload returned by [make_payload], unless [capacity] is zero.
+	 */
+	template <typename F>
+	void on_sent(size_t capacity, F&& make_payload)
+	{
+		++sent;
+		if (capacity == 0)
+		{
+			changes.clear();
+			return;
+		}
+		changes.push_back(make_payload());
+		while (changes.size() > capacity)
+		{
+			changes.pop_front();
+		}
+	}
+
+	void on_received()
+	{
+		++received;
+	}
+
+	void on_snapshot_received(int64_t version)
+	{
+		received = version;
+	}
+
+	/**
+	 * \brief Passes to [f] the payloads of the changes sent after the first [version] ones.
+	 * \return false if some of them are no longer in the log, and nothing is passed.
+	 */
+	template <typename F>
+	bool replay_since(int64_t version, F&& f) const
+	{
+		const int64_t first_logged = sent - static_cast<int64_t>(changes.size());
+		if (version < first_logged || version > sent)
+		{
+			return false;
+		}
+		for (size_t i = static_cast<size_t>(version - first_logged); i < changes.size(); ++i)
+		{
+			f(changes[i]);
+		}
+		return true;
+	}
+};
+}	 // namespace rd
+
+#endif	  // RD_CPP_RESYNCLOG_H
@@ -1,6 +1,10 @@
 #include "ExtWire.h"
 
 #include "protocol/Buffer.h"
+#include "util/core_util.h"
+#include "util/file_util.h"
+
+#include <cstring>
 
 namespace rd
 {
@@ -9,23 +13,151 @@ ExtWire::ExtWire()
 	connected.advise(Lifetime::Eternal(), [this](bool b) {
 		if (b)
 		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			flush();
+		}
+	});
+}
+
+ExtWire::~ExtWire()
+{
+	if (spill_file)
+	{
+		fclose(spill_file);
+		util::remove_file(spill_path);
+	}
+}
+
+void ExtWire::set_queue_policy(RdId const& id, QueuePolicy policy)
+{
+	RD_ASSERT_MSG(policy != QueuePolicy::KeepLatest, "KeepLatest is only for properties, see keep_latest");
+	set_policy(id, policy);
+}
+
+void ExtWire::set_policy(RdId const& id, QueuePolicy policy)
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	policies[id] = policy;
+}
+
+ExtWire::QueuePolicy ExtWire::policy_of(RdId const& id) const
+{
+	auto it = policies.find(id);
+	return it == policies.end() ? QueuePolicy::Keep : it->second;
+}
+
+void ExtWire::enqueue(RdId const& id, Buffer::ByteArray message, QueuePolicy policy) const
+{
+	if (policy == QueuePolicy::Drop)
+	{
+		return;
+	}
+	if (policy == QueuePolicy::KeepLatest)
+	{
+		const int64_t number = spilled + static_cast<int64_t>(sendQ.size());
+		auto it = latest.find(id);
+		if (it == latest.end())
+		{
+			latest.emplace(id, number);
+		}
+		else
+		{
+			// the new message goes to the tail after the ones queued in between, which it may depend on, e.g. intern
+			// ids; the old one is skipped when the queue is sent
+			if (it->second >= spilled)
 			{
-				std::lock_guard<decltype(lock)> guard(lock);
-				while (true)
+				auto& queued = sendQ[static_cast<size_t>(it->second - spilled)].message;
+				queued_bytes -= queued.size();
+				Buffer::ByteArray().swap(queued);
+			}
+			superseded.insert(it->second);
+			it->second = number;
+		}
+	}
+	queued_bytes += message.size();
+	sendQ.push_back(Queued{id, std::move(message)});
+	while (memory_limit != 0 && queued_bytes > memory_limit)
+	{
+		spill_oldest();
+	}
+}
+
+void ExtWire::spill_oldest() const
+{
+	Queued& oldest = sendQ.front();
+	if (superseded.count(spilled) != 0)
+	{
+		sendQ.pop_front();
+		++spilled;
+		return;
+	}
+	if (!spill_file && !dropping && !spill_path.empty())
+	{
+		spill_file = util::open_file(spill_path, "wb");
+	}
+	// a record is the number of the message, the id, the size and the message itself
+	const int64_t number = spilled;
+	const int64_t hash = oldest.id.get_hash();
+	const uint32_t size = static_cast<uint32_t>(oldest.message.size());
+	const bool written = !dropping && spill_file && fwrite(&number, sizeof(number), 1, spill_file) == 1 &&
+						 fwrite(&hash, sizeof(hash), 1, spill_file) == 1 && fwrite(&size, sizeof(size), 1, spill_file) == 1 &&
+						 (size == 0 || fwrite(oldest.message.data(), size, 1, spill_file) == 1);
+	if (!written && !dropping)
+	{
+		// after a failed write the file may end with a partial record, so nothing more is appended
+		spdlog::warn("ExtWire queue is over {} bytes and can't be spilled, oldest messages are dropped", memory_limit);
+		dropping = true;
+	}
+	queued_bytes -= oldest.message.size();
+	sendQ.pop_front();
+	++spilled;
+}
+
+void ExtWire::flush() const
+{
+	if (spill_file)
+	{
+		fclose(spill_file);
+		spill_file = nullptr;
+		{
+			const util::MappedFile file(spill_path);
+			char const* it = file.data();
+			char const* const end = it + file.size();
+			int64_t number;
+			int64_t hash;
+			uint32_t size;
+			while (static_cast<size_t>(end - it) >= sizeof(number) + sizeof(hash) + sizeof(size))
+			{
+				memcpy(&number, it, sizeof(number));
+				memcpy(&hash, it + sizeof(number), sizeof(hash));
+				memcpy(&size, it + sizeof(number) + sizeof(hash), sizeof(size));
+				it += sizeof(number) + sizeof(hash) + sizeof(size);
+				if (static_cast<size_t>(end - it) < size)
+				{
+					break;
+				}
+				if (superseded.count(number) == 0)
 				{
-					if (sendQ.empty())
-					{
-						return;
-					}
-					// auto[id, payload] = std::move(sendQ.front());
-					auto it = std::move(sendQ.front());
-					sendQ.pop();
-					realWire->send(
-						it.first, [payload = std::move(it.second)](Buffer& buffer) { buffer.write_byte_array_raw(payload); });
+					realWire->send_packed(RdId(hash), Buffer::ByteArray(it, it + size));
 				}
+				it += size;
 			}
 		}
-	});
+		util::remove_file(spill_path);
+	}
+	for (size_t i = 0; i < sendQ.size(); ++i)
+	{
+		if (superseded.count(spilled + static_cast<int64_t>(i)) == 0)
+		{
+			realWire->send_packed(sendQ[i].id, std::move(sendQ[i].message));
+		}
+	}
+	sendQ.clear();
+	spilled = 0;
+	queued_bytes = 0;
+	dropping = false;
+	latest.clear();
+	superseded.clear();
 }
 
 void ExtWire::advise(Lifetime lifetime, IRdReactive const* entity) const
@@ -37,14 +169,51 @@ void ExtWire::send(RdId const& id, std::function<void(Buffer& buffer)> writer) c
 {
 	{
 		std::lock_guard<decltype(lock)> guard(lock);
-		if (!sendQ.empty() || !connected.get())
+		if (spilled != 0 || !sendQ.empty() || !connected.get())
 		{
-			Buffer buffer;
-			writer(buffer);
-			sendQ.emplace(id, buffer.getRealArray());
+			const QueuePolicy policy = policy_of(id);
+			if (policy != QueuePolicy::Drop)
+			{
+				enqueue(id, realWire->pack(id, writer), policy);
+			}
 			return;
 		}
 	}
 	realWire->send(id, std::move(writer));
 }
+
+void ExtWire::send_coalesced(RdId const& id, std::function<void(Buffer& buffer)> writer) const
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (spilled != 0 || !sendQ.empty() || !connected.get())
+		{
+			const QueuePolicy policy = policy_of(id) == QueuePolicy::Drop ? QueuePolicy::Drop : QueuePolicy::KeepLatest;
+			if (policy != QueuePolicy::Drop)
+			{
+				enqueue(id, realWire->pack(id, writer), policy);
+			}
+			return;
+		}
+	}
+	realWire->send_coalesced(id, std::move(writer));
+}
+
+Buffer::ByteArray ExtWire::pack(RdId const& id, std::function<void(Buffer& buffer)> const& writer) const
+{
+	return realWire->pack(id, writer);
+}
+
+void ExtWire::send_packed(RdId const& id, Buffer::ByteArray message) const
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (spilled != 0 || !sendQ.empty() || !connected.get())
+		{
+			enqueue(id, std::move(message), policy_of(id));
+			return;
+		}
+	}
+	realWire->send_packed(id, std::move(message));
+}
 }	 // namespace rd
@@ -9,29 +9,124 @@
 #include "base/IWire.h"
 #include "protocol/RdId.h"
 #include "protocol/Buffer.h"
+#include "std/unordered_map.h"
+#include "std/unordered_set.h"
 
-#include <queue>
+#include <cstdio>
+#include <deque>
 #include <mutex>
 #include <functional>
+#include <string>
 
 #include <rd_framework_export.h>
 
 namespace rd
 {
+template <typename T, typename S>
+class RdPropertyBase;
+
+/**
+ * \brief Wire of an extension, which queues messages until the extension on the other side is connected.
+ *
+ * Queued messages are packed by the real wire, so they are handed over to it without copying once connected. If
+ * [memory_limit] is set, the oldest queued messages beyond it are appended to the file at [spill_path], or dropped if
+ * there is none.
+ */
 class RD_FRAMEWORK_API ExtWire final : public IWire
 {
+public:
+	/**
+	 * \brief What to do with messages for an entity while they can't be sent.
+	 */
+	enum class QueuePolicy
+	{
+		// keep all of them
+		Keep,
+		// keep only the newest one, for messages that carry the whole state, as with [send_coalesced]; see [keep_latest]
+		KeepLatest,
+		// don't keep them
+		Drop
+	};
+
+private:
+	struct Queued
+	{
+		RdId id;
+		Buffer::ByteArray message;
+	};
+
 	mutable std::mutex lock;
 
-	mutable std::queue<std::pair<RdId, Buffer::ByteArray> > sendQ;
+	// messages not sent yet, oldest first; numbered from 0, the first [spilled] of them are in the spill file
+	mutable std::deque<Queued> sendQ;
+	mutable int64_t spilled = 0;
+	mutable size_t queued_bytes = 0;
+	mutable FILE* spill_file = nullptr;
+	// set when a message couldn't be spilled, the oldest ones beyond [memory_limit] are dropped since
+	mutable bool dropping = false;
+	// KeepLatest entity -> number of its queued message
+	mutable rd::unordered_map<RdId, int64_t> latest;
+	// numbers of the queued or spilled messages superseded by newer ones of the same entity, they are not sent
+	mutable rd::unordered_set<int64_t> superseded;
+
+	rd::unordered_map<RdId, QueuePolicy> policies;
+
+	void enqueue(RdId const& id, Buffer::ByteArray message, QueuePolicy policy) const;
+
+	void spill_oldest() const;
+
+	void flush() const;
+
+	QueuePolicy policy_of(RdId const& id) const;
+
+	void set_policy(RdId const& id, QueuePolicy policy);
 
 public:
+	// region ctor/dtor
+
 	ExtWire();
 
+	~ExtWire() override;
+	// endregion
+
 	mutable IWire const* realWire = nullptr;
 
+	/**
+	 * \brief Bytes of queued messages kept in memory, 0 for no limit.
+	 */
+	size_t memory_limit = 0;
+
+	/**
+	 * \brief UTF-8 path of the file for queued messages beyond [memory_limit].
+	 */
+	std::string spill_path;
+
+	/**
+	 * \brief Sets the [policy] for messages to the entity with [id] while they can't be sent. [QueuePolicy::Keep] is
+	 * the default. Applies to messages sent after the call. [QueuePolicy::KeepLatest] is set with [keep_latest].
+	 */
+	void set_queue_policy(RdId const& id, QueuePolicy policy);
+
+	/**
+	 * \brief Keeps only the newest message of [property] while it can't be sent, it goes after all messages queued
+	 * before it. Every message of a property carries its whole value, unlike the events of a signal; not for
+	 * properties which send differences.
+	 */
+	template <typename T, typename S>
+	void keep_latest(RdPropertyBase<T, S> const& property)
+	{
+		set_policy(property.rdid, QueuePolicy::KeepLatest);
+	}
+
 	void advise(Lifetime lifetime, IRdReactive const* entity) const override;
 
 	void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const override;
+
+	void send_coalesced(RdId const& id, std::function<void(Buffer& buffer)> writer) const override;
+
+	Buffer::ByteArray pack(RdId const& id, std::function<void(Buffer& buffer)> const& writer) const override;
+
+	void send_packed(RdId const& id, Buffer::ByteArray message) const override;
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
@@ -47,6 +47,14 @@ public:
 
 	const IProtocol* get_protocol() const override;
 
+	/**
+	 * \brief Wire that queues the messages of this extension until the other side is connected.
+	 */
+	ExtWire& get_ext_wire() const
+	{
+		return *extWire;
+	}
+
 	IScheduler* get_wire_scheduler() const override;
 
 	void init(Lifetime lifetime) const override;
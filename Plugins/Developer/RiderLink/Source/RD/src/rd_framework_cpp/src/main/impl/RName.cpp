@@ -1,30 +1,92 @@
 #include "RName.h"
 
 #include "thirdparty.hpp"
+#include "util/hashing.h"
+
+#include <forward_list>
+#include <mutex>
+#include <unordered_set>
 
 namespace rd
 {
+namespace
+{
+struct ViewHash
+{
+	size_t operator()(string_view value) const noexcept
+	{
+		return static_cast<size_t>(util::getPlatformIndependentHash(value));
+	}
+};
+
+using view_set = std::unordered_set<string_view, ViewHash>;
+
+/**
+ * \brief Keeps one copy of every member name and separator for the whole process. They are looked up by content, so a
+ * name which is already known costs no allocation, and each thread remembers the names it has seen to skip the lock.
+ */
+string_view intern(string_view value)
+{
+	thread_local view_set seen;
+	auto it = seen.find(value);
+	if (it != seen.end())
+	{
+		return *it;
+	}
+
+	static std::mutex lock;
+	static view_set pool;
+	// node-based, so the stored strings never move
+	static std::forward_list<std::string> storage;
+
+	string_view interned;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto pooled = pool.find(value);
+		if (pooled == pool.end())
+		{
+			storage.emplace_front(value.data(), value.size());
+			pooled = pool.insert(string_view(storage.front())).first;
+		}
+		interned = *pooled;
+	}
+	seen.insert(interned);
+	return interned;
+}
+}	 // namespace
+
 class RNameImpl
 {
 public:
 	// region ctor/dtor
 	RNameImpl(RName parent, string_view localName, string_view separator);
 
+	RNameImpl(RName parent, std::function<std::string()> format_key);
+
 	RNameImpl(const RName& other) = delete;
 	RNameImpl(RName&& other) noexcept = delete;
 	RNameImpl& operator=(const RNameImpl& other) = delete;
 	RNameImpl& operator=(RNameImpl&& other) noexcept = delete;
 	// endregion
 
-	friend std::string to_string(RNameImpl const& value);
+	friend std::string const& to_string(RNameImpl const& value);
 
 private:
 	RName parent;
-	std::string local_name, separator;
+	string_view local_name, separator;
+	std::function<std::string()> format_key;
+
+	mutable std::once_flag printed;
+	mutable std::string full_name;
 };
 
 RNameImpl::RNameImpl(RName parent, string_view localName, string_view separator)
-	: parent(parent), local_name(localName), separator(separator)
+	: parent(std::move(parent)), local_name(intern(localName)), separator(intern(separator))
+{
+}
+
+RNameImpl::RNameImpl(RName parent, std::function<std::string()> format_key)
+	: parent(std::move(parent)), separator("."), format_key(std::move(format_key))
 {
 }
 
@@ -33,11 +95,18 @@ RName::RName(RName parent, string_view localName, string_view separator)
 {
 }
 
-RName RName::sub(string_view localName, string_view separator)
+RName RName::sub(string_view localName, string_view separator) const
 {
 	return RName(*this, localName, separator);
 }
 
+RName RName::sub_entry(std::function<std::string()> format_key) const
+{
+	RName result;
+	result.impl = std::make_shared<RNameImpl>(*this, std::move(format_key));
+	return result;
+}
+
 std::string to_string(RName const& value)
 {
 	std::string res;
@@ -48,17 +117,24 @@ std::string to_string(RName const& value)
 	return res;
 }
 
-std::string to_string(RNameImpl const& value)
+std::string const& to_string(RNameImpl const& value)
 {
-	if (value.parent)
-	{
-		std::string res;
-		res = to_string(value.parent);
-		res += value.separator;
-		res += value.local_name;
-		return res;
-	}
-	return value.local_name;
+	std::call_once(value.printed, [&value] {
+		if (value.parent)
+		{
+			value.full_name = to_string(value.parent);
+			value.full_name.append(value.separator.data(), value.separator.size());
+		}
+		if (value.format_key)
+		{
+			value.full_name += "[" + value.format_key() + "]";
+		}
+		else
+		{
+			value.full_name.append(value.local_name.data(), value.local_name.size());
+		}
+	});
+	return value.full_name;
 }
 
 RName::RName(string_view local_name) : RName(RName(), local_name, "")
@@ -8,6 +8,7 @@
 
 #include "thirdparty.hpp"
 
+#include <functional>
 #include <string>
 #include <rd_framework_export.h>
 
@@ -17,6 +18,10 @@ class RNameImpl;
 
 /**
  * \brief Recursive name. For constructs like Aaaa.Bbb::CCC
+ *
+ * A name is its parent plus an interned segment, so creating one copies no strings. Entries of collections keep a
+ * function formatting their key instead. The full string is built when the name is first printed and kept for later
+ * calls.
  */
 class RD_FRAMEWORK_API RName
 {
@@ -38,7 +43,15 @@ public:
 	explicit RName(string_view local_name);
 	// endregion
 
-	RName sub(string_view localName, string_view separator);
+	/**
+	 * \brief Name of a member, [localName] should come from a fixed set, because it is interned for the whole process.
+	 */
+	RName sub(string_view localName, string_view separator) const;
+
+	/**
+	 * \brief Name of a collection entry like parent.[key], [format_key] is called when the name is first printed.
+	 */
+	RName sub_entry(std::function<std::string()> format_key) const;
 
 	explicit operator bool() const
 	{
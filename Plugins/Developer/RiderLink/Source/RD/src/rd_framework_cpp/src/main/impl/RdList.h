@@ -3,6 +3,7 @@
 
 #include "reactive/ViewableList.h"
 #include "base/RdReactiveBase.h"
+#include "base/ResyncLog.h"
 #include "serialization/Polymorphic.h"
 #include "std/allocator.h"
 
@@ -28,8 +29,31 @@ private:
 
 	//		mutable ViewableList<T> list;
 	using list = ViewableList<T>;
+	using ListEvent = typename IViewableList<T>::Event;
 	mutable int64_t next_version = 1;
 
+	/**
+	 * \brief Lists never acknowledge, so the ACK op code carries range operations without widening the op field.
+	 * A range message continues with its \a RangeOp, the element count and, for additions, the elements.
+	 */
+	static constexpr Op rangeOp = Op::ACK;
+
+	enum class RangeOp : int32_t
+	{
+		ADD,
+		REMOVE
+	};
+
+	/**
+	 * \brief Headers of resync messages. Versions are positive, so negative headers never clash with changes. A request
+	 * carries the number of changes the peer has received, a snapshot carries the number of changes sent so far, the next
+	 * version and all elements.
+	 */
+	static constexpr int64_t resyncRequestHeader = -1;
+	static constexpr int64_t resyncSnapshotHeader = -2;
+
+	mutable ResyncLog resync;
+
 	std::string logmsg(Op op, int64_t version, int32_t key, T const* value = nullptr) const
 	{
 		return "list " + to_string(location) + " " + to_string(rdid) + ":: " + to_string(op) + ":: key = " + std::to_string(key) +
@@ -37,6 +61,119 @@ private:
 			   " :: value = " + (value ? to_string(*value) : "");
 	}
 
+	std::string logmsg(RangeOp op, int64_t version, int32_t key, size_t count) const
+	{
+		return "list " + to_string(location) + " " + to_string(rdid) + ":: " + (op == RangeOp::ADD ? "AddRange" : "RemoveRange") +
+			   ":: key = " + std::to_string(key) + " :: version = " + std::to_string(version) +
+			   " :: count = " + std::to_string(count);
+	}
+
+	void send_element(ListEvent const& e) const
+	{
+		get_wire()->send(rdid, [this, e](Buffer& buffer) {
+			const size_t start = buffer.get_position();
+			Op op = static_cast<Op>(e.v.index());
+
+			buffer.write_integral<int64_t>(static_cast<int64_t>(op) | (next_version++ << versionedFlagShift));
+			buffer.write_integral<int32_t>(static_cast<const int32_t>(e.get_index()));
+
+			T const* new_value = e.get_new_value();
+			if (new_value)
+			{
+				S::write(this->get_serialization_context(), buffer, *new_value);
+			}
+			RD_LOG_TRACE(logSend, logmsg(op, next_version - 1, e.get_index(), new_value));
+
+			resync.on_sent(resync_log_capacity, [&] { return ResyncLog::written_since(buffer, start); });
+		});
+	}
+
+	void send_range(ListEvent const& e) const
+	{
+		get_wire()->send(rdid, [this, e](Buffer& buffer) {
+			const size_t start = buffer.get_position();
+			const bool is_add = e.v.index() == 3;
+			const RangeOp op = is_add ? RangeOp::ADD : RangeOp::REMOVE;
+			std::vector<T const*> const& values = is_add ? rd::get<typename ListEvent::AddRange>(e.v).new_values
+														 : rd::get<typename ListEvent::RemoveRange>(e.v).old_values;
+
+			buffer.write_integral<int64_t>(static_cast<int64_t>(rangeOp) | (next_version++ << versionedFlagShift));
+			buffer.write_integral<int32_t>(static_cast<const int32_t>(e.get_index()));
+			buffer.write_integral<int32_t>(static_cast<int32_t>(op));
+			buffer.write_integral<int32_t>(static_cast<int32_t>(values.size()));
+			if (is_add)
+			{
+				for (T const* value : values)
+				{
+					S::write(this->get_serialization_context(), buffer, *value);
+				}
+			}
+			RD_LOG_TRACE(logSend, logmsg(op, next_version - 1, e.get_index(), values.size()));
+
+			resync.on_sent(resync_log_capacity, [&] { return ResyncLog::written_since(buffer, start); });
+		});
+	}
+
+	void send_snapshot() const
+	{
+		get_wire()->send(rdid, [this](Buffer& buffer) {
+			buffer.write_integral<int64_t>(resyncSnapshotHeader);
+			buffer.write_integral<int64_t>(resync.get_sent());
+			buffer.write_integral<int64_t>(next_version);
+			buffer.write_integral<int32_t>(static_cast<int32_t>(list::size()));
+			for (auto const& value : list::getList())
+			{
+				S::write(this->get_serialization_context(), buffer, *value);
+			}
+			RD_LOG_TRACE(logSend, "list {} {}:: snapshot :: version = {} :: size = {}", to_string(location), to_string(rdid),
+				resync.get_sent(), list::size());
+		});
+	}
+
+	void on_resync_request(int64_t version) const
+	{
+		RD_LOG_TRACE(logReceived, "list {} {}:: resync request :: version = {}", to_string(location), to_string(rdid), version);
+		const bool replayed = resync.replay_since(version, [this](Buffer::ByteArray const& payload) {
+			get_wire()->send(rdid, [&payload](Buffer& buffer) { buffer.write_byte_array_raw(payload); });
+		});
+		if (!replayed)
+		{
+			send_snapshot();
+		}
+	}
+
+	void on_snapshot_received(Buffer& buffer) const
+	{
+		const int64_t version = buffer.read_integral<int64_t>();
+		const int64_t snapshot_next_version = buffer.read_integral<int64_t>();
+		const int32_t count = buffer.read_integral<int32_t>();
+		RD_LOG_TRACE(logReceived, 
+			"list {} {}:: snapshot :: version = {} :: size = {}", to_string(location), to_string(rdid), version, count);
+
+		std::vector<WT> values;
+		values.reserve(count);
+		for (int32_t i = 0; i < count; ++i)
+		{
+			values.push_back(S::read(this->get_serialization_context(), buffer));
+		}
+		list::replaceAll(std::move(values));
+		next_version = snapshot_next_version;
+		resync.on_snapshot_received(version);
+	}
+
+	void identify_new_values(ListEvent const& e) const
+	{
+		const IProtocol* iProtocol = get_protocol();
+		const Identities* identity = iProtocol->get_identity();
+		e.for_each_element([&](ListEvent const& element) {
+			T const* new_value = element.get_new_value();
+			if (new_value)
+			{
+				identifyPolymorphic(*new_value, *identity, identity->next(rdid));
+			}
+		});
+	}
+
 public:
 	using Event = typename IViewableList<T>::Event;
 
@@ -73,39 +210,40 @@ public:
 
 	bool optimize_nested = false;
 
+	/**
+	 * \brief Number of sent changes kept to bring a reconnected peer up to date with \a request_resync. Both sides must
+	 * understand resync messages.
+	 */
+	size_t resync_log_capacity = 0;
+
+	/**
+	 * \brief Send range changes as one message. The other side must understand range messages, so this is off by default
+	 * and range changes are sent element by element.
+	 */
+	bool send_ranges = false;
+
 	void init(Lifetime lifetime) const override
 	{
 		RdBindableBase::init(lifetime);
 
 		local_change([this, lifetime] {
-			advise(lifetime, [this, lifetime](typename IViewableList<T>::Event e) {
+			advise_ranges(lifetime, [this, lifetime](Event const& e) {
 				if (!is_local_change)
 					return;
 
 				if (!optimize_nested)
 				{
-					T const* new_value = e.get_new_value();
-					if (new_value)
-					{
-						const IProtocol* iProtocol = get_protocol();
-						const Identities* identity = iProtocol->get_identity();
-						identifyPolymorphic(*new_value, *identity, identity->next(rdid));
-					}
+					identify_new_values(e);
 				}
 
-				get_wire()->send(rdid, [this, e](Buffer& buffer) {
-					Op op = static_cast<Op>(e.v.index());
-
-					buffer.write_integral<int64_t>(static_cast<int64_t>(op) | (next_version++ << versionedFlagShift));
-					buffer.write_integral<int32_t>(static_cast<const int32_t>(e.get_index()));
-
-					T const* new_value = e.get_new_value();
-					if (new_value)
-					{
-						S::write(this->get_serialization_context(), buffer, *new_value);
-					}
-					spdlog::get("logSend")->trace(logmsg(op, next_version - 1, e.get_index(), new_value));
-				});
+				if (e.is_range() && send_ranges)
+				{
+					send_range(e);
+				}
+				else
+				{
+					e.for_each_element([this](Event const& element) { send_element(element); });
+				}
 			});
 		});
 
@@ -114,7 +252,7 @@ public:
 		if (!optimize_nested)
 		{
 			this->view(lifetime, [this](Lifetime lf, size_t index, T const& value) {
-				bindPolymorphic(value, lf, this, "[" + std::to_string(index) + "]");
+				bindPolymorphicLazily(value, lf, this, [index] { return std::to_string(index); });
 			});
 		}
 	}
@@ -122,6 +260,18 @@ public:
 	void on_wire_received(Buffer buffer) const override
 	{
 		int64_t header = (buffer.read_integral<int64_t>());
+		if (header == resyncRequestHeader)
+		{
+			on_resync_request(buffer.read_integral<int64_t>());
+			return;
+		}
+		if (header == resyncSnapshotHeader)
+		{
+			on_snapshot_received(buffer);
+			return;
+		}
+		resync.on_received();
+
 		int64_t version = header >> versionedFlagShift;
 		Op op = static_cast<Op>((header & ((1 << versionedFlagShift) - 1L)));
 		int32_t index = (buffer.read_integral<int32_t>());
@@ -138,7 +288,7 @@ public:
 			{
 				auto value = S::read(this->get_serialization_context(), buffer);
 
-				spdlog::get("logReceived")->trace(logmsg(op, version, index, &(wrapper::get<T>(value))));
+				RD_LOG_TRACE(logReceived, logmsg(op, version, index, &(wrapper::get<T>(value))));
 
 				(index < 0) ? list::add(std::move(value)) : list::add(static_cast<size_t>(index), std::move(value));
 				break;
@@ -147,20 +297,41 @@ public:
 			{
 				auto value = S::read(this->get_serialization_context(), buffer);
 
-				spdlog::get("logReceived")->trace(logmsg(op, version, index, &(wrapper::get<T>(value))));
+				RD_LOG_TRACE(logReceived, logmsg(op, version, index, &(wrapper::get<T>(value))));
 
 				list::set(static_cast<size_t>(index), std::move(value));
 				break;
 			}
 			case Op::REMOVE:
 			{
-				spdlog::get("logReceived")->trace(logmsg(op, version, index));
+				RD_LOG_TRACE(logReceived, logmsg(op, version, index));
 
 				list::removeAt(static_cast<size_t>(index));
 				break;
 			}
-			case Op::ACK:
+			case rangeOp:
+			{
+				RangeOp range_op = static_cast<RangeOp>(buffer.read_integral<int32_t>());
+				int32_t count = buffer.read_integral<int32_t>();
+
+				RD_LOG_TRACE(logReceived, logmsg(range_op, version, index, static_cast<size_t>(count)));
+
+				if (range_op == RangeOp::ADD)
+				{
+					std::vector<WT> values;
+					values.reserve(count);
+					for (int32_t i = 0; i < count; ++i)
+					{
+						values.push_back(S::read(this->get_serialization_context(), buffer));
+					}
+					list::addRange(static_cast<size_t>(index), std::move(values));
+				}
+				else
+				{
+					list::removeRange(static_cast<size_t>(index), static_cast<size_t>(count));
+				}
 				break;
+			}
 		}
 	}
 
@@ -173,6 +344,29 @@ public:
 		list::advise(lifetime, handler);
 	}
 
+	void advise_ranges(Lifetime lifetime, std::function<void(Event const&)> handler) const override
+	{
+		if (is_bound())
+		{
+			assert_threading();
+		}
+		list::advise_ranges(lifetime, handler);
+	}
+
+	/**
+	 * \brief Asks the other side for the changes this side hasn't received. They are replayed if the other side still
+	 * has them in its log, otherwise the whole list is sent in one snapshot message.
+	 */
+	void request_resync() const
+	{
+		get_wire()->send(rdid, [this](Buffer& buffer) {
+			buffer.write_integral<int64_t>(resyncRequestHeader);
+			buffer.write_integral<int64_t>(resync.get_received());
+			RD_LOG_TRACE(logSend, 
+				"list {} {}:: resync request :: version = {}", to_string(location), to_string(rdid), resync.get_received());
+		});
+	}
+
 	bool add(WT element) const override
 	{
 		return local_change([this, element = std::move(element)]() mutable { return list::add(std::move(element)); });
@@ -238,6 +432,21 @@ public:
 		return local_change([&] { return list::removeAll(std::move(elements)); });
 	}
 
+	bool addRange(size_t index, std::vector<WT> elements) const override
+	{
+		return local_change([&] { return list::addRange(index, std::move(elements)); });
+	}
+
+	bool removeRange(size_t index, size_t count) const override
+	{
+		return local_change([&] { return list::removeRange(index, count); });
+	}
+
+	bool replaceAll(std::vector<WT> elements) const override
+	{
+		return local_change([&] { return list::replaceAll(std::move(elements)); });
+	}
+
 	friend std::string to_string(RdList const& value)
 	{
 		std::string res = "[";
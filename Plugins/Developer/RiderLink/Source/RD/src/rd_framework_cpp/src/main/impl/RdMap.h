@@ -3,10 +3,16 @@
 
 #include "reactive/ViewableMap.h"
 #include "base/RdReactiveBase.h"
+#include "base/ResyncLog.h"
 #include "serialization/Polymorphic.h"
 #include "util/shared_function.h"
+#include "std/unordered_map.h"
+#include "std/unordered_set.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <deque>
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -36,7 +42,113 @@ private:
 
 	using map = ViewableMap<K, V>;
 	mutable int64_t next_version = 0;
-	mutable ordered_map<K const*, int64_t, wrapper::TransparentHash<K>, wrapper::TransparentKeyEqual<K>> pendingForAck;
+
+	struct PendingAck
+	{
+		int64_t version;
+		// the key in pending_keys, nullptr once acknowledged
+		K const* key;
+		bool acked;
+	};
+
+	// changes sent by the master in version order, trimmed from the front as they are acknowledged
+	mutable std::deque<PendingAck> pendingForAck;
+	// number of unacknowledged changes per key, checked on every incoming change
+	mutable rd::unordered_map<K, int32_t> pending_keys;
+
+	// highest version received by the slave and not acknowledged yet
+	mutable int64_t ack_up_to = 0;
+	mutable bool ack_queued = false;
+
+	/**
+	 * \brief Op code of a cumulative acknowledgement, above the range of \a Op. It carries the highest version received,
+	 * which acknowledges every change up to it.
+	 */
+	static constexpr int32_t ackUpToOp = 0x12;
+
+	// inline storage recycles erased entries, so key sets hold copies instead of pointers into the map
+	using key_ref_t = std::conditional_t<map::inline_storage, K, K const*>;
+
+	static K const& key_ref(K const* key, std::true_type)
+	{
+		return *key;
+	}
+
+	static K const* key_ref(K const* key, std::false_type)
+	{
+		return key;
+	}
+
+	bool has_pending_ack(K const& key) const
+	{
+		return pending_keys.count(key) > 0;
+	}
+
+	void add_pending_ack(int64_t version, K const& key) const
+	{
+		auto it = pending_keys.find(key);
+		if (it == pending_keys.end())
+		{
+			it = pending_keys.emplace(key, 0).first;
+		}
+		++it->second;
+		// node-based, so the key stays in place while it is pending
+		pendingForAck.push_back(PendingAck{version, &it->first, false});
+	}
+
+	void acknowledge(PendingAck& pending) const
+	{
+		auto it = pending_keys.find(*pending.key);
+		if (--it->second == 0)
+		{
+			pending_keys.erase(it);
+		}
+		pending.key = nullptr;
+		pending.acked = true;
+	}
+
+	void trim_acknowledged() const
+	{
+		while (!pendingForAck.empty() && pendingForAck.front().acked)
+		{
+			pendingForAck.pop_front();
+		}
+	}
+
+	void acknowledge_up_to(int64_t version) const
+	{
+		while (!pendingForAck.empty() && pendingForAck.front().version <= version)
+		{
+			if (!pendingForAck.front().acked)
+			{
+				acknowledge(pendingForAck.front());
+			}
+			pendingForAck.pop_front();
+		}
+	}
+
+	void queue_ack(int64_t version) const
+	{
+		ack_up_to = (std::max)(ack_up_to, version);
+		if (ack_queued)
+		{
+			return;
+		}
+		ack_queued = true;
+		// runs after the messages already queued on the scheduler, so a burst of changes is acknowledged once
+		get_wire_scheduler()->queue([this, lifetime = *bind_lifetime] {
+			if (lifetime->is_terminated())
+			{
+				return;
+			}
+			ack_queued = false;
+			get_wire()->send(rdid, [this](Buffer& buffer) {
+				buffer.write_integral<int32_t>(ackUpToOp);
+				buffer.write_integral<int64_t>(ack_up_to);
+				RD_LOG_TRACE(logSend, "SEND map {} {}:: ACK up to {}", to_string(location), to_string(rdid), ack_up_to);
+			});
+		});
+	}
 
 	std::string logmsg(Op op, int64_t version, K const* key, V const* value = nullptr) const
 	{
@@ -50,11 +162,102 @@ private:
 		return logmsg(op, version, key, value ? &(wrapper::get(*value)) : nullptr);
 	}
 
+	/**
+	 * \brief Op codes of resync messages, above the range of \a Op. A request carries the number of changes the peer has
+	 * received, a snapshot carries the number of changes sent so far and all entries.
+	 */
+	static constexpr int32_t resyncRequestOp = 0x10;
+	static constexpr int32_t resyncSnapshotOp = 0x11;
+
+	mutable ResyncLog resync;
+
+	void send_snapshot() const
+	{
+		get_wire()->send(rdid, [this](Buffer& buffer) {
+			buffer.write_integral<int32_t>(resyncSnapshotOp);
+			buffer.write_integral<int64_t>(resync.get_sent());
+			buffer.write_integral<int32_t>(static_cast<int32_t>(map::size()));
+			for (auto it = this->begin(); it != this->end(); ++it)
+			{
+				KS::write(this->get_serialization_context(), buffer, it.key());
+				VS::write(this->get_serialization_context(), buffer, it.value());
+			}
+			RD_LOG_TRACE(logSend, "SEND map {} {}:: snapshot :: version = {} :: size = {}", to_string(location),
+				to_string(rdid), resync.get_sent(), map::size());
+		});
+	}
+
+	void on_resync_request(int64_t version) const
+	{
+		RD_LOG_TRACE(logReceived, "RECV map {} {}:: resync request :: version = {}", to_string(location), to_string(rdid), version);
+		const bool replayed = resync.replay_since(version, [this](Buffer::ByteArray const& payload) {
+			get_wire()->send(rdid, [&payload](Buffer& buffer) { buffer.write_byte_array_raw(payload); });
+		});
+		if (!replayed)
+		{
+			send_snapshot();
+		}
+	}
+
+	void on_snapshot_received(Buffer& buffer) const
+	{
+		const int64_t version = buffer.read_integral<int64_t>();
+		const int32_t count = buffer.read_integral<int32_t>();
+		RD_LOG_TRACE(logReceived, 
+			"RECV map {} {}:: snapshot :: version = {} :: size = {}", to_string(location), to_string(rdid), version, count);
+
+		std::vector<std::pair<WK, WV>> entries;
+		entries.reserve(count);
+		for (int32_t i = 0; i < count; ++i)
+		{
+			WK key = KS::read(this->get_serialization_context(), buffer);
+			WV value = VS::read(this->get_serialization_context(), buffer);
+			entries.emplace_back(std::move(key), std::move(value));
+		}
+
+		rd::unordered_set<key_ref_t, wrapper::TransparentHash<K>, wrapper::TransparentKeyEqual<K>> fresh;
+		for (auto const& entry : entries)
+		{
+			fresh.insert(key_ref(&wrapper::get<K>(entry.first), std::integral_constant<bool, map::inline_storage>{}));
+		}
+		std::vector<WK> stale;
+		for (auto it = this->begin(); it != this->end(); ++it)
+		{
+			if (fresh.count(key_ref(&it.key(), std::integral_constant<bool, map::inline_storage>{})) == 0)
+			{
+				stale.emplace_back(it.key());
+			}
+		}
+		fresh.clear();
+
+		for (auto const& key : stale)
+		{
+			map::remove(wrapper::get<K>(key));
+		}
+		for (auto& entry : entries)
+		{
+			map::set(std::move(entry.first), std::move(entry.second));
+		}
+		resync.on_snapshot_received(version);
+	}
+
 public:
 	bool is_master = false;
 
 	bool optimize_nested = false;
 
+	/**
+	 * \brief Acknowledge the master's changes with one cumulative message per scheduler batch instead of one message per
+	 * change. The master must understand cumulative acknowledgements, so this is off by default.
+	 */
+	bool batch_acks = false;
+
+	/**
+	 * \brief Number of sent changes kept to bring a reconnected peer up to date with \a request_resync. Both sides must
+	 * understand resync messages.
+	 */
+	size_t resync_log_capacity = 0;
+
 	using Event = typename IViewableMap<K, V>::Event;
 
 	using key_type = K;
@@ -104,6 +307,7 @@ public:
 				}
 
 				get_wire()->send(rdid, [this, e](Buffer& buffer) {
+					const size_t start = buffer.get_position();
 					int32_t versionedFlag = ((is_master ? 1 : 0)) << versionedFlagShift;
 					Op op = static_cast<Op>(e.v.index());
 
@@ -113,7 +317,7 @@ public:
 
 					if (is_master)
 					{
-						pendingForAck.emplace(e.get_key(), version);
+						add_pending_ack(version, *e.get_key());
 						buffer.write_integral(version);
 					}
 
@@ -125,7 +329,19 @@ public:
 						VS::write(this->get_serialization_context(), buffer, *new_value);
 					}
 
-					spdlog::get("logSend")->trace("SEND{}", logmsg(op, next_version - 1, e.get_key(), new_value));
+					RD_LOG_TRACE(logSend, "SEND{}", logmsg(op, next_version - 1, e.get_key(), new_value));
+
+					resync.on_sent(resync_log_capacity, [&] {
+						Buffer::ByteArray payload = ResyncLog::written_since(buffer, start);
+						if (is_master)
+						{
+							// a replayed change is not a new version, so it goes out unversioned and is not acknowledged
+							const int32_t header = static_cast<int32_t>(op);
+							payload.erase(payload.begin() + sizeof(int32_t), payload.begin() + sizeof(int32_t) + sizeof(int64_t));
+							memcpy(payload.data(), &header, sizeof(header));
+						}
+						return payload;
+					});
 				});
 			});
 		});
@@ -134,13 +350,36 @@ public:
 
 		if (!optimize_nested)
 			this->view(lifetime, [this](Lifetime lf, std::pair<K const*, V const*> entry) {
-				bindPolymorphic(entry.second, lf, this, "[" + to_string(*entry.first) + "]");
+				bindPolymorphicLazily(entry.second, lf, this, [key = *entry.first] { return to_string(key); });
 			});
 	}
 
 	void on_wire_received(Buffer buffer) const override
 	{
 		int32_t header = buffer.read_integral<int32_t>();
+		if (header == resyncRequestOp)
+		{
+			on_resync_request(buffer.read_integral<int64_t>());
+			return;
+		}
+		if (header == resyncSnapshotOp)
+		{
+			on_snapshot_received(buffer);
+			return;
+		}
+		if (header == ackUpToOp)
+		{
+			const int64_t version = buffer.read_integral<int64_t>();
+			if (!is_master)
+			{
+				RD_LOG_ERROR(logReceived, "RECV map {} {}:: ACK up to {} when not a Master", to_string(location), to_string(rdid), version);
+				return;
+			}
+			RD_LOG_TRACE(logReceived, "RECV map {} {}:: ACK up to {}", to_string(location), to_string(rdid), version);
+			acknowledge_up_to(version);
+			return;
+		}
+
 		bool msg_versioned = (header >> versionedFlagShift) != 0;
 		Op op = static_cast<Op>(header & ((1 << versionedFlagShift) - 1));
 
@@ -161,23 +400,12 @@ public:
 			}
 			else
 			{
-				if (pendingForAck.count(key) > 0)
+				auto it = std::lower_bound(pendingForAck.begin(), pendingForAck.end(), version,
+					[](PendingAck const& pending, int64_t v) { return pending.version < v; });
+				if (it != pendingForAck.end() && it->version == version && !it->acked && *it->key == wrapper::get<K>(key))
 				{
-					int64_t pendingVersion = pendingForAck.at(key);
-					if (pendingVersion < version)
-					{
-						errmsg = "Pending version " + std::to_string(pendingVersion) + " < " + to_string(Op::ACK) + " version `" +
-								 std::to_string(version);
-					}
-					else
-					{
-						// side effect
-						if (pendingVersion == version)
-						{
-							pendingForAck.erase(key);	 // else we don't need to remove, silently drop
-						}
-						// return good result
-					}
+					acknowledge(*it);
+					trim_acknowledged();
 				}
 				else
 				{
@@ -186,17 +414,23 @@ public:
 			}
 			if (errmsg.empty())
 			{
-				spdlog::get("logReceived")->trace(logmsg(Op::ACK, version, &(wrapper::get<K>(key))));
+				RD_LOG_TRACE(logReceived, logmsg(Op::ACK, version, &(wrapper::get<K>(key))));
 			}
 			else
 			{
-				spdlog::get("logReceived")->error(logmsg(Op::ACK, version, &(wrapper::get<K>(key))) + " >> " + errmsg);
+				RD_LOG_ERROR(logReceived, logmsg(Op::ACK, version, &(wrapper::get<K>(key))) + " >> " + errmsg);
 			}
 		}
 		else
 		{
+			resync.on_received();
+
+			// the key is moved into the map below, so a per-change ACK needs it serialized beforehand
 			Buffer serialized_key;
-			KS::write(this->get_serialization_context(), serialized_key, wrapper::get<K>(key));
+			if (msg_versioned && !batch_acks)
+			{
+				KS::write(this->get_serialization_context(), serialized_key, wrapper::get<K>(key));
+			}
 
 			bool is_put = (op == Op::ADD || op == Op::UPDATE);
 			optional<WV> value;
@@ -205,9 +439,9 @@ public:
 				value = VS::read(this->get_serialization_context(), buffer);
 			}
 
-			if (msg_versioned || !is_master || pendingForAck.count(key) == 0)
+			if (msg_versioned || !is_master || !has_pending_ack(wrapper::get<K>(key)))
 			{
-				spdlog::get("logReceived")->trace("RECV{}", logmsg(op, version, &(wrapper::get<K>(key)), value));
+				RD_LOG_TRACE(logReceived, "RECV{}", logmsg(op, version, &(wrapper::get<K>(key)), value));
 				if (value.has_value())
 				{
 					map::set(std::move(key), *std::move(value));
@@ -219,23 +453,30 @@ public:
 			}
 			else
 			{
-				spdlog::get("logReceived")->trace("{} >> REJECTED", logmsg(op, version, &(wrapper::get<K>(key)), value));
+				RD_LOG_TRACE(logReceived, "{} >> REJECTED", logmsg(op, version, &(wrapper::get<K>(key)), value));
 			}
 
 			if (msg_versioned)
 			{
-				auto writer =
-					util::make_shared_function([version, serialized_key = std::move(serialized_key)](Buffer& innerBuffer) mutable {
-						innerBuffer.write_integral<int32_t>((1u << versionedFlagShift) | static_cast<int32_t>(Op::ACK));
-						innerBuffer.write_integral<int64_t>(version);
-						// KS::write(this->get_serialization_context(), innerBuffer, wrapper::get<K>(key));
-						innerBuffer.write_byte_array_raw(serialized_key.getArray());
-						// logSend.trace(logmsg(Op::ACK, version, serialized_key));
-					});
-				get_wire()->send(rdid, std::move(writer));
+				if (batch_acks)
+				{
+					queue_ack(version);
+				}
+				else
+				{
+					auto writer = util::make_shared_function(
+						[version, serialized_key = std::move(serialized_key)](Buffer& innerBuffer) mutable {
+							innerBuffer.write_integral<int32_t>((1u << versionedFlagShift) | static_cast<int32_t>(Op::ACK));
+							innerBuffer.write_integral<int64_t>(version);
+							// KS::write(this->get_serialization_context(), innerBuffer, wrapper::get<K>(key));
+							innerBuffer.write_byte_array_raw(serialized_key.getArray());
+							// logSend.trace(logmsg(Op::ACK, version, serialized_key));
+						});
+					get_wire()->send(rdid, std::move(writer));
+				}
 				if (is_master)
 				{
-					spdlog::get("logReceived")->error("Both ends are masters: {}", to_string(location));
+					RD_LOG_ERROR(logReceived, "Both ends are masters: {}", to_string(location));
 				}
 			}
 		}
@@ -250,6 +491,20 @@ public:
 		map::advise(lifetime, handler);
 	}
 
+	/**
+	 * \brief Asks the other side for the changes this side hasn't received. They are replayed if the other side still
+	 * has them in its log, otherwise the whole map is sent in one snapshot message.
+	 */
+	void request_resync() const
+	{
+		get_wire()->send(rdid, [this](Buffer& buffer) {
+			buffer.write_integral<int32_t>(resyncRequestOp);
+			buffer.write_integral<int64_t>(resync.get_received());
+			RD_LOG_TRACE(logSend, 
+				"SEND map {} {}:: resync request :: version = {}", to_string(location), to_string(rdid), resync.get_received());
+		});
+	}
+
 	V const* get(K const& key) const override
 	{
 		return local_change([&] { return map::get(key); });
@@ -3,8 +3,10 @@
 
 #include "reactive/ViewableSet.h"
 #include "base/RdReactiveBase.h"
+#include "base/ResyncLog.h"
 #include "serialization/Polymorphic.h"
 #include "std/allocator.h"
+#include "std/unordered_set.h"
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -25,6 +27,82 @@ class RdSet final : public RdReactiveBase, public ViewableSet<T, A>, public ISer
 private:
 	using WT = typename IViewableSet<T>::WT;
 
+	/**
+	 * \brief Values of the kind field for resync messages, above the range of \a AddRemove. A request carries the number
+	 * of changes the peer has received, a snapshot carries the number of changes sent so far and all elements.
+	 */
+	static constexpr int32_t resyncRequestKind = 2;
+	static constexpr int32_t resyncSnapshotKind = 3;
+
+	mutable ResyncLog resync;
+
+	void send_snapshot() const
+	{
+		get_wire()->send(rdid, [this](Buffer& buffer) {
+			buffer.write_integral<int32_t>(resyncSnapshotKind);
+			buffer.write_integral<int64_t>(resync.get_sent());
+			buffer.write_integral<int32_t>(static_cast<int32_t>(set::size()));
+			for (auto const& value : *this)
+			{
+				S::write(this->get_serialization_context(), buffer, value);
+			}
+			RD_LOG_TRACE(logSend, "SENDset {} {}:: snapshot :: version = {} :: size = {}", to_string(location),
+				to_string(rdid), resync.get_sent(), set::size());
+		});
+	}
+
+	void on_resync_request(int64_t version) const
+	{
+		RD_LOG_TRACE(logReceived, "RECVset {} {}:: resync request :: version = {}", to_string(location), to_string(rdid), version);
+		const bool replayed = resync.replay_since(version, [this](Buffer::ByteArray const& payload) {
+			get_wire()->send(rdid, [&payload](Buffer& buffer) { buffer.write_byte_array_raw(payload); });
+		});
+		if (!replayed)
+		{
+			send_snapshot();
+		}
+	}
+
+	void on_snapshot_received(Buffer& buffer) const
+	{
+		const int64_t version = buffer.read_integral<int64_t>();
+		const int32_t count = buffer.read_integral<int32_t>();
+		RD_LOG_TRACE(logReceived, 
+			"RECVset {} {}:: snapshot :: version = {} :: size = {}", to_string(location), to_string(rdid), version, count);
+
+		std::vector<WT> values;
+		values.reserve(count);
+		for (int32_t i = 0; i < count; ++i)
+		{
+			values.push_back(S::read(this->get_serialization_context(), buffer));
+		}
+
+		rd::unordered_set<T const*, wrapper::TransparentHash<T>, wrapper::TransparentKeyEqual<T>> fresh;
+		for (auto const& value : values)
+		{
+			fresh.insert(&wrapper::get<T>(value));
+		}
+		std::vector<WT> stale;
+		for (auto const& value : *this)
+		{
+			if (fresh.count(&value) == 0)
+			{
+				stale.emplace_back(value);
+			}
+		}
+		fresh.clear();
+
+		for (auto const& value : stale)
+		{
+			set::remove(wrapper::get<T>(value));
+		}
+		for (auto& value : values)
+		{
+			set::add(std::move(value));
+		}
+		resync.on_snapshot_received(version);
+	}
+
 protected:
 	using set = ViewableSet<T>;
 
@@ -60,6 +138,12 @@ public:
 
 	bool optimize_nested = false;
 
+	/**
+	 * \brief Number of sent changes kept to bring a reconnected peer up to date with \a request_resync. Both sides must
+	 * understand resync messages.
+	 */
+	size_t resync_log_capacity = 0;
+
 	void init(Lifetime lifetime) const override
 	{
 		RdBindableBase::init(lifetime);
@@ -70,10 +154,13 @@ public:
 					return;
 
 				get_wire()->send(rdid, [this, kind, &v](Buffer& buffer) {
+					const size_t start = buffer.get_position();
 					buffer.write_enum<AddRemove>(kind);
 					S::write(this->get_serialization_context(), buffer, v);
 
-					spdlog::get("logSend")->trace("SENDset {} {}:: {}:: {}", to_string(location), to_string(rdid), to_string(kind), to_string(v));
+					RD_LOG_TRACE(logSend, "SENDset {} {}:: {}:: {}", to_string(location), to_string(rdid), to_string(kind), to_string(v));
+
+					resync.on_sent(resync_log_capacity, [&] { return ResyncLog::written_since(buffer, start); });
 				});
 			});
 		});
@@ -83,7 +170,20 @@ public:
 
 	void on_wire_received(Buffer buffer) const override
 	{
-		AddRemove kind = buffer.read_enum<AddRemove>();
+		const int32_t raw_kind = buffer.read_integral<int32_t>();
+		if (raw_kind == resyncRequestKind)
+		{
+			on_resync_request(buffer.read_integral<int64_t>());
+			return;
+		}
+		if (raw_kind == resyncSnapshotKind)
+		{
+			on_snapshot_received(buffer);
+			return;
+		}
+		resync.on_received();
+
+		AddRemove kind = static_cast<AddRemove>(raw_kind);
 		auto value = S::read(this->get_serialization_context(), buffer);
 
 		switch (kind)
@@ -140,6 +240,20 @@ public:
 		set::advise(lifetime, std::move(handler));
 	}
 
+	/**
+	 * \brief Asks the other side for the changes this side hasn't received. They are replayed if the other side still
+	 * has them in its log, otherwise the whole set is sent in one snapshot message.
+	 */
+	void request_resync() const
+	{
+		get_wire()->send(rdid, [this](Buffer& buffer) {
+			buffer.write_integral<int32_t>(resyncRequestKind);
+			buffer.write_integral<int64_t>(resync.get_received());
+			RD_LOG_TRACE(logSend, 
+				"SENDset {} {}:: resync request :: version = {}", to_string(location), to_string(rdid), resync.get_received());
+		});
+	}
+
 	bool addAll(std::vector<WT> elements) const override
 	{
 		return local_change([this, elements = std::move(elements)]() mutable { return set::addAll(elements); });
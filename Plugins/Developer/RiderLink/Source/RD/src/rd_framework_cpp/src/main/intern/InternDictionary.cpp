@@ -0,0 +1,178 @@
+#include "InternDictionary.h"
+
+#include "util/core_util.h"
+#include "util/file_util.h"
+#include "util/hashing.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace rd
+{
+namespace
+{
+constexpr char magic[4] = {'R', 'D', 'I', 'D'};
+
+struct Header
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t count;
+	uint32_t reserved;
+	uint64_t hash;
+};
+
+// same as util::getPlatformIndependentHash, without recursion
+uint64_t hash_bytes(char const* begin, char const* end)
+{
+	uint64_t hash = util::DEFAULT_HASH;
+	for (char const* it = begin; it != end; ++it)
+	{
+		hash = hash * util::HASH_FACTOR + static_cast<uint64_t>(*it);
+	}
+	return hash;
+}
+
+// appends [value] as UTF-16, a character outside the BMP becomes a surrogate pair where wchar_t is 32 bits
+template <int>
+void append_utf16(std::vector<uint16_t>& units, std::wstring const& value)
+{
+	for (const wchar_t c : value)
+	{
+		const uint32_t code = static_cast<uint32_t>(c);
+		if (code > 0xFFFF)
+		{
+			units.push_back(static_cast<uint16_t>(0xD800 + ((code - 0x10000) >> 10)));
+			units.push_back(static_cast<uint16_t>(0xDC00 + ((code - 0x10000) & 0x3FF)));
+		}
+		else
+		{
+			units.push_back(static_cast<uint16_t>(code));
+		}
+	}
+}
+
+template <>
+void append_utf16<2>(std::vector<uint16_t>& units, std::wstring const& value)
+{
+	units.insert(units.end(), value.begin(), value.end());
+}
+
+template <int>
+std::wstring from_utf16(std::vector<uint16_t> const& units)
+{
+	std::wstring result;
+	result.reserve(units.size());
+	for (size_t i = 0; i < units.size(); ++i)
+	{
+		uint32_t code = units[i];
+		if (code >= 0xD800 && code < 0xDC00 && i + 1 < units.size() && units[i + 1] >= 0xDC00 && units[i + 1] < 0xE000)
+		{
+			code = 0x10000 + ((code - 0xD800) << 10) + (units[++i] - 0xDC00u);
+		}
+		result.push_back(static_cast<wchar_t>(code));
+	}
+	return result;
+}
+
+template <>
+std::wstring from_utf16<2>(std::vector<uint16_t> const& units)
+{
+	return std::wstring(units.begin(), units.end());
+}
+}	 // namespace
+
+std::shared_ptr<InternDictionary> InternDictionary::load(std::string const& path)
+{
+	const util::MappedFile file(path);
+	if (file.size() < sizeof(Header))
+	{
+		return nullptr;
+	}
+	Header header;
+	memcpy(&header, file.data(), sizeof(header));
+	char const* const begin = file.data() + sizeof(Header);
+	char const* const end = file.data() + file.size();
+	if (memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != format_version ||
+		hash_bytes(begin, end) != header.hash)
+	{
+		spdlog::warn("Intern dictionary {} is outdated or damaged, ignored", path);
+		return nullptr;
+	}
+
+	std::shared_ptr<InternDictionary> dictionary(new InternDictionary());
+	dictionary->hash = header.hash;
+	dictionary->values.reserve(header.count);
+	char const* it = begin;
+	std::vector<uint16_t> units;
+	for (uint32_t i = 0; i < header.count; ++i)
+	{
+		int32_t length = 0;
+		if (static_cast<size_t>(end - it) < sizeof(length))
+		{
+			return nullptr;
+		}
+		memcpy(&length, it, sizeof(length));
+		it += sizeof(length);
+		if (length < 0 || static_cast<size_t>(end - it) < sizeof(uint16_t) * static_cast<size_t>(length))
+		{
+			return nullptr;
+		}
+		units.resize(static_cast<size_t>(length));
+		if (length > 0)
+		{
+			memcpy(units.data(), it, sizeof(uint16_t) * units.size());
+		}
+		it += sizeof(uint16_t) * units.size();
+		dictionary->values.emplace_back(any::string(from_utf16<sizeof(wchar_t)>(units)));
+		dictionary->index.emplace(dictionary->values.back(), static_cast<int32_t>(i));
+	}
+	dictionary->uses.reset(new std::atomic<uint32_t>[header.count]);
+	for (uint32_t i = 0; i < header.count; ++i)
+	{
+		dictionary->uses[i].store(0, std::memory_order_relaxed);
+	}
+	return dictionary;
+}
+
+bool InternDictionary::save(std::string const& path, std::vector<std::wstring> const& strings)
+{
+	std::vector<char> entries;
+	std::vector<uint16_t> units;
+	for (auto const& value : strings)
+	{
+		units.clear();
+		append_utf16<sizeof(wchar_t)>(units, value);
+		const int32_t length = static_cast<int32_t>(units.size());
+		const size_t offset = entries.size();
+		entries.resize(offset + sizeof(length) + sizeof(uint16_t) * units.size());
+		memcpy(&entries[offset], &length, sizeof(length));
+		if (!units.empty())
+		{
+			memcpy(&entries[offset + sizeof(length)], units.data(), sizeof(uint16_t) * units.size());
+		}
+	}
+
+	Header header;
+	memcpy(header.magic, magic, sizeof(magic));
+	header.version = format_version;
+	header.count = static_cast<uint32_t>(strings.size());
+	header.reserved = 0;
+	header.hash = hash_bytes(entries.data(), entries.data() + entries.size());
+
+	const std::string tmp_path = path + ".tmp";
+	FILE* file = util::open_file(tmp_path, "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	const bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+						 (entries.empty() || fwrite(entries.data(), entries.size(), 1, file) == 1);
+	if (fclose(file) != 0 || !written)
+	{
+		util::remove_file(tmp_path);
+		return false;
+	}
+	return util::replace_file(tmp_path, path);
+}
+}	 // namespace rd
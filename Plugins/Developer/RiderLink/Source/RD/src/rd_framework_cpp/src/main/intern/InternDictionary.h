@@ -0,0 +1,106 @@
+#ifndef RD_CPP_INTERNDICTIONARY_H
+#define RD_CPP_INTERNDICTIONARY_H
+
+#include "serialization/RdAny.h"
+#include "std/unordered_map.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+namespace rd
+{
+/**
+ * \brief Strings with ids agreed on in advance, loaded from a file that both sides of a protocol read. An [InternRoot]
+ * uses it once the other side has announced a dictionary with the same hash, so these strings are never sent.
+ *
+ * The file holds a header (magic "RDID", format version, entry count, reserved word, hash of the entries) followed by
+ * the entries, each written as on the wire: an int32 length and that many UTF-16 code units. The hash is computed over
+ * the entry bytes the same way as [util::getPlatformIndependentHash].
+ *
+ * Lookups never lock: the dictionary does not change after loading, except for its use counters.
+ */
+class RD_FRAMEWORK_API InternDictionary
+{
+public:
+	static constexpr uint32_t format_version = 1;
+
+private:
+	using index_t = rd::unordered_map<InternedAny, int32_t, any::TransparentHash, any::TransparentKeyEqual>;
+
+	std::vector<InternedAny> values;
+	index_t index;
+	std::unique_ptr<std::atomic<uint32_t>[]> uses;
+	uint64_t hash = 0;
+
+	InternDictionary() = default;
+
+public:
+	// region ctor/dtor
+
+	InternDictionary(InternDictionary const&) = delete;
+
+	InternDictionary& operator=(InternDictionary const&) = delete;
+	// endregion
+
+	/**
+	 * \brief Maps the file at [path] (UTF-8) and reads the dictionary from it.
+	 * \return nullptr if there is no file, or it is of another format version or damaged.
+	 */
+	static std::shared_ptr<InternDictionary> load(std::string const& path);
+
+	/**
+	 * \brief Writes [strings] as a dictionary to [path] (UTF-8), replacing the file only once it is complete.
+	 */
+	static bool save(std::string const& path, std::vector<std::wstring> const& strings);
+
+	uint64_t get_hash() const
+	{
+		return hash;
+	}
+
+	size_t size() const
+	{
+		return values.size();
+	}
+
+	InternedAny const& at(size_t entry) const
+	{
+		return values[entry];
+	}
+
+	/**
+	 * \return the entry holding [value] and counts the use, or -1.
+	 */
+	int32_t find(InternedAny const& value) const
+	{
+		auto it = index.find(value);
+		if (it == index.end())
+		{
+			return -1;
+		}
+		uses[it->second].fetch_add(1, std::memory_order_relaxed);
+		return it->second;
+	}
+
+	uint32_t get_uses(size_t entry) const
+	{
+		return uses[entry].load(std::memory_order_relaxed);
+	}
+};
+}	 // namespace rd
+
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_INTERNDICTIONARY_H
@@ -2,6 +2,9 @@
 
 #include "serialization/AbstractPolymorphic.h"
 #include "serialization/InternedAnySerializer.h"
+#include "std/unordered_set.h"
+
+#include <algorithm>
 
 namespace rd
 {
@@ -20,6 +23,21 @@ void InternRoot::on_wire_received(Buffer buffer) const
 	optional<InternedAny> value = InternedAnySerializer::read(get_serialization_context(), buffer);
 	if (!value)
 	{
+		// no value: the other side announces its dictionary, starts a new generation or acknowledges ours
+		const int32_t tag = buffer.read_integral<int32_t>();
+		if (tag == dictionaryAnnouncement)
+		{
+			const uint64_t hash = buffer.read_integral<uint64_t>();
+			dictionary_agreed.store(dictionary && dictionary->get_hash() == hash, std::memory_order_release);
+		}
+		else if (is_index_owned(tag))
+		{
+			on_generation_started(tag);
+		}
+		else
+		{
+			on_generation_acknowledged(tag ^ 1);
+		}
 		return;
 	}
 	const int32_t remote_id = buffer.read_integral<int32_t>();
@@ -27,14 +45,14 @@ void InternRoot::on_wire_received(Buffer buffer) const
 	RD_ASSERT_MSG(((remote_id & 1) == 0), "Remote sent ID marked as our own, bug?");
 }
 
-void InternRoot::bind(Lifetime lf, IRdDynamic const* parent, string_view name) const
+void InternRoot::bind_at(Lifetime lf, IRdDynamic const* parent, RName name) const
 {
 	RD_ASSERT_MSG(!is_bound(), "Trying to bound already bound "s + to_string(this->location) + " to " + to_string(parent->location))
 
 	lf->bracket(
 		[this, parent, &name] {
 			this->parent = parent;
-			location = parent->location.sub(name, ".");
+			location = std::move(name);
 		},
 		[this] {
 			location = location.sub("<<unbound>>", "::");
@@ -45,11 +63,74 @@ void InternRoot::bind(Lifetime lf, IRdDynamic const* parent, string_view name) c
 	{
 		// if something's interned before bind
 		std::lock_guard<decltype(lock)> guard(lock);
+		std::lock_guard<decltype(other_items_lock)> other_guard(other_items_lock);
 		my_items_lis.clear();
 		other_items_list.clear();
-		inverse_map.clear();
+		for (auto& shard : inverse_map)
+		{
+			std::lock_guard<decltype(shard.lock)> shard_guard(shard.lock);
+			shard.ids.clear();
+		}
+		generation_start = 0;
+		acknowledged_start = 0;
+		other_generation_start = 0;
 	}
+	dictionary_agreed = false;
 	get_protocol()->get_wire()->advise(lf, this);
+
+	if (dictionary)
+	{
+		get_protocol()->get_wire()->send(rdid, [hash = dictionary->get_hash()](Buffer& buffer) {
+			RdId::Null().write(buffer);
+			buffer.write_integral<int32_t>(dictionaryAnnouncement);
+			buffer.write_integral<uint64_t>(hash);
+		});
+	}
+}
+
+void InternRoot::set_dictionary(std::shared_ptr<InternDictionary> value)
+{
+	RD_ASSERT_MSG(!is_bound(), "Intern dictionary must be set before bind: " + to_string(location));
+	dictionary = std::move(value);
+}
+
+std::vector<std::wstring> InternRoot::frequent_strings(size_t limit) const
+{
+	std::vector<std::pair<uint64_t, std::wstring const*>> ranked;
+	if (dictionary)
+	{
+		for (size_t entry = 0; entry < dictionary->size(); ++entry)
+		{
+			ranked.emplace_back(dictionary->get_uses(entry), &*get<any::string>(dictionary->at(entry)));
+		}
+	}
+	std::vector<std::unique_lock<std::mutex>> guards;
+	for (auto& shard : inverse_map)
+	{
+		guards.emplace_back(shard.lock);
+		for (auto const& it : shard.ids)
+		{
+			visit(util::make_visitor([](any::wrapped_super_t const&) {},
+					  [&](any::string const& value) { ranked.emplace_back(it.second.uses, &*value); }),
+				it.first);
+		}
+	}
+	std::stable_sort(ranked.begin(), ranked.end(), [](auto const& lhs, auto const& rhs) { return lhs.first > rhs.first; });
+
+	std::vector<std::wstring> result;
+	rd::unordered_set<std::wstring> seen;
+	for (auto const& it : ranked)
+	{
+		if (result.size() == limit)
+		{
+			break;
+		}
+		if (seen.insert(*it.second).second)
+		{
+			result.push_back(*it.second);
+		}
+	}
+	return result;
 }
 
 void InternRoot::identify(const Identities& /*identities*/, RdId const& id) const
@@ -60,12 +141,123 @@ void InternRoot::identify(const Identities& /*identities*/, RdId const& id) cons
 	rdid = id;
 }
 
+InternRoot::IndexShard& InternRoot::shard_of(InternedAny const& value) const
+{
+	// fibonacci hashing, the top bits pick the shard and the low ones stay for the buckets inside it
+	const uint64_t hash = static_cast<uint64_t>(any::TransparentHash()(value)) * 0x9E3779B97F4A7C15ull;
+	return inverse_map[static_cast<size_t>(hash >> (64 - shard_shift))];
+}
+
+int32_t InternRoot::allocate_own_id(InternedAny const& value) const
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	const int32_t id = static_cast<int32_t>(my_items_lis.push_back(value)) * 2;
+	pending_sends.insert(id);
+	pending_count.fetch_add(1, std::memory_order_relaxed);
+	return id;
+}
+
+void InternRoot::on_sent(int32_t id) const
+{
+	bool generation_full = false;
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		pending_sends.erase(id);
+		pending_count.fetch_sub(1, std::memory_order_release);
+		generation_full = capacity != 0 && static_cast<size_t>(id - generation_start) / 2 + 1 >= capacity;
+	}
+	sent_cv.notify_all();
+	if (generation_full)
+	{
+		start_generation();
+	}
+}
+
+void InternRoot::wait_sent(int32_t id) const
+{
+	if (!is_index_owned(id) || pending_count.load(std::memory_order_acquire) == 0)
+	{
+		return;
+	}
+	std::unique_lock<decltype(lock)> guard(lock);
+	sent_cv.wait(guard, [this, id] { return pending_sends.count(id) == 0; });
+}
+
+void InternRoot::start_generation() const
+{
+	int32_t first_kept = 0;
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		first_kept = static_cast<int32_t>(my_items_lis.size()) * 2;
+		if (first_kept == generation_start)
+		{
+			return;
+		}
+		generation_start = first_kept;
+	}
+	drop_from_index(true, first_kept);
+	get_protocol()->get_wire()->send(rdid, [first_kept](Buffer& buffer) {
+		RdId::Null().write(buffer);
+		buffer.write_integral<int32_t>(first_kept);
+	});
+}
+
+void InternRoot::drop_from_index(bool own, int32_t first_kept) const
+{
+	for (auto& shard : inverse_map)
+	{
+		std::lock_guard<decltype(shard.lock)> guard(shard.lock);
+		for (auto it = shard.ids.begin(); it != shard.ids.end();)
+		{
+			if (is_index_owned(it->second.id) == own && it->second.id < first_kept)
+			{
+				it = shard.ids.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+}
+
+void InternRoot::on_generation_started(int32_t first_kept) const
+{
+	drop_from_index(false, first_kept ^ 1);
+	{
+		// the previous generation may still be referred to by messages the other side wrote while it started this one
+		std::lock_guard<decltype(other_items_lock)> guard(other_items_lock);
+		other_items_list.free_below(static_cast<size_t>(other_generation_start / 2));
+		other_generation_start = first_kept;
+	}
+	get_protocol()->get_wire()->send(rdid, [first_kept](Buffer& buffer) {
+		RdId::Null().write(buffer);
+		buffer.write_integral<int32_t>(first_kept ^ 1);
+	});
+}
+
+void InternRoot::on_generation_acknowledged(int32_t first_kept) const
+{
+	// the other side may still have written an id of the previous generation while it dropped this one
+	std::lock_guard<decltype(lock)> guard(lock);
+	my_items_lis.free_below(static_cast<size_t>(acknowledged_start / 2));
+	acknowledged_start = first_kept;
+}
+
 void InternRoot::set_interned_correspondence(int32_t id, InternedAny&& value) const
 {
 	RD_ASSERT_MSG(!is_index_owned(id), "Setting interned correspondence for object that we should have written, bug?")
 
-	std::lock_guard<decltype(lock)> guard(lock);
-	other_items_list[id / 2] = value;
-	inverse_map[value] = id;
+	{
+		std::lock_guard<decltype(other_items_lock)> guard(other_items_lock);
+		if (!other_items_list.set(static_cast<size_t>(id / 2), value))
+		{
+			// a value of a freed generation which arrived late, nothing may refer to it any more
+			return;
+		}
+	}
+	IndexShard& shard = shard_of(value);
+	std::lock_guard<decltype(shard.lock)> guard(shard.lock);
+	shard.ids[std::move(value)] = IndexEntry{id, 1};
 }
 }	 // namespace rd
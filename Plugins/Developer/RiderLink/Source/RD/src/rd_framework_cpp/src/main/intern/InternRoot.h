@@ -2,17 +2,21 @@
 #define RD_CPP_INTERNROOT_H
 
 #include "base/RdReactiveBase.h"
+#include "InternDictionary.h"
 #include "InternScheduler.h"
 #include "lifetime/Lifetime.h"
 #include "types/wrapper.h"
 #include "serialization/RdAny.h"
+#include "util/append_only_vector.h"
 #include "util/core_traits.h"
+#include "std/unordered_map.h"
 
-#include "tsl/ordered_map.h"
-
-#include <vector>
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <string>
 #include <mutex>
+#include <unordered_set>
 
 #include <rd_framework_export.h>
 
@@ -32,32 +36,119 @@ class Identities;
 
 /**
  * \brief Node in graph for storing interned objects.
+ *
+ * Ids are resolved to values without locks. Values are mapped to ids by an index split into shards, each with its own
+ * lock, and a new value is sent to the other side outside of any lock.
+ *
+ * Messages without a value carry a tag: -1 announces the dictionary, an own id starts a new generation at it and an id of
+ * the receiver acknowledges that the sender dropped the receiver's values below it from its index.
  */
 class RD_FRAMEWORK_API InternRoot final : public RdReactiveBase
 {
 private:
-	// template<typename T>
-	mutable std::vector<InternedAny> my_items_lis;
+	struct IndexEntry
+	{
+		int32_t id;
+		uint32_t uses;
+	};
+
+	using index_t = rd::unordered_map<InternedAny, IndexEntry, any::TransparentHash, any::TransparentKeyEqual>;
+
+	struct IndexShard
+	{
+		std::mutex lock;
+		index_t ids;
+	};
+
+	static constexpr size_t shard_shift = 4;
+	static constexpr size_t shard_count = size_t(1) << shard_shift;
 
-	// template<typename T>
-	mutable ordered_map<int32_t, InternedAny> other_items_list;
-	// template<typename T>
-	mutable ordered_map<InternedAny, int32_t, any::TransparentHash, any::TransparentKeyEqual> inverse_map;
+	// id -> value, the values of a generation are freed one generation after the other side is done with it, so an id
+	// stays valid for a message which was written while the generation changed
+	mutable util::append_only_vector<InternedAny> my_items_lis;
+	mutable util::append_only_vector<InternedAny> other_items_list;
+
+	// value -> id
+	mutable std::array<IndexShard, shard_count> inverse_map;
 
 	mutable InternScheduler intern_scheduler;
 
-	mutable std::recursive_mutex lock;
+	// serializes appends to my_items_lis and guards the fields below
+	mutable std::mutex lock;
+	// serializes appends to other_items_list
+	mutable std::mutex other_items_lock;
+
+	// own ids which are indexed but not sent yet, nobody may write them before the other side learns them
+	mutable std::unordered_set<int32_t> pending_sends;
+	mutable std::atomic<size_t> pending_count{0};
+	mutable std::condition_variable sent_cv;
+
+	// first own id of the current generation
+	mutable int32_t generation_start = 0;
+	// first own id of the generation the other side acknowledged last, the ids below the one before are freed
+	mutable int32_t acknowledged_start = 0;
+	// first id of the current generation of the other side, guarded by other_items_lock
+	mutable int32_t other_generation_start = 0;
+
+	// entries have the negative ids -2 * (entry + 1) and, as seen by the other side, that xor 1
+	std::shared_ptr<InternDictionary> dictionary;
+	// whether the other side announced the same dictionary
+	mutable std::atomic<bool> dictionary_agreed{false};
+
+	static constexpr int32_t dictionaryAnnouncement = -1;
+
+	static constexpr int32_t dictionary_id(int32_t entry);
+
+	static constexpr size_t dictionary_entry(int32_t id);
+
+	IndexShard& shard_of(InternedAny const& value) const;
+
+	int32_t allocate_own_id(InternedAny const& value) const;
+
+	void on_sent(int32_t id) const;
+
+	void wait_sent(int32_t id) const;
+
+	void start_generation() const;
+
+	void drop_from_index(bool own, int32_t first_kept) const;
+
+	void on_generation_started(int32_t first_kept) const;
+
+	void on_generation_acknowledged(int32_t first_kept) const;
 
 	void set_interned_correspondence(int32_t id, InternedAny&& value) const;
 
 	static constexpr bool is_index_owned(int32_t id);
 
+	template <typename T>
+	void send_value(int32_t id, Wrapper<T> const& value) const;
+
 public:
+	/**
+	 * \brief Number of own values kept in the index for reuse, 0 for no limit. When reached, a new generation starts: the
+	 * own values are dropped from the index, so they get new ids when interned again, and the other side is told to drop
+	 * them from its index too. Once it acknowledges that, both sides free the values of the generation before, so about
+	 * three generations stay in memory. A peer which doesn't acknowledge generations only gets the index bounded.
+	 */
+	size_t capacity = 0;
+
 	// region ctor/dtor
 
 	InternRoot();
 	// endregion
 
+	/**
+	 * \brief Sets the dictionary to use once the other side announces the same one. Must be called before bind.
+	 */
+	void set_dictionary(std::shared_ptr<InternDictionary> value);
+
+	/**
+	 * \return up to [limit] strings, most used first, from the dictionary and from this session, to save as the next
+	 * dictionary.
+	 */
+	std::vector<std::wstring> frequent_strings(size_t limit) const;
+
 	template <typename T>
 	int32_t intern_value(Wrapper<T> value) const;
 
@@ -66,7 +157,7 @@ public:
 
 	IScheduler* get_wire_scheduler() const override;
 
-	void bind(Lifetime lf, IRdDynamic const* parent, string_view name) const override;
+	void bind_at(Lifetime lf, IRdDynamic const* parent, RName name) const override;
 
 	void identify(const Identities& identities, RdId const& id) const override;
 
@@ -92,41 +183,79 @@ constexpr bool InternRoot::is_index_owned(int32_t id)
 	return !static_cast<bool>(id & 1);
 }
 
+constexpr int32_t InternRoot::dictionary_id(int32_t entry)
+{
+	return -2 * (entry + 1);
+}
+
+constexpr size_t InternRoot::dictionary_entry(int32_t id)
+{
+	return static_cast<size_t>((-id - 1) / 2);
+}
+
 template <typename T>
 Wrapper<T> InternRoot::un_intern_value(int32_t id) const
 {
-	// don't need lock because value's already exists and never removes
-	return any::get<T>(is_index_owned(id) ? my_items_lis[id / 2] : other_items_list[id / 2]);
+	// don't need lock because the value already exists and is only freed generations after the last message using it
+	if (id < 0)
+	{
+		return any::get<T>(dictionary->at(dictionary_entry(id)));
+	}
+	InternedAny const* value = is_index_owned(id) ? my_items_lis.find(id / 2) : other_items_list.find(id / 2);
+	RD_ASSERT_THROW_MSG(value != nullptr, "Interned id isn't known or its generation is freed: " + std::to_string(id));
+	return any::get<T>(*value);
+}
+
+template <typename T>
+void InternRoot::send_value(int32_t id, Wrapper<T> const& value) const
+{
+	// values nested in this one are interned and sent while it is written, so they reach the other side first
+	get_protocol()->get_wire()->send(this->rdid, [this, id, &value](Buffer& buffer) {
+		InternedAnySerializer::write<T>(get_serialization_context(), buffer, wrapper::get<T>(value));
+		buffer.write_integral<int32_t>(id);
+	});
 }
 
 template <typename T>
 int32_t InternRoot::intern_value(Wrapper<T> value) const
 {
 	InternedAny any = any::make_interned_any<T>(value);
+	if (dictionary_agreed.load(std::memory_order_acquire))
+	{
+		const int32_t entry = dictionary->find(any);
+		if (entry >= 0)
+		{
+			return dictionary_id(entry);
+		}
+	}
+	IndexShard& shard = shard_of(any);
 
-	std::lock_guard<decltype(lock)> guard(lock);
-
-	auto it = inverse_map.find(any);
 	int32_t index = 0;
-	if (it == inverse_map.end())
+	bool is_new = false;
 	{
-		get_protocol()->get_wire()->send(this->rdid, [this, &index, value, any](Buffer& buffer) {
-			InternedAnySerializer::write<T>(get_serialization_context(), buffer, wrapper::get<T>(value));
-			{
-				std::lock_guard<decltype(lock)> guard(lock);
-				index = static_cast<int32_t>(my_items_lis.size()) * 2;
-				my_items_lis.emplace_back(any);
-			}
-			buffer.write_integral<int32_t>(index);
-		});
+		std::lock_guard<decltype(shard.lock)> guard(shard.lock);
+		auto it = shard.ids.find(any);
+		if (it != shard.ids.end())
+		{
+			index = it->second.id;
+			++it->second.uses;
+		}
+		else
+		{
+			index = allocate_own_id(any);
+			shard.ids.emplace(std::move(any), IndexEntry{index, 1});
+			is_new = true;
+		}
 	}
-	else
+
+	if (is_new)
 	{
-		index = it->second;
+		send_value<T>(index, value);
+		on_sent(index);
 	}
-	if (inverse_map.count(any) == 0)
+	else
 	{
-		inverse_map[any] = index;
+		wait_sent(index);
 	}
 	return index;
 }
@@ -1,5 +1,8 @@
 #include "protocol/MessageBroker.h"
 
+#include "util/instrumentation.h"
+#include "util/logging.h"
+
 #include "spdlog/sinks/stdout_color_sinks.h"
 
 namespace rd
@@ -7,21 +10,31 @@ namespace rd
 std::shared_ptr<spdlog::logger> MessageBroker::logger =
 	spdlog::stderr_color_mt<spdlog::synchronous_factory>("logger", spdlog::color_mode::automatic);
 
-static void execute(const IRdReactive* that, Buffer msg)
+static void execute(const IRdReactive* that, Buffer msg, int64_t dispatched_at_ns)
 {
 	msg.read_integral<int16_t>();	   // skip context
+	if (dispatched_at_ns == 0)
+	{
+		that->on_wire_received(std::move(msg));
+		return;
+	}
+	auto& stats = instrumentation::Instrumentation::entity(that->rdid);
+	const int64_t started_at_ns = instrumentation::Instrumentation::now_ns();
 	that->on_wire_received(std::move(msg));
+	stats.queue_wait_ns.record(static_cast<uint64_t>(started_at_ns - dispatched_at_ns));
+	stats.handler_ns.record(static_cast<uint64_t>(instrumentation::Instrumentation::now_ns() - started_at_ns));
 }
 
 void MessageBroker::invoke(const IRdReactive* that, Buffer msg, bool sync) const
 {
+	const int64_t dispatched_at_ns = instrumentation::Instrumentation::is_enabled() ? instrumentation::Instrumentation::now_ns() : 0;
 	if (sync)
 	{
-		execute(that, std::move(msg));
+		execute(that, std::move(msg), dispatched_at_ns);
 	}
 	else
 	{
-		auto action = [this, that, message = std::move(msg)]() mutable {
+		auto action = [this, that, message = std::move(msg), dispatched_at_ns]() mutable {
 			bool exists_id = false;
 			{
 				std::lock_guard<decltype(lock)> guard(lock);
@@ -29,11 +42,11 @@ void MessageBroker::invoke(const IRdReactive* that, Buffer msg, bool sync) const
 			}
 			if (exists_id)
 			{
-				execute(that, std::move(message));
+				execute(that, std::move(message), dispatched_at_ns);
 			}
 			else
 			{
-				logger->trace("Disappeared Handler for Reactive entities with id: {}", to_string(that->rdid));
+				RD_LOG_TRACE(logger, "Disappeared Handler for Reactive entities with id: {}", to_string(that->rdid));
 			}
 		};
 		std::function<void()> function = util::make_shared_function(std::move(action));
@@ -84,7 +97,7 @@ void MessageBroker::dispatch(RdId id, Buffer message) const
 				}
 				else
 				{
-					logger->trace("No handler for id: {}", to_string(id));
+					RD_LOG_TRACE(logger, "No handler for id: {}", to_string(id));
 				}
 
 				if (current.default_scheduler_messages.empty())
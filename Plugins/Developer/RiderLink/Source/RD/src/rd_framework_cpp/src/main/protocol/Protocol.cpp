@@ -17,6 +17,10 @@ constexpr string_view Protocol::InternRootName;
 void Protocol::initialize() const
 {
 	internRoot = std::make_unique<InternRoot>();
+	if (internDictionary)
+	{
+		internRoot->set_dictionary(internDictionary);
+	}
 
 	context = std::make_unique<SerializationCtx>(
 		serializers.get(), SerializationCtx::roots_t{{util::getPlatformIndependentHash("Protocol"), internRoot.get()}});
@@ -48,4 +52,19 @@ SerializationCtx& Protocol::get_serialization_context() const
 	return *context;
 }
 
+void Protocol::set_intern_dictionary(std::shared_ptr<InternDictionary> value)
+{
+	RD_ASSERT_MSG(!context, "Intern dictionary must be set before the protocol is used");
+	internDictionary = std::move(value);
+}
+
+std::vector<std::wstring> Protocol::frequent_interned_strings(size_t limit) const
+{
+	if (!internRoot)
+	{
+		return {};
+	}
+	return internRoot->frequent_strings(limit);
+}
+
 }	 // namespace rd
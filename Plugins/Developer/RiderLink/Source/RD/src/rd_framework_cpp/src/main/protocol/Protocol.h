@@ -11,6 +11,8 @@
 #include "serialization/SerializationCtx.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <rd_framework_export.h>
 
@@ -21,6 +23,8 @@ namespace rd
 class SerializationCtx;
 
 class InternRoot;
+
+class InternDictionary;
 // endregion
 
 /**
@@ -36,6 +40,8 @@ class RD_FRAMEWORK_API Protocol : /*IRdDynamic, */ public IProtocol
 
 	mutable std::unique_ptr<InternRoot> internRoot;
 
+	std::shared_ptr<InternDictionary> internDictionary;
+
 	// region ctor/dtor
 private:
 	void initialize() const;
@@ -56,6 +62,17 @@ public:
 
 	SerializationCtx& get_serialization_context() const override;
 
+	/**
+	 * \brief Sets the dictionary of strings the intern root of this protocol may use once the other side agrees on it.
+	 * Must be called before the protocol is first used.
+	 */
+	void set_intern_dictionary(std::shared_ptr<InternDictionary> value);
+
+	/**
+	 * \return up to [limit] strings interned most often by this protocol, to save as the next intern dictionary.
+	 */
+	std::vector<std::wstring> frequent_interned_strings(size_t limit) const;
+
 	static std::shared_ptr<spdlog::logger> initializationLogger;
 };
 }	 // namespace rd
@@ -1,5 +1,7 @@
 #include "SingleThreadScheduler.h"
 
+#include "util/logging.h"
+
 #include <utility>
 
 #include "ctpl_stl.h"
@@ -17,7 +19,7 @@ SingleThreadScheduler::SingleThreadScheduler(Lifetime lifetime, std::string name
 		catch (std::exception const& e)
 		{
 			(void)e;
-			log->error("Failed to terminate {}", this->name);
+			RD_LOG_ERROR(log, "Failed to terminate {}", this->name);
 		}
 	});
 }
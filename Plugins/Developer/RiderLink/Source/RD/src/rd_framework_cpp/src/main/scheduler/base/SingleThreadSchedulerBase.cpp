@@ -1,35 +1,41 @@
 #include "SingleThreadSchedulerBase.h"
 
 #include "util/core_util.h"
+#include "util/logging.h"
 
 #include "ctpl_stl.h"
 #include "spdlog/include/spdlog/sinks/stdout_color_sinks.h"
 
 namespace rd
 {
-SingleThreadSchedulerBase::PoolTask::PoolTask(std::function<void()> f, SingleThreadSchedulerBase* scheduler)
-	: f(std::move(f)), scheduler(scheduler)
+SingleThreadSchedulerBase::PoolTask::PoolTask(std::function<void()> f, SingleThreadSchedulerBase* scheduler, int64_t queued_at_ns)
+	: f(std::move(f)), scheduler(scheduler), queued_at_ns(queued_at_ns)
 {
 }
 
 void SingleThreadSchedulerBase::PoolTask::operator()(int id) const
 {
+	const int64_t started_at_ns = queued_at_ns != 0 ? instrumentation::Instrumentation::now_ns() : 0;
 	try
 	{
 		f();
-		--scheduler->tasks_executing;
 	}
 	catch (std::exception const& e)
 	{
-		scheduler->log->error("Background task failed, scheduler={}, thread_id={} | {}", scheduler->name, id, e.what());
-		--scheduler->tasks_executing;
+		RD_LOG_ERROR(scheduler->log, "Background task failed, scheduler={}, thread_id={} | {}", scheduler->name, id, e.what());
 	}
+	if (queued_at_ns != 0)
+	{
+		scheduler->stats->on_executed(queued_at_ns, started_at_ns, instrumentation::Instrumentation::now_ns());
+	}
+	--scheduler->tasks_executing;
 }
 
 SingleThreadSchedulerBase::SingleThreadSchedulerBase(std::string name)
 	: log(spdlog::stderr_color_mt<spdlog::synchronous_factory>(name, spdlog::color_mode::automatic))
 	, name(std::move(name))
 	, pool(std::make_unique<ctpl::thread_pool>(1))
+	, stats(&instrumentation::Instrumentation::scheduler(this->name))
 {
 	RD_ASSERT_THROW_MSG(pool->size() == 1, "Thread pool wasn't properly initalized");
 	thread_id = pool->get_thread(0).get_id();
@@ -48,7 +54,13 @@ void SingleThreadSchedulerBase::flush()
 void SingleThreadSchedulerBase::queue(std::function<void()> action)
 {
 	++tasks_executing;
-	PoolTask task(action, this);
+	int64_t queued_at_ns = 0;
+	if (instrumentation::Instrumentation::is_enabled())
+	{
+		stats->on_queued();
+		queued_at_ns = instrumentation::Instrumentation::now_ns();
+	}
+	PoolTask task(action, this, queued_at_ns);
 	pool->push(std::move(task));
 }
 
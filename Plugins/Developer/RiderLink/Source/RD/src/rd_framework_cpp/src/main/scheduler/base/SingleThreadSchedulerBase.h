@@ -8,6 +8,7 @@
 
 #include "scheduler/base/IScheduler.h"
 #include "lifetime/Lifetime.h"
+#include "util/instrumentation.h"
 #include "spdlog/spdlog.h"
 
 #include <utility>
@@ -30,14 +31,16 @@ protected:
 	std::atomic_uint32_t tasks_executing{0};
 	std::atomic_uint32_t active{0};
 	std::unique_ptr<ctpl::thread_pool> pool;
+	instrumentation::SchedulerStats* stats;
 
 	class PoolTask
 	{
 		std::function<void()> f;
 		SingleThreadSchedulerBase* scheduler;
+		int64_t queued_at_ns;	 // 0 when instrumentation was disabled at the moment of queueing
 
 	public:
-		explicit PoolTask(std::function<void()> f, SingleThreadSchedulerBase* scheduler);
+		explicit PoolTask(std::function<void()> f, SingleThreadSchedulerBase* scheduler, int64_t queued_at_ns);
 
 		void operator()(int id) const;
 	};
@@ -0,0 +1,113 @@
+#ifndef RD_CPP_DELTA_H
+#define RD_CPP_DELTA_H
+
+#include "protocol/Buffer.h"
+#include "serialization/SerializationCtx.h"
+#include "util/core_traits.h"
+#include "util/core_util.h"
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace rd
+{
+namespace util
+{
+template <typename T, typename = void>
+struct has_delta : std::false_type
+{
+};
+
+/**
+ * \brief Whether T can be sent as a difference from a previous value: it has
+ * \code void write_diff(SerializationCtx&, Buffer&, T const& base) const \endcode which writes what differs from
+ * [base], and \code void patch(SerializationCtx&, Buffer&) \endcode which applies such a difference in place.
+ */
+template <typename T>
+struct has_delta<T,
+	void_t<decltype(std::declval<T const&>().write_diff(
+			   std::declval<SerializationCtx&>(), std::declval<Buffer&>(), std::declval<T const&>())),
+		decltype(std::declval<T&>().patch(std::declval<SerializationCtx&>(), std::declval<Buffer&>()))>> : std::true_type
+{
+};
+
+template <typename T>
+/*inline */ constexpr bool has_delta_v = has_delta<T>::value;
+}	 // namespace util
+
+/**
+ * \brief Writes a difference as a bitmap of the changed fields followed by their values, for up to 64 fields.
+ *
+ * Fields are visited in declaration order, and the same order must be used by the [DeltaReader] in \a patch.
+ */
+class DeltaWriter
+{
+	Buffer& buffer;
+	size_t mask_position;
+	uint64_t mask = 0;
+	uint32_t index = 0;
+
+public:
+	explicit DeltaWriter(Buffer& buffer) : buffer(buffer), mask_position(buffer.get_position())
+	{
+		buffer.write_integral<uint64_t>(0);
+	}
+
+	DeltaWriter(DeltaWriter const&) = delete;
+
+	DeltaWriter& operator=(DeltaWriter const&) = delete;
+
+	~DeltaWriter()
+	{
+		const size_t end = buffer.get_position();
+		buffer.set_position(mask_position);
+		buffer.write_integral<uint64_t>(mask);
+		buffer.set_position(end);
+	}
+
+	/**
+	 * \brief Writes [value] with [write] unless it equals [base].
+	 */
+	template <typename V, typename F>
+	void field(V const& value, V const& base, F&& write)
+	{
+		RD_ASSERT_MSG(index < 64, "DeltaWriter supports at most 64 fields");
+		if (!(value == base))
+		{
+			mask |= uint64_t(1) << index;
+			write(value);
+		}
+		++index;
+	}
+};
+
+/**
+ * \brief Reads a difference written by [DeltaWriter].
+ */
+class DeltaReader
+{
+	uint64_t mask;
+	uint32_t index = 0;
+
+public:
+	explicit DeltaReader(Buffer& buffer) : mask(buffer.read_integral<uint64_t>())
+	{
+	}
+
+	/**
+	 * \brief Calls [read] if the next field was written.
+	 */
+	template <typename F>
+	void field(F&& read)
+	{
+		if ((mask >> index) & 1)
+		{
+			read();
+		}
+		++index;
+	}
+};
+}	 // namespace rd
+
+#endif	  // RD_CPP_DELTA_H
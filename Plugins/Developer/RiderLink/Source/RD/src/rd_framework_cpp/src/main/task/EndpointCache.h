@@ -0,0 +1,145 @@
+#ifndef RD_CPP_ENDPOINTCACHE_H
+#define RD_CPP_ENDPOINTCACHE_H
+
+#include "protocol/Buffer.h"
+#include "util/hashing.h"
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace rd
+{
+/**
+ * \brief Responses of an [RdEndpoint] to requests it has already served, keyed by the serialized request.
+ *
+ * Holds at most \a capacity entries, dropping the least recently used one, and forgets an entry once it is older than
+ * \a ttl unless that is zero. Thread safe: looked up on the wire thread, filled on the protocol thread.
+ */
+class EndpointCache
+{
+public:
+	using ByteArray = Buffer::ByteArray;
+	using clock = std::chrono::steady_clock;
+
+private:
+	struct Entry
+	{
+		ByteArray request;
+		std::shared_ptr<const ByteArray> response;
+		clock::time_point stored_at;
+	};
+
+	struct RequestHash
+	{
+		size_t operator()(ByteArray const* request) const
+		{
+			uint64_t hash = util::DEFAULT_HASH;
+			for (auto byte : *request)
+			{
+				hash = hash * util::HASH_FACTOR + byte;
+			}
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	struct RequestEqual
+	{
+		bool operator()(ByteArray const* lhs, ByteArray const* rhs) const
+		{
+			return *lhs == *rhs;
+		}
+	};
+
+	std::mutex lock;
+	// most recently used first
+	std::list<Entry> entries;
+	std::unordered_map<ByteArray const*, std::list<Entry>::iterator, RequestHash, RequestEqual> index;
+	size_t capacity;
+	clock::duration ttl;
+	uint64_t generation = 0;
+
+public:
+	// region ctor/dtor
+
+	EndpointCache(size_t capacity, clock::duration ttl) : capacity(capacity), ttl(ttl)
+	{
+	}
+
+	EndpointCache(EndpointCache const&) = delete;
+
+	EndpointCache& operator=(EndpointCache const&) = delete;
+	// endregion
+
+	/**
+	 * \return the serialized response stored for [request], or nullptr.
+	 */
+	std::shared_ptr<const ByteArray> find(ByteArray const& request)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = index.find(&request);
+		if (it == index.end())
+		{
+			return nullptr;
+		}
+		if (ttl != clock::duration::zero() && clock::now() - it->second->stored_at >= ttl)
+		{
+			entries.erase(it->second);
+			index.erase(it);
+			return nullptr;
+		}
+		entries.splice(entries.begin(), entries, it->second);
+		return it->second->response;
+	}
+
+	/**
+	 * \brief Changes with every [invalidate], a response computed before that is not stored.
+	 */
+	uint64_t get_generation()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return generation;
+	}
+
+	void put(ByteArray request, std::shared_ptr<const ByteArray> response, uint64_t request_generation)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (request_generation != generation || capacity == 0)
+		{
+			return;
+		}
+		auto stored = std::move(response);
+		auto it = index.find(&request);
+		if (it != index.end())
+		{
+			it->second->response = std::move(stored);
+			it->second->stored_at = clock::now();
+			entries.splice(entries.begin(), entries, it->second);
+			return;
+		}
+		entries.push_front(Entry{std::move(request), std::move(stored), clock::now()});
+		index.emplace(&entries.front().request, entries.begin());
+		while (entries.size() > capacity)
+		{
+			index.erase(&entries.back().request);
+			entries.pop_back();
+		}
+	}
+
+	/**
+	 * \brief Forgets all responses, e.g. when the data the handler reads has changed.
+	 */
+	void invalidate()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		++generation;
+		index.clear();
+		entries.clear();
+	}
+};
+}	 // namespace rd
+
+#endif	  // RD_CPP_ENDPOINTCACHE_H
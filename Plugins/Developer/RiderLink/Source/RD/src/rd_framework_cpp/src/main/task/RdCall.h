@@ -6,8 +6,11 @@
 #include "RdTaskResult.h"
 #include "scheduler/SynchronousScheduler.h"
 #include "WiredRdTask.h"
+#include "WiredRdBatchImpl.h"
 
-#include <thread>
+#include <chrono>
+#include <memory>
+#include <vector>
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -30,8 +33,6 @@ class RdCall : public virtual RdReactiveBase, public ISerializable
 	using WTReq = value_or_wrapper<TReq>;
 	using WTRes = value_or_wrapper<TRes>;
 
-	mutable optional<RdId> sync_task_id;
-
 public:
 	// region ctor/dtor
 	RdCall() = default;
@@ -65,23 +66,25 @@ public:
 
 	/**
 	 * \brief Invokes the API with the parameters given as [request] and waits for the result.
+	 * Any number of threads may wait on the same call simultaneously, each on its own task.
 	 *
 	 * \param request value to deliver
+	 * \param timeout after which the task is completed with TimedOut state and returned, nothing is thrown
 	 * \return result of remote invoking
+	 * \throw std::runtime_error if the remote handler faulted, std::invalid_argument if the task was cancelled
 	 */
 	WiredRdTask<TRes, ResSer> sync(TReq const& request, std::chrono::milliseconds timeout = 200ms) const
 	{
+		auto const time_at_start = std::chrono::steady_clock::now();
 		auto task = start_internal(request, true, &SynchronousScheduler::Instance());
-		auto time_at_start = std::chrono::system_clock::now();
-		while (!task.has_value() && !(*bind_lifetime)->is_terminated() &&
-			   ((std::chrono::system_clock::now() - time_at_start) < timeout))
+		task.wait(timeout);
+		RD_LOG_DEBUG(spdlog::default_logger_raw(), "Time elapsed: {}, timed_out={}",
+			to_string(std::chrono::steady_clock::now() - time_at_start),
+			to_string(task.is_timed_out()));
+		if (task.is_faulted() || task.is_canceled())
 		{
-			std::this_thread::yield();
+			task.value_or_throw().unwrap();
 		}
-		spdlog::debug("Time elapsed: {}, has_value={}", to_string(std::chrono::system_clock::now() - time_at_start),
-			to_string(task.has_value()));
-		task.value_or_throw().unwrap();	   // check for existing value
-		sync_task_id = nullopt;
 		return task;
 	}
 
@@ -102,6 +105,47 @@ public:
 		return start_internal(request, false, responseScheduler ? responseScheduler : get_default_scheduler());
 	}
 
+	/**
+	 * \brief Asynchronously invokes the API for every element of [requests] at once. Requests travel as one message and
+	 * responses come back as one message; the remote endpoint must be RdEndpoint which serves batches.
+	 *
+	 * \param requests values of requests
+	 * \param responseScheduler to assign values
+	 * \return tasks which will have result values, in the order of [requests]
+	 */
+	std::vector<RdTask<TRes, ResSer>> start_batch(std::vector<TReq> const& requests, IScheduler* responseScheduler = nullptr) const
+	{
+		assert_bound();
+		if (!async)
+		{
+			assert_threading();
+		}
+
+		std::vector<RdTask<TRes, ResSer>> tasks(requests.size());
+		if (requests.empty())
+		{
+			return tasks;
+		}
+
+		RdId task_id = get_protocol()->get_identity()->next(rdid);
+		auto batch = std::make_shared<detail::WiredRdBatchImpl<TRes, ResSer>>(
+			*bind_lifetime, *this, task_id, responseScheduler ? responseScheduler : get_default_scheduler(), tasks);
+		detail::WiredRdBatchImpl<TRes, ResSer>::advise(batch);
+
+		get_wire()->send(rdid.mix("batch"), [&](Buffer& buffer) {
+			RD_LOG_TRACE(logSend, "call {}::{} send batch request {} of {} items", to_string(location), to_string(rdid),
+				to_string(task_id), requests.size());
+			task_id.write(buffer);
+			buffer.write_integral<int32_t>(static_cast<int32_t>(requests.size()));
+			for (auto const& request : requests)
+			{
+				ReqSer::write(get_serialization_context(), buffer, request);
+			}
+		});
+
+		return tasks;
+	}
+
 	void on_wire_received(Buffer buffer) const override
 	{
 		RD_ASSERT_MSG(false, "RdCall.on_wire_received called")
@@ -119,18 +163,8 @@ private:
 		RdId task_id = get_protocol()->get_identity()->next(rdid);
 		WiredRdTask<TRes, ResSer> task{*bind_lifetime, *this, task_id, scheduler};
 
-		if (sync)
-		{
-			if (sync_task_id.has_value())
-			{
-				throw std::invalid_argument(
-					"Already exists sync task for call " + to_string(location) + ", taskId = " + rd::to_string(*sync_task_id));
-			}
-			sync_task_id = task_id;
-		}
-
 		get_wire()->send(rdid, [&](Buffer& buffer) {
-			spdlog::get("logSend")->trace("call {}::{} send {} request {} : {}", to_string(location), to_string(rdid), (sync ? "SYNC" : "ASYNC"),
+			RD_LOG_TRACE(logSend, "call {}::{} send {} request {} : {}", to_string(location), to_string(rdid), (sync ? "SYNC" : "ASYNC"),
 				to_string(task_id), to_string(request));
 			task_id.write(buffer);
 			ReqSer::write(get_serialization_context(), buffer, request);
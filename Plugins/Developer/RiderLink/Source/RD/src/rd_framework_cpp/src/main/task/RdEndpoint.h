@@ -3,6 +3,18 @@
 
 #include "serialization/Polymorphic.h"
 #include "RdTask.h"
+#include "EndpointCache.h"
+#include "base/RdReactiveBase.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "scheduler/SynchronousScheduler.h"
+#include "util/shared_function.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -11,6 +23,73 @@
 
 namespace rd
 {
+namespace detail
+{
+/**
+ * \brief Request received by RdEndpoint. It listens to the task id on the wire:
+ * the caller sends a message there when the request is cancelled on its side.
+ */
+template <typename TValue>
+class EndpointRequest final : public RdReactiveBase
+{
+public:
+	mutable LifetimeDefinition definition;
+	TValue value;
+	IScheduler* scheduler{};
+	std::atomic<bool> responded{false};
+	bool started{false};
+	// set when the response goes to the endpoint cache under the serialized request
+	bool cacheable{false};
+	Buffer::ByteArray cache_key;
+	uint64_t cache_generation{0};
+
+	EndpointRequest(Lifetime const& parent, RdId task_id, TValue value, IScheduler* scheduler)
+		: definition(parent), value(std::move(value)), scheduler(scheduler)
+	{
+		this->rdid = std::move(task_id);
+	}
+
+	IScheduler* get_wire_scheduler() const override
+	{
+		return scheduler;
+	}
+
+	void on_wire_received(Buffer /*buffer*/) const override
+	{
+		// cancellation is the only message expected from the caller
+		RD_LOG_TRACE(logReceived, "endpoint request {} cancelled by caller", to_string(rdid));
+		definition.terminate();
+	}
+};
+
+/**
+ * \brief Receives batched requests of RdEndpoint, they are addressed to a separate id so that a remote endpoint
+ * unaware of batches never mistakes them for a single request.
+ */
+class EndpointBatchReceiver final : public RdReactiveBase
+{
+	std::function<void(Buffer)> handler;
+	IScheduler* scheduler{};
+
+public:
+	EndpointBatchReceiver(RdId id, IScheduler* scheduler, std::function<void(Buffer)> handler)
+		: handler(std::move(handler)), scheduler(scheduler)
+	{
+		this->rdid = std::move(id);
+	}
+
+	IScheduler* get_wire_scheduler() const override
+	{
+		return scheduler;
+	}
+
+	void on_wire_received(Buffer buffer) const override
+	{
+		handler(std::move(buffer));
+	}
+};
+}	 // namespace detail
+
 /**
  * \brief An API that is exposed to the remote process and can be invoked over the protocol.
  *
@@ -25,10 +104,40 @@ class RdEndpoint : public virtual RdReactiveBase, public ISerializable
 	using WTReq = value_or_wrapper<TReq>;
 	using WTRes = value_or_wrapper<TRes>;
 
+	/**
+	 * \brief Handler receives the lifetime of the request, which acts as its cancellation token:
+	 * it is terminated when the caller cancels the request, when the endpoint is unbound or when the response is sent.
+	 */
 	using handler_t = std::function<RdTask<TRes, ResSer>(Lifetime, TReq const&)>;
 	mutable handler_t local_handler;
 
-	mutable tsl::ordered_map<RdId, RdTask<TRes, ResSer>, rd::hash<RdId>> awaiting_tasks;	// TO-DO get rid of it
+	/**
+	 * \brief Handler of a whole batch sent by RdCall::start_batch, returns results in the order of requests.
+	 */
+	using batch_handler_t = std::function<std::vector<TRes>(Lifetime, std::vector<TReq> const&)>;
+	mutable batch_handler_t local_batch_handler;
+
+	using request_t = detail::EndpointRequest<WTReq>;
+	using batch_request_t = detail::EndpointRequest<std::vector<TReq>>;
+	using batch_result_t = std::vector<RdTaskResult<TRes, ResSer>>;
+
+	mutable std::unique_ptr<detail::EndpointBatchReceiver> batch_receiver;
+
+	mutable std::unique_ptr<std::mutex> requests_lock{std::make_unique<std::mutex>()};
+	mutable tsl::ordered_map<RdId, std::shared_ptr<request_t>, rd::hash<RdId>> awaiting_tasks;
+	mutable std::deque<std::shared_ptr<request_t>> queued_requests;
+	mutable int32_t running_requests = 0;
+	mutable int32_t max_concurrency = 0;
+
+	// kept on the heap like requests_lock, so that the endpoint stays movable
+	struct CacheSlot
+	{
+		std::unique_ptr<EndpointCache> storage;
+		// read on the wire thread, so it may be enabled while the endpoint is bound
+		std::atomic<EndpointCache*> current{nullptr};
+	};
+	mutable std::unique_ptr<CacheSlot> cache{std::make_unique<CacheSlot>()};
+
 public:
 	// region ctor/dtor
 
@@ -87,38 +196,343 @@ public:
 		};
 	}
 
+	/**
+	 * \brief Assigns a handler that executes a batch of requests at once.
+	 * Without it a batch is served by calling the single request handler for every element.
+	 * \param handler to assign
+	 */
+	void set_batch(batch_handler_t handler) const
+	{
+		local_batch_handler = std::move(handler);
+	}
+
+	/**
+	 * \brief Limits the number of requests executed simultaneously, the rest wait in FIFO order. Batches are not limited.
+	 * \param value maximum number of running requests, 0 means no limit
+	 */
+	void set_max_concurrency(int32_t value) const
+	{
+		std::lock_guard<std::mutex> guard(*requests_lock);
+		max_concurrency = value;
+	}
+
+	/**
+	 * \brief Answers a request that was served before with the stored response, right on the wire thread and without
+	 * calling the handler. Only for handlers whose result depends on nothing but the request, until [invalidate_cache].
+	 * Faults and cancellations are not stored, and batches are always passed to the handlers.
+	 * May be called once, also while the endpoint is bound.
+	 * \param capacity maximum number of stored responses, the least recently used are dropped
+	 * \param ttl maximum age of a stored response, zero means no limit
+	 */
+	void enable_cache(size_t capacity, std::chrono::milliseconds ttl = std::chrono::milliseconds::zero()) const
+	{
+		RD_ASSERT_MSG(!cache->current.load(), "cache is enabled already");
+		cache->storage = std::make_unique<EndpointCache>(capacity, ttl);
+		cache->current.store(cache->storage.get());
+	}
+
+	/**
+	 * \brief Forgets the stored responses, to be called when the data the handler reads changes.
+	 */
+	void invalidate_cache() const
+	{
+		if (auto* current = cache->current.load())
+		{
+			current->invalidate();
+		}
+	}
+
+	/**
+	 * \return number of requests which are running or waiting for a free slot
+	 */
+	size_t get_awaiting_count() const
+	{
+		std::lock_guard<std::mutex> guard(*requests_lock);
+		return awaiting_tasks.size();
+	}
+
 	void init(Lifetime lifetime) const override
 	{
 		RdReactiveBase::init(lifetime);
 		bind_lifetime = lifetime;
 		get_wire()->advise(lifetime, this);
+		batch_receiver = std::make_unique<detail::EndpointBatchReceiver>(
+			rdid.mix("batch"), get_default_scheduler(), [this](Buffer buffer) { on_batch_received(std::move(buffer)); });
+		get_wire()->advise(lifetime, batch_receiver.get());
+	}
+
+	/**
+	 * \brief With the cache enabled requests are received on the wire thread, to answer the cached ones from there.
+	 */
+	IScheduler* get_wire_scheduler() const override
+	{
+		return cache->current.load() ? &SynchronousScheduler::Instance() : RdReactiveBase::get_wire_scheduler();
 	}
 
 	void on_wire_received(Buffer buffer) const override
 	{
 		auto task_id = RdId::read(buffer);
+		const size_t start = buffer.get_position();
 		auto value = ReqSer::read(get_serialization_context(), buffer);
-		spdlog::get("logReceived")->trace("endpoint {}::{} request = {}", to_string(location), to_string(rdid), to_string(value));
+		auto* current = cache->current.load();
+		if (!current)
+		{
+			receive(task_id, std::move(value), false, {}, 0);
+			return;
+		}
+
+		Buffer::ByteArray key(buffer.data() + start, buffer.data() + buffer.get_position());
+		if (auto response = current->find(key))
+		{
+			if (!(*bind_lifetime)->is_terminated())
+			{
+				RD_LOG_TRACE(logSend, "endpoint {}::{} cached response", to_string(location), to_string(rdid));
+				get_wire()->send(task_id, [&](Buffer& inner_buffer) { inner_buffer.write_byte_array_raw(*response); });
+			}
+			return;
+		}
+		auto action = [this, task_id, value = std::move(value), key = std::move(key),
+						  generation = current->get_generation()]() mutable {
+			if (!(*bind_lifetime)->is_terminated())
+			{
+				receive(task_id, std::move(value), true, std::move(key), generation);
+			}
+		};
+		get_default_scheduler()->queue(util::make_shared_function(std::move(action)));
+	}
+
+private:
+	void receive(RdId const& task_id, WTReq value, bool cacheable, Buffer::ByteArray cache_key, uint64_t cache_generation) const
+	{
+		RD_LOG_TRACE(logReceived, "endpoint {}::{} request = {}", to_string(location), to_string(rdid), to_string(value));
 		if (!local_handler)
 		{
 			throw std::invalid_argument("handler is empty for RdEndPoint");
 		}
-		auto task = awaiting_tasks[task_id] = {};
+		auto request = std::make_shared<request_t>(*bind_lifetime, task_id, std::move(value), get_default_scheduler());
+		request->cacheable = cacheable;
+		request->cache_key = std::move(cache_key);
+		request->cache_generation = cache_generation;
+		Lifetime const& request_lifetime = request->definition.lifetime;
+		get_wire()->advise(request_lifetime, request.get());
+		request_lifetime->add_action(
+			[this, request]() { complete(request, RdTaskResult<TRes, ResSer>(typename RdTaskResult<TRes, ResSer>::Cancelled{})); });
+
+		bool start_now = false;
+		{
+			std::lock_guard<std::mutex> guard(*requests_lock);
+			awaiting_tasks[task_id] = request;
+			start_now = max_concurrency <= 0 || running_requests < max_concurrency;
+			if (start_now)
+			{
+				++running_requests;
+				request->started = true;
+			}
+			else
+			{
+				queued_requests.push_back(request);
+			}
+		}
+		if (start_now)
+		{
+			start(request);
+		}
+	}
+
+	void start(std::shared_ptr<request_t> const& request) const
+	{
+		Lifetime const& request_lifetime = request->definition.lifetime;
+		RdTask<TRes, ResSer> task;
 		try
 		{
-			task = local_handler(*bind_lifetime, wrapper::get<TReq>(value));
+			task = local_handler(request_lifetime, wrapper::get<TReq>(request->value));
 		}
 		catch (std::exception const& e)
 		{
 			task.fault(e);
 		}
-		task.advise(*bind_lifetime, [this, task_id, &task](RdTaskResult<TRes, ResSer> const& task_result) {
-			spdlog::get("logSend")->trace("endpoint {}::{} response = {}", to_string(location), to_string(rdid), to_string(*task.result));
-			get_wire()->send(task_id, [&](Buffer& inner_buffer) { task_result.write(get_serialization_context(), inner_buffer); });
-			// TO-DO remove from awaiting_tasks
+		task.advise(request_lifetime, [this, request](RdTaskResult<TRes, ResSer> const& task_result) { complete(request, task_result); });
+	}
+
+	void complete(std::shared_ptr<request_t> const& request, RdTaskResult<TRes, ResSer> const& task_result) const
+	{
+		if (request->responded.exchange(true))
+		{
+			return;
+		}
+		if (!(*bind_lifetime)->is_terminated())
+		{
+			RD_LOG_TRACE(logSend, "endpoint {}::{} response = {}", to_string(location), to_string(rdid), to_string(task_result));
+			if (request->cacheable && task_result.is_succeeded())
+			{
+				// stored before it is sent, so that a repeated request that follows the response finds it
+				Buffer response;
+				task_result.write(get_serialization_context(), response);
+				auto bytes = std::make_shared<const Buffer::ByteArray>(std::move(response).getRealArray());
+				cache->current.load()->put(std::move(request->cache_key), bytes, request->cache_generation);
+				get_wire()->send(request->rdid, [&](Buffer& inner_buffer) { inner_buffer.write_byte_array_raw(*bytes); });
+			}
+			else
+			{
+				get_wire()->send(request->rdid, [&](Buffer& inner_buffer) { task_result.write(get_serialization_context(), inner_buffer); });
+			}
+		}
+
+		bool was_running = false;
+		{
+			std::lock_guard<std::mutex> guard(*requests_lock);
+			awaiting_tasks.erase(request->rdid);
+			was_running = request->started;
+			if (was_running)
+			{
+				--running_requests;
+			}
+			else
+			{
+				queued_requests.erase(std::find(queued_requests.begin(), queued_requests.end(), request));
+			}
+		}
+		if (!request->definition.is_terminated())
+		{
+			request->definition.terminate();
+		}
+		if (was_running)
+		{
+			start_queued();
+		}
+	}
+
+	void on_batch_received(Buffer buffer) const
+	{
+		auto task_id = RdId::read(buffer);
+		const int32_t count = buffer.read_integral<int32_t>();
+		std::vector<TReq> values;
+		values.reserve(count);
+		for (int32_t i = 0; i < count; ++i)
+		{
+			values.push_back(wrapper::get<TReq>(ReqSer::read(get_serialization_context(), buffer)));
+		}
+		RD_LOG_TRACE(logReceived, "endpoint {}::{} batch request of {} items", to_string(location), to_string(rdid), count);
+		if (!local_handler && !local_batch_handler)
+		{
+			throw std::invalid_argument("handler is empty for RdEndPoint");
+		}
+
+		auto request = std::make_shared<batch_request_t>(*bind_lifetime, task_id, std::move(values), get_default_scheduler());
+		Lifetime const& request_lifetime = request->definition.lifetime;
+		get_wire()->advise(request_lifetime, request.get());
+		request_lifetime->add_action([this, request]() {
+			complete_batch(request,
+				batch_result_t(request->value.size(), RdTaskResult<TRes, ResSer>(typename RdTaskResult<TRes, ResSer>::Cancelled{})));
 		});
+
+		if (local_batch_handler)
+		{
+			batch_result_t results;
+			results.reserve(request->value.size());
+			try
+			{
+				auto values = local_batch_handler(request_lifetime, request->value);
+				RD_ASSERT_THROW_MSG(values.size() == request->value.size(), "batch handler returned wrong number of results");
+				// values may be std::vector<bool>, whose elements are proxies
+				for (auto&& value : values)
+				{
+					results.emplace_back(typename RdTaskResult<TRes, ResSer>::Success(WTRes(std::move(value))));
+				}
+			}
+			catch (std::exception const& e)
+			{
+				results = batch_result_t(request->value.size(), RdTaskResult<TRes, ResSer>(typename RdTaskResult<TRes, ResSer>::Fault(e)));
+			}
+			complete_batch(request, std::move(results));
+			return;
+		}
+
+		struct Join
+		{
+			std::mutex lock;
+			std::vector<optional<RdTaskResult<TRes, ResSer>>> results;
+			size_t remaining;
+
+			explicit Join(size_t count) : results(count), remaining(count)
+			{
+			}
+		};
+		auto join = std::make_shared<Join>(request->value.size());
+		for (size_t i = 0; i < request->value.size(); ++i)
+		{
+			RdTask<TRes, ResSer> task;
+			try
+			{
+				task = local_handler(request_lifetime, request->value[i]);
+			}
+			catch (std::exception const& e)
+			{
+				task.fault(e);
+			}
+			task.advise(request_lifetime, [this, request, join, i](RdTaskResult<TRes, ResSer> const& task_result) {
+				{
+					std::lock_guard<std::mutex> guard(join->lock);
+					join->results[i].emplace(task_result);
+					if (--join->remaining > 0)
+					{
+						return;
+					}
+				}
+				batch_result_t results;
+				results.reserve(join->results.size());
+				for (auto& result : join->results)
+				{
+					results.push_back(std::move(*result));
+				}
+				complete_batch(request, std::move(results));
+			});
+		}
 	}
 
+	void complete_batch(std::shared_ptr<batch_request_t> const& request, batch_result_t results) const
+	{
+		if (request->responded.exchange(true))
+		{
+			return;
+		}
+		if (!(*bind_lifetime)->is_terminated())
+		{
+			RD_LOG_TRACE(logSend, 
+				"endpoint {}::{} batch response of {} items", to_string(location), to_string(rdid), results.size());
+			get_wire()->send(request->rdid, [&](Buffer& inner_buffer) {
+				inner_buffer.write_integral<int32_t>(static_cast<int32_t>(results.size()));
+				for (auto const& result : results)
+				{
+					result.write(get_serialization_context(), inner_buffer);
+				}
+			});
+		}
+		if (!request->definition.is_terminated())
+		{
+			request->definition.terminate();
+		}
+	}
+
+	void start_queued() const
+	{
+		std::shared_ptr<request_t> next;
+		{
+			std::lock_guard<std::mutex> guard(*requests_lock);
+			if (queued_requests.empty() || (max_concurrency > 0 && running_requests >= max_concurrency))
+			{
+				return;
+			}
+			next = std::move(queued_requests.front());
+			queued_requests.pop_front();
+			++running_requests;
+			next->started = true;
+		}
+		// handlers are executed on the protocol thread, the slot may have been freed on any thread
+		get_default_scheduler()->invoke_or_queue([this, next]() { start(next); });
+	}
+
+public:
 	friend bool operator==(const RdEndpoint& lhs, const RdEndpoint& rhs)
 	{
 		return &lhs == &rhs;
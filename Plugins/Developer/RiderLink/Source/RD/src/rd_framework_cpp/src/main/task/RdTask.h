@@ -24,8 +24,6 @@ protected:
 
 	mutable std::shared_ptr<detail::RdTaskImpl<T, S>> impl{std::make_shared<detail::RdTaskImpl<T, S>>()};
 
-	Property<RdTaskResult<T, S>>* result{&impl->result};
-
 public:
 	using result_type = RdTaskResult<T, S>;
 
@@ -53,30 +51,31 @@ public:
 		return res;
 	}
 
+	// a task is completed once, results set after the first one are dropped
+
 	void set(WT value) const
 	{
-		typename TRes::Success t(std::move(value));
-		impl->result.set(std::move(t));
+		impl->complete(TRes(typename TRes::Success(std::move(value))));
 	}
 
 	void set_result(TRes value) const
 	{
-		impl->result.set(std::move(value));
+		impl->complete(std::move(value));
 	}
 
 	void set_result_if_empty(TRes value) const
 	{
-		impl->result.set_if_empty(std::move(value));
+		impl->complete(std::move(value));
 	}
 
 	void cancel() const
 	{
-		impl->result.set(typename TRes::Cancelled());
+		impl->complete(TRes(typename TRes::Cancelled()));
 	}
 
 	void fault(std::exception const& e) const
 	{
-		impl->result.set(typename TRes::Fault(e));
+		impl->complete(TRes(typename TRes::Fault(e)));
 	}
 
 	bool has_value() const
@@ -111,6 +110,11 @@ public:
 		return has_value() && value_or_throw().is_faulted();	// TO-DO atomic
 	}
 
+	bool is_timed_out() const
+	{
+		return has_value() && value_or_throw().is_timed_out();
+	}
+
 	void advise(Lifetime lifetime, std::function<void(TRes const&)> handler) const
 	{
 		impl->result.advise(lifetime, [handler = std::move(handler)](optional<TRes> const& opt_value) {
@@ -0,0 +1,351 @@
+#ifndef RD_CPP_RDTASKAWAIT_H
+#define RD_CPP_RDTASKAWAIT_H
+
+#include "RdTask.h"
+#include "RdTaskResult.h"
+#include "RdCall.h"
+#include "serialization/SerializationCtx.h"
+#include "scheduler/base/IScheduler.h"
+
+#include "lifetime/LifetimeDefinition.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define RD_HAS_COROUTINES 1
+#endif
+#endif
+
+#ifndef RD_HAS_COROUTINES
+#define RD_HAS_COROUTINES 0
+#endif
+
+namespace rd
+{
+namespace detail
+{
+/**
+ * \brief "SerDes" for the vector of values produced by when_all, elements are written by [S].
+ */
+template <typename S, typename T>
+class WhenAllSerializer
+{
+public:
+	static std::vector<value_or_wrapper<T>> read(SerializationCtx& ctx, Buffer& buffer)
+	{
+		const int32_t len = buffer.read_integral<int32_t>();
+		std::vector<value_or_wrapper<T>> result;
+		result.reserve(len);
+		for (int32_t i = 0; i < len; ++i)
+		{
+			result.emplace_back(S::read(ctx, buffer));
+		}
+		return result;
+	}
+
+	static void write(SerializationCtx& ctx, Buffer& buffer, std::vector<value_or_wrapper<T>> const& value)
+	{
+		buffer.write_integral<int32_t>(static_cast<int32_t>(value.size()));
+		for (auto const& item : value)
+		{
+			S::write(ctx, buffer, wrapper::get<T>(item));
+		}
+	}
+};
+}	 // namespace detail
+
+/**
+ * \brief Subscribes [handler] to the result of [task] without blocking the calling thread.
+ * The handler is called exactly once: with the task result, or with Cancelled if [lifetime] terminates first.
+ *
+ * \tparam TTask RdTask or WiredRdTask, a copy is kept alive until the handler is called
+ * \param lifetime lifetime of subscription, its termination is delivered as cancellation
+ * \param scheduler to invoke handler on, nullptr means the thread that produced the result
+ * \param handler to be called with the result
+ */
+template <typename TTask, typename F>
+void advise_result(TTask task, Lifetime lifetime, IScheduler* scheduler, F&& handler)
+{
+	using TRes = typename TTask::result_type;
+
+	struct State
+	{
+		std::atomic<bool> done{false};
+		LifetimeDefinition definition;
+		TTask task;
+		std::function<void(TRes const&)> handler;
+		IScheduler* scheduler;
+
+		State(Lifetime const& lifetime, TTask task, std::function<void(TRes const&)> handler, IScheduler* scheduler)
+			: definition(lifetime), task(std::move(task)), handler(std::move(handler)), scheduler(scheduler)
+		{
+		}
+
+		static void deliver(std::shared_ptr<State> const& self, TRes result)
+		{
+			if (self->done.exchange(true))
+			{
+				return;
+			}
+			auto action = [self, result = std::move(result)]() {
+				self->handler(result);
+				self->handler = nullptr;
+			};
+			if (self->scheduler != nullptr)
+			{
+				self->scheduler->invoke_or_queue(util::make_shared_function(std::move(action)));
+			}
+			else
+			{
+				action();
+			}
+		}
+	};
+
+	auto state = std::make_shared<State>(lifetime, std::move(task), std::forward<F>(handler), scheduler);
+	Lifetime const& subscription = state->definition.lifetime;
+	if (subscription->is_terminated())
+	{
+		State::deliver(state, typename TRes::Cancelled{});
+		return;
+	}
+	// the subscription lifetime owns the state until it is terminated, either by a result or by [lifetime]
+	subscription->add_action([state]() { State::deliver(state, typename TRes::Cancelled{}); });
+	std::weak_ptr<State> weak = state;
+	state->task.advise(subscription, [weak](TRes const& result) {
+		if (auto self = weak.lock())
+		{
+			State::deliver(self, result);
+			self->definition.terminate();
+		}
+	});
+}
+
+/**
+ * \brief Joins [tasks] into a single task which completes when every task has completed.
+ * Succeeds with the values in the order of [tasks]; the first cancelled, faulted or timed out task completes it with that state.
+ * No thread is blocked while waiting.
+ *
+ * \param lifetime termination cancels the joined task
+ * \param tasks to join
+ * \param scheduler to complete the joined task on, nullptr means the thread that produced the last result
+ */
+template <typename T, typename S, template <class, class> class TTask>
+RdTask<std::vector<value_or_wrapper<T>>, detail::WhenAllSerializer<S, T>> when_all(
+	Lifetime lifetime, std::vector<TTask<T, S>> tasks, IScheduler* scheduler = nullptr)
+{
+	using TJoined = RdTask<std::vector<value_or_wrapper<T>>, detail::WhenAllSerializer<S, T>>;
+	using TRes = RdTaskResult<T, S>;
+
+	struct Join
+	{
+		TJoined joined;
+		std::vector<optional<value_or_wrapper<T>>> values;
+		std::atomic<size_t> remaining;
+		std::atomic<bool> completed{false};
+
+		explicit Join(size_t count) : values(count), remaining(count)
+		{
+		}
+	};
+
+	auto join = std::make_shared<Join>(tasks.size());
+	TJoined result = join->joined;
+	if (tasks.empty())
+	{
+		result.set({});
+		return result;
+	}
+
+	for (size_t i = 0; i < tasks.size(); ++i)
+	{
+		advise_result(std::move(tasks[i]), lifetime, scheduler, [join, i](TRes const& task_result) {
+			if (join->completed.load())
+			{
+				return;
+			}
+			if (task_result.is_succeeded())
+			{
+				join->values[i] = value_or_wrapper<T>(task_result.unwrap());
+				if (--join->remaining == 0 && !join->completed.exchange(true))
+				{
+					std::vector<value_or_wrapper<T>> values;
+					values.reserve(join->values.size());
+					for (auto& value : join->values)
+					{
+						values.emplace_back(std::move(*value));
+					}
+					join->joined.set(std::move(values));
+				}
+			}
+			else if (!join->completed.exchange(true))
+			{
+				if (task_result.is_canceled())
+				{
+					join->joined.cancel();
+				}
+				else if (task_result.is_timed_out())
+				{
+					join->joined.set_result(typename TJoined::result_type::TimedOut{});
+				}
+				else
+				{
+					task_result.as_faulted([&](typename TRes::Fault const& fault) {
+						join->joined.set_result(typename TJoined::result_type::Fault(
+							fault.reason_type_fqn, fault.reason_message, fault.reason_as_text));
+					});
+				}
+			}
+		});
+	}
+	return result;
+}
+
+/**
+ * \brief Starts [call] for every request in [requests] and joins the responses, @see when_all above.
+ */
+template <typename TReq, typename TRes, typename ReqSer, typename ResSer>
+RdTask<std::vector<value_or_wrapper<TRes>>, detail::WhenAllSerializer<ResSer, TRes>> when_all(Lifetime lifetime,
+	RdCall<TReq, TRes, ReqSer, ResSer> const& call, std::vector<value_or_wrapper<TReq>> const& requests,
+	IScheduler* scheduler = nullptr)
+{
+	std::vector<WiredRdTask<TRes, ResSer>> tasks;
+	tasks.reserve(requests.size());
+	for (auto const& request : requests)
+	{
+		tasks.push_back(call.start(wrapper::get<TReq>(request), scheduler));
+	}
+	return when_all(std::move(lifetime), std::move(tasks), scheduler);
+}
+
+#if RD_HAS_COROUTINES
+/**
+ * \brief Awaitable for RdTask and WiredRdTask. Resumes the coroutine with the task result on the given scheduler,
+ * termination of the given lifetime resumes it with Cancelled.
+ */
+template <typename TTask>
+class RdTaskAwaiter
+{
+	using TRes = typename TTask::result_type;
+
+	TTask task;
+	Lifetime lifetime;
+	IScheduler* scheduler;
+	optional<TRes> result;
+
+public:
+	RdTaskAwaiter(TTask task, Lifetime lifetime, IScheduler* scheduler)
+		: task(std::move(task)), lifetime(std::move(lifetime)), scheduler(scheduler)
+	{
+	}
+
+	bool await_ready() const
+	{
+		return task.has_value() && (scheduler == nullptr || scheduler->is_active());
+	}
+
+	void await_suspend(std::coroutine_handle<> handle)
+	{
+		advise_result(task, lifetime, scheduler, [this, handle](TRes const& value) {
+			result.emplace(value);
+			handle.resume();
+		});
+	}
+
+	TRes await_resume()
+	{
+		if (result.has_value())
+		{
+			return std::move(*result);
+		}
+		return task.value_or_throw();
+	}
+};
+
+/**
+ * \brief co_await-able view of [task] bound to [lifetime] and resumed on [scheduler].
+ */
+template <typename TTask>
+RdTaskAwaiter<TTask> await_on(TTask task, Lifetime lifetime, IScheduler* scheduler)
+{
+	return RdTaskAwaiter<TTask>(std::move(task), std::move(lifetime), scheduler);
+}
+
+/**
+ * \brief co_await on a task directly resumes on the thread which produced its result.
+ */
+template <typename T, typename S>
+RdTaskAwaiter<RdTask<T, S>> operator co_await(RdTask<T, S> const& task)
+{
+	return RdTaskAwaiter<RdTask<T, S>>(task, Lifetime::Eternal(), nullptr);
+}
+
+template <typename T, typename S>
+RdTaskAwaiter<WiredRdTask<T, S>> operator co_await(WiredRdTask<T, S> const& task)
+{
+	return RdTaskAwaiter<WiredRdTask<T, S>>(task, Lifetime::Eternal(), nullptr);
+}
+
+namespace detail
+{
+template <typename T, typename S>
+class RdTaskPromise
+{
+	RdTask<T, S> task;
+
+public:
+	RdTask<T, S> get_return_object() const
+	{
+		return task;
+	}
+
+	std::suspend_never initial_suspend() const noexcept
+	{
+		return {};
+	}
+
+	std::suspend_never final_suspend() const noexcept
+	{
+		return {};
+	}
+
+	void return_value(value_or_wrapper<T> value)
+	{
+		task.set(std::move(value));
+	}
+
+	void unhandled_exception()
+	{
+		try
+		{
+			throw;
+		}
+		catch (std::exception const& e)
+		{
+			task.fault(e);
+		}
+	}
+};
+}	 // namespace detail
+#endif
+}	 // namespace rd
+
+#if RD_HAS_COROUTINES
+namespace std
+{
+/**
+ * \brief Allows RdTask to be the return type of a coroutine, so endpoint handlers can be written with co_await.
+ */
+template <typename T, typename S, typename... Args>
+struct coroutine_traits<rd::RdTask<T, S>, Args...>
+{
+	using promise_type = rd::detail::RdTaskPromise<T, S>;
+};
+}	 // namespace std
+#endif
+
+#endif	  // RD_CPP_RDTASKAWAIT_H
@@ -6,22 +6,80 @@
 
 #include "thirdparty.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
 namespace rd
 {
 template <typename, typename>
 class RdTask;
 
+template <typename, typename>
+class WiredRdTask;
+
 namespace detail
 {
+template <typename, typename>
+class WiredRdTaskImpl;
+
 template <typename T, typename S = Polymorphic<T>>
 class RdTaskImpl
 {
 private:
 	mutable Property<RdTaskResult<T, S>> result;
 
+	mutable std::atomic<bool> claimed{false};
+	mutable std::mutex completion_lock;
+	mutable std::condition_variable completion_cv;
+	mutable bool completed{false};
+
+	// the first of local completion, response, cancellation or timeout claims the result, [value] is left untouched for
+	// the others
+	bool complete(RdTaskResult<T, S>&& value) const
+	{
+		if (claimed.exchange(true))
+		{
+			return false;
+		}
+		result.set(std::move(value));
+		{
+			std::lock_guard<std::mutex> guard(completion_lock);
+			completed = true;
+		}
+		completion_cv.notify_all();
+		return true;
+	}
+
+	/**
+	 * \brief Blocks the calling thread until the task is completed or [deadline] is reached,
+	 * in the latter case the task is completed with TimedOut.
+	 */
+	void wait_until(std::chrono::steady_clock::time_point deadline) const
+	{
+		std::unique_lock<std::mutex> guard(completion_lock);
+		if (!completion_cv.wait_until(guard, deadline, [this] { return completed; }))
+		{
+			guard.unlock();
+			if (!complete(RdTaskResult<T, S>(typename RdTaskResult<T, S>::TimedOut{})))
+			{
+				// result is being set by another thread right now
+				guard.lock();
+				completion_cv.wait(guard, [this] { return completed; });
+			}
+		}
+	}
+
 public:
 	template <typename, typename>
 	friend class ::rd::RdTask;
+
+	template <typename, typename>
+	friend class ::rd::WiredRdTask;
+
+	template <typename, typename>
+	friend class WiredRdTaskImpl;
 };
 }	 // namespace detail
 }	 // namespace rd
@@ -14,10 +14,11 @@
 namespace rd
 {
 /**
- * \brief Advanced monad result. It is in of following states: Success, Cancelled, Fault;
+ * \brief Advanced monad result. It is in of following states: Success, Cancelled, Fault, TimedOut;
  * Success -  Execution completed. Result stores in it.
  * Cancelled - Task was cancelled on callee side.
  * Fault - Something went wrong and reason stores in it.
+ * TimedOut - Caller stopped waiting for the result. Local state only, it is written to the wire as Cancelled.
  * \tparam T type of result
  * \tparam S "SerDes" for T
  */
@@ -61,6 +62,10 @@ public:
 		}
 	};
 
+	class TimedOut
+	{
+	};
+
 	// region ctor/dtor
 
 	template <typename F>
@@ -110,6 +115,7 @@ public:
 					  S::write(ctx, buffer, value.value);
 				  },
 				  [&buffer](Cancelled const&) { buffer.write_integral<int32_t>(1); },
+				  [&buffer](TimedOut const&) { buffer.write_integral<int32_t>(1); },
 				  [&buffer](Fault const& value) {
 					  buffer.write_integral<int32_t>(2);
 					  buffer.write_wstring(value.reason_type_fqn);
@@ -123,7 +129,8 @@ public:
 	{
 		return visit(util::make_visitor([](Success const& value) -> T const& { return wrapper::get<T>(value.value); },
 						 [](Cancelled const&) -> T const& { throw std::invalid_argument("Task finished in Cancelled state"); },
-						 [](Fault const& value) -> T const& { throw std::runtime_error(to_string(value.reason_message)); }),
+						 [](Fault const& value) -> T const& { throw std::runtime_error(to_string(value.reason_message)); },
+						 [](TimedOut const&) -> T const& { throw std::runtime_error("Task finished in TimedOut state"); }),
 			v);
 	}
 
@@ -147,11 +154,16 @@ public:
 		return v.index() == 2;
 	}
 
-	void as_faulted(std::function<void(Fault const&)> f)
+	void as_faulted(std::function<void(Fault const&)> f) const
 	{
 		f(rd::get<Fault>(v));
 	}
 
+	bool is_timed_out() const
+	{
+		return v.index() == 3;
+	}
+
 	friend bool operator==(const RdTaskResult& lhs, const RdTaskResult& rhs)
 	{
 		return &lhs == &rhs;
@@ -166,12 +178,13 @@ public:
 	{
 		return visit(util::make_visitor([](Success const& value) -> std::string { return to_string(value.value); },
 						 [](Cancelled const&) -> std::string { return "Cancelled state"; },
-						 [](Fault const& value) -> std::string { return to_string(value.reason_message); }),
+						 [](Fault const& value) -> std::string { return to_string(value.reason_message); },
+						 [](TimedOut const&) -> std::string { return "TimedOut state"; }),
 			taskResult.v);
 	}
 
 private:
-	mutable variant<Success, Cancelled, Fault> v;
+	mutable variant<Success, Cancelled, Fault, TimedOut> v;
 };
 }	 // namespace rd
 
@@ -0,0 +1,91 @@
+#ifndef RD_CPP_WIREDRDBATCHIMPL_H
+#define RD_CPP_WIREDRDBATCHIMPL_H
+
+#include "serialization/Polymorphic.h"
+#include "RdTask.h"
+#include "RdTaskResult.h"
+#include "base/RdReactiveBase.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "scheduler/SynchronousScheduler.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace rd
+{
+namespace detail
+{
+/**
+ * \brief Caller side of a batch started by RdCall::start_batch. Holds a single wire subscription for the whole batch
+ * and completes the task of every item from the one response message.
+ */
+template <typename T, typename S = Polymorphic<T>>
+class WiredRdBatchImpl final : public RdReactiveBase, public std::enable_shared_from_this<WiredRdBatchImpl<T, S>>
+{
+	using TRes = RdTaskResult<T, S>;
+
+	mutable LifetimeDefinition definition;
+	RdReactiveBase const* cutpoint{};
+	IScheduler* scheduler{};
+	std::vector<RdTask<T, S>> tasks;
+
+	mutable std::atomic<bool> claimed{false};
+
+	void complete(std::vector<TRes> results) const
+	{
+		if (claimed.exchange(true))
+		{
+			return;
+		}
+		for (size_t i = 0; i < tasks.size(); ++i)
+		{
+			tasks[i].set_result(i < results.size() ? std::move(results[i]) : TRes(typename TRes::Cancelled{}));
+		}
+	}
+
+public:
+	WiredRdBatchImpl(Lifetime const& lifetime, RdReactiveBase const& cutpoint, RdId rdid, IScheduler* scheduler,
+		std::vector<RdTask<T, S>> tasks)
+		: definition(lifetime), cutpoint(&cutpoint), scheduler(scheduler), tasks(std::move(tasks))
+	{
+		this->rdid = std::move(rdid);
+	}
+
+	/**
+	 * \brief Subscribes [batch] to its response, it stays alive until the response arrives or [lifetime] is terminated.
+	 */
+	static void advise(std::shared_ptr<WiredRdBatchImpl> const& batch)
+	{
+		Lifetime const& batch_lifetime = batch->definition.lifetime;
+		batch->cutpoint->get_wire()->advise(batch_lifetime, batch.get());
+		batch_lifetime->add_action([batch]() { batch->complete({}); });
+	}
+
+	void on_wire_received(Buffer buffer) const override
+	{
+		const int32_t count = buffer.read_integral<int32_t>();
+		std::vector<TRes> results;
+		results.reserve(count);
+		for (int32_t i = 0; i < count; ++i)
+		{
+			results.push_back(TRes::read(cutpoint->get_serialization_context(), buffer));
+		}
+		RD_LOG_TRACE(logReceived, "call {} {} received batch response of {} items", to_string(cutpoint->location),
+			to_string(rdid), count);
+		auto self = this->shared_from_this();
+		scheduler->queue([self, results = std::move(results)]() mutable {
+			self->complete(std::move(results));
+			self->definition.terminate();
+		});
+	}
+
+	IScheduler* get_wire_scheduler() const override
+	{
+		return &SynchronousScheduler::Instance();
+	}
+};
+}	 // namespace detail
+}	 // namespace rd
+
+#endif	  // RD_CPP_WIREDRDBATCHIMPL_H
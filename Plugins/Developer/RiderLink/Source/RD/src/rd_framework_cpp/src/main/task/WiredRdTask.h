@@ -18,7 +18,7 @@ public:
 	WiredRdTask() = delete;
 
 	WiredRdTask(Lifetime lifetime, RdReactiveBase const& call, RdId rdid, IScheduler* scheduler)
-		: impl(std::make_shared<detail::WiredRdTaskImpl<T, S>>(lifetime, call, rdid, scheduler, RdTask<T, S>::result))
+		: impl(std::make_shared<detail::WiredRdTaskImpl<T, S>>(lifetime, call, rdid, scheduler, RdTask<T, S>::impl))
 	{
 	}
 
@@ -32,6 +32,15 @@ public:
 
 	virtual ~WiredRdTask() = default;
 	// endregion
+
+	/**
+	 * \brief Blocks the calling thread without spinning until the task has a result or [timeout] elapses,
+	 * in the latter case the task is completed with TimedOut.
+	 */
+	void wait(std::chrono::milliseconds timeout) const
+	{
+		RdTask<T, S>::impl->wait_until(std::chrono::steady_clock::now() + timeout);
+	}
 };
 }	 // namespace rd
 
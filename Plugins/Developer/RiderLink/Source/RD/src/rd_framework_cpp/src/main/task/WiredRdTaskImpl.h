@@ -2,8 +2,11 @@
 #define RD_CPP_WIREDRDTASKIMPL_H
 
 #include "serialization/Polymorphic.h"
+#include "RdTaskImpl.h"
 #include "RdTaskResult.h"
 
+#include <memory>
+
 namespace rd
 {
 template <typename, typename>
@@ -18,43 +21,44 @@ private:
 	Lifetime lifetime;
 	RdReactiveBase const* cutpoint{};
 	IScheduler* scheduler{};
-	Property<RdTaskResult<T, S>>* result{};
+	std::shared_ptr<RdTaskImpl<T, S>> task;
+
+	LifetimeImpl::ActionHandle termination_action;
 
-	LifetimeImpl::counter_t termination_lifetime_id{};
+	bool complete(RdTaskResult<T, S>&& value) const
+	{
+		return task->complete(std::move(value));
+	}
 
 public:
 	template <typename, typename>
 	friend class ::rd::WiredRdTask;
 
 	WiredRdTaskImpl(
-		Lifetime lifetime, RdReactiveBase const& cutpoint, RdId rdid, IScheduler* scheduler, Property<RdTaskResult<T, S>>* result)
-		: lifetime(lifetime), cutpoint(&cutpoint), scheduler(scheduler), result(result)
+		Lifetime lifetime, RdReactiveBase const& cutpoint, RdId rdid, IScheduler* scheduler, std::shared_ptr<RdTaskImpl<T, S>> task)
+		: lifetime(lifetime), cutpoint(&cutpoint), scheduler(scheduler), task(std::move(task))
 	{
 		this->rdid = std::move(rdid);
 		cutpoint.get_wire()->advise(lifetime, this);
-		termination_lifetime_id =
-			lifetime->add_action([this]() { this->result->set_if_empty(typename RdTaskResult<T, S>::Cancelled{}); });
+		termination_action =
+			lifetime->add_action([this]() { complete(RdTaskResult<T, S>(typename RdTaskResult<T, S>::Cancelled{})); });
 	}
 
 	virtual ~WiredRdTaskImpl()
 	{
-		lifetime->remove_action(termination_lifetime_id);
+		lifetime->remove_action(termination_action);
 	}
 
 	void on_wire_received(Buffer buffer) const override
 	{
 		auto read_result = RdTaskResult<T, S>::read(cutpoint->get_serialization_context(), buffer);
-		spdlog::get("logReceived")->trace("call {} {} received response {} : {}", to_string(cutpoint->location), to_string(rdid), to_string(rdid),
+		RD_LOG_TRACE(logReceived, "call {} {} received response {} : {}", to_string(cutpoint->location), to_string(rdid), to_string(rdid),
 			to_string(read_result));
 		scheduler->queue([&, result = std::move(read_result)]() mutable {
-			if (this->result->has_value())
-			{
-				spdlog::get("logReceived")->trace("call {} {} response was dropped, task result is: {}", to_string(location), to_string(rdid),
-					to_string(result.unwrap()));
-			}
-			else
+			if (!complete(std::move(result)))
 			{
-				this->result->set_if_empty(std::move(result));
+				RD_LOG_TRACE(logReceived, "call {} {} response was dropped, task result is: {}", to_string(location), to_string(rdid),
+					to_string(result));
 			}
 		});
 	}
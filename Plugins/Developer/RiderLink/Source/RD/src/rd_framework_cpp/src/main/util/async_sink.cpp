@@ -0,0 +1,135 @@
+#include "async_sink.h"
+
+#include "thread_util.h"
+
+#include <string>
+#include <utility>
+
+namespace rd
+{
+namespace util
+{
+async_sink::async_sink(std::shared_ptr<spdlog::sinks::sink> sink, size_t capacity)
+	: sink(std::move(sink)), ring(capacity == 0 ? 1 : capacity)
+{
+	worker = std::thread([this] {
+		set_thread_name("rd async log");
+		run();
+	});
+}
+
+async_sink::~async_sink()
+{
+	stop();
+}
+
+void async_sink::run()
+{
+	std::vector<spdlog::details::log_msg_buffer> batch;
+	std::unique_lock<std::mutex> guard(lock);
+	while (true)
+	{
+		cv.wait(guard, [this] { return count > 0 || flushes_done != flushes_requested || stopping; });
+
+		batch.clear();
+		for (; count > 0; --count, head = (head + 1) % ring.size())
+		{
+			batch.push_back(std::move(ring[head]));
+		}
+		const size_t lost = std::exchange(dropped, 0);
+		const uint64_t flushes = flushes_requested;
+		const bool stop_after = stopping;
+		guard.unlock();
+
+		if (lost > 0)
+		{
+			const std::string text = std::to_string(lost) + " log messages were dropped";
+			sink->log(spdlog::details::log_msg("rd async log", spdlog::level::warn, text));
+		}
+		for (auto const& msg : batch)
+		{
+			sink->log(msg);
+		}
+		if (flushes != flushes_done || stop_after)
+		{
+			sink->flush();
+		}
+
+		guard.lock();
+		if (flushes != flushes_done)
+		{
+			flushes_done = flushes;
+			flushed_cv.notify_all();
+		}
+		if (stop_after && count == 0)
+		{
+			return;
+		}
+	}
+}
+
+void async_sink::log(const spdlog::details::log_msg& msg)
+{
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		if (!running || stopping)
+		{
+			guard.unlock();
+			sink->log(msg);
+			return;
+		}
+		if (count == ring.size())
+		{
+			head = (head + 1) % ring.size();
+			--count;
+			++dropped;
+		}
+		ring[(head + count) % ring.size()] = spdlog::details::log_msg_buffer(msg);
+		++count;
+	}
+	cv.notify_one();
+}
+
+void async_sink::flush()
+{
+	std::unique_lock<std::mutex> guard(lock);
+	if (!running || stopping)
+	{
+		guard.unlock();
+		sink->flush();
+		return;
+	}
+	const uint64_t flush = ++flushes_requested;
+	cv.notify_one();
+	flushed_cv.wait(guard, [this, flush] { return flushes_done >= flush || !running; });
+}
+
+void async_sink::set_pattern(const std::string& pattern)
+{
+	sink->set_pattern(pattern);
+}
+
+void async_sink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter)
+{
+	sink->set_formatter(std::move(sink_formatter));
+}
+
+void async_sink::stop()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (!running || stopping)
+		{
+			return;
+		}
+		stopping = true;
+	}
+	cv.notify_one();
+	worker.join();
+	std::lock_guard<std::mutex> guard(lock);
+	running = false;
+	stopping = false;
+	flushed_cv.notify_all();
+}
+}	 // namespace util
+}	 // namespace rd
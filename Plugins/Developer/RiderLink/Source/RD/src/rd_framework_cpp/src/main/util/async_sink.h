@@ -0,0 +1,90 @@
+#ifndef RD_CPP_ASYNC_SINK_H
+#define RD_CPP_ASYNC_SINK_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "spdlog/details/log_msg_buffer.h"
+#include "spdlog/sinks/sink.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Sink which passes messages to another [sink] on its own thread, so that logging doesn't wait for formatting
+ * and I/O.
+ *
+ * Messages wait in a ring buffer of [capacity] messages. When it is full the oldest one is dropped, and the number of
+ * dropped messages is written before the next ones.
+ */
+class RD_FRAMEWORK_API async_sink final : public spdlog::sinks::sink
+{
+	std::shared_ptr<spdlog::sinks::sink> sink;
+
+	std::mutex lock;
+	std::condition_variable cv;
+	std::condition_variable flushed_cv;
+
+	std::vector<spdlog::details::log_msg_buffer> ring;
+	size_t head = 0;
+	size_t count = 0;
+	size_t dropped = 0;
+
+	// flushes requested and done, [flush] waits until the latter catches up
+	uint64_t flushes_requested = 0;
+	uint64_t flushes_done = 0;
+	// messages go through [ring] only while running and not stopping
+	bool running = true;
+	bool stopping = false;
+
+	std::thread worker;
+
+	void run();
+
+public:
+	// region ctor/dtor
+
+	explicit async_sink(std::shared_ptr<spdlog::sinks::sink> sink, size_t capacity = 8192);
+
+	async_sink(async_sink const&) = delete;
+
+	async_sink& operator=(async_sink const&) = delete;
+
+	~async_sink() override;
+	// endregion
+
+	void log(const spdlog::details::log_msg& msg) override;
+
+	/**
+	 * \brief Waits until the messages logged so far are written and the underlying sink is flushed.
+	 */
+	void flush() override;
+
+	void set_pattern(const std::string& pattern) override;
+
+	void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+	/**
+	 * \brief Writes the waiting messages and stops the thread. Later messages are written on the caller's thread.
+	 */
+	void stop();
+};
+}	 // namespace util
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_ASYNC_SINK_H
@@ -0,0 +1,121 @@
+#include "file_util.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rd
+{
+namespace util
+{
+#ifdef _WIN32
+namespace
+{
+std::wstring widen(std::string const& path)
+{
+	std::wstring result(MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0), L'\0');
+	MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &result[0], static_cast<int>(result.size()));
+	return result;
+}
+}	 // namespace
+#endif
+
+MappedFile::MappedFile(std::string const& path)
+{
+#ifdef _WIN32
+	const HANDLE handle = CreateFileW(widen(path).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+	file = handle;
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(handle, &file_size) || file_size.QuadPart == 0)
+	{
+		return;
+	}
+	mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		return;
+	}
+	data_ = static_cast<char const*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	size_ = data_ ? static_cast<size_t>(file_size.QuadPart) : 0;
+#else
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return;
+	}
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+	{
+		void* view = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (view != MAP_FAILED)
+		{
+			data_ = static_cast<char const*>(view);
+			size_ = static_cast<size_t>(file_stat.st_size);
+		}
+	}
+	// the mapping stays valid without the descriptor
+	close(fd);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if (data_)
+	{
+		UnmapViewOfFile(data_);
+	}
+	if (mapping)
+	{
+		CloseHandle(mapping);
+	}
+	if (file)
+	{
+		CloseHandle(file);
+	}
+#else
+	if (data_)
+	{
+		munmap(const_cast<char*>(data_), size_);
+	}
+#endif
+}
+
+FILE* open_file(std::string const& path, char const* mode)
+{
+#ifdef _WIN32
+	return _wfopen(widen(path).c_str(), widen(mode).c_str());
+#else
+	return fopen(path.c_str(), mode);
+#endif
+}
+
+bool replace_file(std::string const& from, std::string const& to)
+{
+#ifdef _WIN32
+	return MoveFileExW(widen(from).c_str(), widen(to).c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+bool remove_file(std::string const& path)
+{
+#ifdef _WIN32
+	return DeleteFileW(widen(path).c_str()) != 0;
+#else
+	return std::remove(path.c_str()) == 0;
+#endif
+}
+}	 // namespace util
+}	 // namespace rd
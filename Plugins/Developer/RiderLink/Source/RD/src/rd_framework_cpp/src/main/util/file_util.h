@@ -0,0 +1,65 @@
+#ifndef RD_CPP_FILE_UTIL_H
+#define RD_CPP_FILE_UTIL_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Read-only view of a whole file, unmapped on destruction. Empty if the file is missing or empty.
+ */
+class RD_FRAMEWORK_API MappedFile
+{
+	char const* data_ = nullptr;
+	size_t size_ = 0;
+	// file and mapping handles on Windows
+	void* file = nullptr;
+	void* mapping = nullptr;
+
+public:
+	// region ctor/dtor
+
+	/**
+	 * \param path UTF-8 path of the file.
+	 */
+	explicit MappedFile(std::string const& path);
+
+	MappedFile(MappedFile const&) = delete;
+
+	MappedFile& operator=(MappedFile const&) = delete;
+
+	~MappedFile();
+	// endregion
+
+	char const* data() const
+	{
+		return data_;
+	}
+
+	size_t size() const
+	{
+		return size_;
+	}
+};
+
+/**
+ * \brief Same as fopen, with [path] in UTF-8 on all platforms.
+ */
+RD_FRAMEWORK_API FILE* open_file(std::string const& path, char const* mode);
+
+/**
+ * \brief Moves the file at [from] to [to], replacing [to] if it exists.
+ */
+RD_FRAMEWORK_API bool replace_file(std::string const& from, std::string const& to);
+
+RD_FRAMEWORK_API bool remove_file(std::string const& path);
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_FILE_UTIL_H
@@ -0,0 +1,301 @@
+#include "instrumentation.h"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace rd
+{
+namespace instrumentation
+{
+namespace
+{
+void update_max(std::atomic<uint64_t>& target, uint64_t value)
+{
+	uint64_t current = target.load(std::memory_order_relaxed);
+	while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+	{
+	}
+}
+
+void update_max(std::atomic<int64_t>& target, int64_t value)
+{
+	int64_t current = target.load(std::memory_order_relaxed);
+	while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+	{
+	}
+}
+
+int32_t highest_bit(uint64_t value)
+{
+	int32_t result = 0;
+	for (int32_t shift = 32; shift > 0; shift >>= 1)
+	{
+		if (value >> shift)
+		{
+			value >>= shift;
+			result += shift;
+		}
+	}
+	return result;
+}
+
+struct Registry
+{
+	// schedulers are looked up once, when they are created
+	std::mutex lock;
+	std::unordered_map<std::string, std::unique_ptr<SchedulerStats>> schedulers;
+
+	// entities are looked up for every message: open addressing with twice the slots of the limit, entries are only
+	// ever added, so lookups take no lock
+	static constexpr size_t ENTITY_SLOTS = Instrumentation::MAX_ENTITIES * 2;
+	std::array<std::atomic<EntityStats*>, ENTITY_SLOTS> entities{};
+	std::atomic<size_t> entity_count{0};
+	EntityStats overflow{RdId::Null()};
+
+	~Registry()
+	{
+		for (auto& slot : entities)
+		{
+			delete slot.load(std::memory_order_relaxed);
+		}
+	}
+
+	template <typename F>
+	void for_each_entity(F&& f)
+	{
+		for (auto& slot : entities)
+		{
+			if (EntityStats* stats = slot.load(std::memory_order_acquire))
+			{
+				f(*stats);
+			}
+		}
+	}
+};
+
+Registry& registry()
+{
+	static Registry instance;
+	return instance;
+}
+}	 // namespace
+
+// region Histogram
+
+int32_t Histogram::bucket_of(uint64_t value)
+{
+	if (value < LINEAR_BUCKETS)
+	{
+		return static_cast<int32_t>(value);
+	}
+	const int32_t magnitude = highest_bit(value);
+	const auto sub_bucket = static_cast<int32_t>((value >> (magnitude - SUB_BUCKET_BITS)) & ((1 << SUB_BUCKET_BITS) - 1));
+	return LINEAR_BUCKETS + ((magnitude - 4) << SUB_BUCKET_BITS) + sub_bucket;
+}
+
+uint64_t Histogram::lower_bound_of(int32_t bucket)
+{
+	if (bucket < LINEAR_BUCKETS)
+	{
+		return static_cast<uint64_t>(bucket);
+	}
+	const int32_t magnitude = ((bucket - LINEAR_BUCKETS) >> SUB_BUCKET_BITS) + 4;
+	const uint64_t sub_bucket = (bucket - LINEAR_BUCKETS) & ((1 << SUB_BUCKET_BITS) - 1);
+	return (uint64_t{1} << magnitude) | (sub_bucket << (magnitude - SUB_BUCKET_BITS));
+}
+
+void Histogram::record(uint64_t value)
+{
+	buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+	total_count.fetch_add(1, std::memory_order_relaxed);
+	total_sum.fetch_add(value, std::memory_order_relaxed);
+	update_max(max_value, value);
+}
+
+uint64_t Histogram::count() const
+{
+	return total_count.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::sum() const
+{
+	return total_sum.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::max() const
+{
+	return max_value.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::percentile(double fraction) const
+{
+	const uint64_t total = count();
+	if (total == 0)
+	{
+		return 0;
+	}
+	const auto rank = static_cast<uint64_t>(fraction * static_cast<double>(total - 1)) + 1;
+	uint64_t seen = 0;
+	for (int32_t i = 0; i < BUCKETS; ++i)
+	{
+		seen += buckets[i].load(std::memory_order_relaxed);
+		if (seen >= rank)
+		{
+			return lower_bound_of(i);
+		}
+	}
+	return max();
+}
+
+void Histogram::reset()
+{
+	for (auto& bucket : buckets)
+	{
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	total_count.store(0, std::memory_order_relaxed);
+	total_sum.store(0, std::memory_order_relaxed);
+	max_value.store(0, std::memory_order_relaxed);
+}
+
+// endregion
+
+// region SchedulerStats
+
+void SchedulerStats::on_queued()
+{
+	update_max(max_queue_depth, ++queue_depth);
+}
+
+void SchedulerStats::on_executed(int64_t queued_at_ns, int64_t started_at_ns, int64_t finished_at_ns)
+{
+	--queue_depth;
+	++executed;
+	queue_wait_ns.record(static_cast<uint64_t>(started_at_ns - queued_at_ns));
+	run_ns.record(static_cast<uint64_t>(finished_at_ns - started_at_ns));
+}
+
+void SchedulerStats::reset()
+{
+	max_queue_depth.store(queue_depth.load());
+	executed.store(0);
+	queue_wait_ns.reset();
+	run_ns.reset();
+}
+
+// endregion
+
+// region EntityStats
+
+void EntityStats::reset()
+{
+	messages_received.store(0);
+	bytes_received.store(0);
+	messages_sent.store(0);
+	bytes_sent.store(0);
+	queue_wait_ns.reset();
+	handler_ns.reset();
+}
+
+// endregion
+
+// region Instrumentation
+
+std::atomic<bool> Instrumentation::enabled{false};
+
+void Instrumentation::set_enabled(bool value)
+{
+	enabled.store(value);
+}
+
+SchedulerStats& Instrumentation::scheduler(std::string const& name)
+{
+	auto& instance = registry();
+	std::lock_guard<std::mutex> guard(instance.lock);
+	auto& stats = instance.schedulers[name];
+	if (!stats)
+	{
+		stats = std::make_unique<SchedulerStats>(name);
+	}
+	return *stats;
+}
+
+EntityStats& Instrumentation::entity(RdId const& id)
+{
+	auto& instance = registry();
+	size_t slot = rd::hash<RdId>()(id) & (Registry::ENTITY_SLOTS - 1);
+	for (size_t probe = 0; probe < Registry::ENTITY_SLOTS; ++probe, slot = (slot + 1) & (Registry::ENTITY_SLOTS - 1))
+	{
+		auto& cell = instance.entities[slot];
+		EntityStats* stats = cell.load(std::memory_order_acquire);
+		if (stats == nullptr)
+		{
+			if (instance.entity_count.fetch_add(1, std::memory_order_relaxed) >= MAX_ENTITIES)
+			{
+				instance.entity_count.fetch_sub(1, std::memory_order_relaxed);
+				return instance.overflow;
+			}
+			auto created = std::make_unique<EntityStats>(id);
+			if (cell.compare_exchange_strong(stats, created.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				return *created.release();
+			}
+			// another thread took the slot first, [stats] is its entry
+			instance.entity_count.fetch_sub(1, std::memory_order_relaxed);
+		}
+		if (stats->id == id)
+		{
+			return *stats;
+		}
+	}
+	return instance.overflow;
+}
+
+void Instrumentation::on_received(RdId const& id, size_t bytes)
+{
+	auto& stats = entity(id);
+	stats.messages_received.fetch_add(1, std::memory_order_relaxed);
+	stats.bytes_received.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void Instrumentation::on_sent(RdId const& id, size_t bytes)
+{
+	auto& stats = entity(id);
+	stats.messages_sent.fetch_add(1, std::memory_order_relaxed);
+	stats.bytes_sent.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void Instrumentation::for_each_scheduler(std::function<void(SchedulerStats const&)> const& f)
+{
+	auto& instance = registry();
+	std::lock_guard<std::mutex> guard(instance.lock);
+	for (auto const& it : instance.schedulers)
+	{
+		f(*it.second);
+	}
+}
+
+void Instrumentation::for_each_entity(std::function<void(EntityStats const&)> const& f)
+{
+	auto& instance = registry();
+	instance.for_each_entity(f);
+	f(instance.overflow);
+}
+
+void Instrumentation::reset()
+{
+	auto& instance = registry();
+	std::lock_guard<std::mutex> guard(instance.lock);
+	for (auto& it : instance.schedulers)
+	{
+		it.second->reset();
+	}
+	instance.for_each_entity([](EntityStats& stats) { stats.reset(); });
+	instance.overflow.reset();
+}
+
+// endregion
+}	 // namespace instrumentation
+}	 // namespace rd
@@ -0,0 +1,173 @@
+#ifndef RD_CPP_INSTRUMENTATION_H
+#define RD_CPP_INSTRUMENTATION_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "protocol/RdId.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+namespace instrumentation
+{
+/**
+ * \brief Log-linear histogram in the spirit of HdrHistogram: values below 16 are exact, larger values fall into
+ * 4 linear sub-buckets per power of two, which bounds the relative error by 25%. Recording is lock-free.
+ */
+class RD_FRAMEWORK_API Histogram
+{
+public:
+	static constexpr int32_t SUB_BUCKET_BITS = 2;
+	static constexpr int32_t LINEAR_BUCKETS = 16;
+	static constexpr int32_t BUCKETS = LINEAR_BUCKETS + (64 - 4) * (1 << SUB_BUCKET_BITS);
+
+private:
+	std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+	std::atomic<uint64_t> total_count{0};
+	std::atomic<uint64_t> total_sum{0};
+	std::atomic<uint64_t> max_value{0};
+
+	static int32_t bucket_of(uint64_t value);
+
+	static uint64_t lower_bound_of(int32_t bucket);
+
+public:
+	// region ctor/dtor
+
+	Histogram() = default;
+
+	Histogram(Histogram const&) = delete;
+
+	Histogram& operator=(Histogram const&) = delete;
+	// endregion
+
+	void record(uint64_t value);
+
+	uint64_t count() const;
+
+	uint64_t sum() const;
+
+	uint64_t max() const;
+
+	/**
+	 * \param fraction in [0, 1], e.g. 0.99
+	 * \return lower bound of the bucket which contains the given fraction of recorded values
+	 */
+	uint64_t percentile(double fraction) const;
+
+	void reset();
+};
+
+/**
+ * \brief Statistics of a scheduler, identified by its name.
+ */
+struct RD_FRAMEWORK_API SchedulerStats
+{
+	std::string name;
+	std::atomic<int64_t> queue_depth{0};
+	std::atomic<int64_t> max_queue_depth{0};
+	std::atomic<uint64_t> executed{0};
+	Histogram queue_wait_ns;
+	Histogram run_ns;
+
+	explicit SchedulerStats(std::string name) : name(std::move(name))
+	{
+	}
+
+	void on_queued();
+
+	void on_executed(int64_t queued_at_ns, int64_t started_at_ns, int64_t finished_at_ns);
+
+	void reset();
+};
+
+/**
+ * \brief Statistics of messages addressed to a single RdId.
+ * handler_ns covers on_wire_received of the entity, i.e. deserialization together with the handler.
+ */
+struct RD_FRAMEWORK_API EntityStats
+{
+	RdId id;
+	std::atomic<uint64_t> messages_received{0};
+	std::atomic<uint64_t> bytes_received{0};
+	std::atomic<uint64_t> messages_sent{0};
+	std::atomic<uint64_t> bytes_sent{0};
+	Histogram queue_wait_ns;
+	Histogram handler_ns;
+
+	explicit EntityStats(RdId id) : id(id)
+	{
+	}
+
+	void reset();
+};
+
+/**
+ * \brief Process-wide registry of statistics. Disabled by default, then every hook costs a single relaxed load.
+ */
+class RD_FRAMEWORK_API Instrumentation
+{
+	static std::atomic<bool> enabled;
+
+public:
+	/**
+	 * \brief Number of distinct ids tracked separately, messages to the rest are accounted to RdId::Null().
+	 * Responses of calls go to a fresh id each, so the set of ids is not bounded by the model.
+	 */
+	static constexpr size_t MAX_ENTITIES = 256;
+
+	static bool is_enabled()
+	{
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	static void set_enabled(bool value);
+
+	static int64_t now_ns()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/**
+	 * \return statistics of the scheduler with the given [name], the reference stays valid for the process lifetime
+	 */
+	static SchedulerStats& scheduler(std::string const& name);
+
+	/**
+	 * \brief Looks [id] up without locking, only its first message allocates.
+	 * \return statistics of the given [id], the reference stays valid for the process lifetime
+	 */
+	static EntityStats& entity(RdId const& id);
+
+	static void on_received(RdId const& id, size_t bytes);
+
+	static void on_sent(RdId const& id, size_t bytes);
+
+	static void for_each_scheduler(std::function<void(SchedulerStats const&)> const& f);
+
+	static void for_each_entity(std::function<void(EntityStats const&)> const& f);
+
+	/**
+	 * \brief Zeroes all statistics, registered schedulers and ids are kept.
+	 */
+	static void reset();
+};
+}	 // namespace instrumentation
+}	 // namespace rd
+
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_INSTRUMENTATION_H
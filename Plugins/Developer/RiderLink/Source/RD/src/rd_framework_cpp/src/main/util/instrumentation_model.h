@@ -0,0 +1,55 @@
+#ifndef RD_CPP_INSTRUMENTATION_MODEL_H
+#define RD_CPP_INSTRUMENTATION_MODEL_H
+
+#include "util/instrumentation.h"
+#include "impl/RdMap.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rd
+{
+namespace instrumentation
+{
+/**
+ * \brief Publishes a snapshot of Instrumentation into [map] under flat keys "scheduler/<name>/<metric>" and
+ * "entity/<id>/<metric>", so that the remote side can display live hot spots. Times are in nanoseconds.
+ * Must be called on the thread of [map], e.g. periodically from the protocol scheduler.
+ */
+inline void publish(RdMap<std::wstring, int64_t> const& map)
+{
+	std::vector<std::pair<std::wstring, int64_t>> values;
+	auto add_histogram = [&values](std::wstring const& prefix, Histogram const& histogram) {
+		values.emplace_back(prefix + L"_count", static_cast<int64_t>(histogram.count()));
+		values.emplace_back(prefix + L"_p50", static_cast<int64_t>(histogram.percentile(0.5)));
+		values.emplace_back(prefix + L"_p99", static_cast<int64_t>(histogram.percentile(0.99)));
+		values.emplace_back(prefix + L"_max", static_cast<int64_t>(histogram.max()));
+	};
+	// collected first: setting the map sends messages, which change the statistics being read
+	Instrumentation::for_each_scheduler([&](SchedulerStats const& stats) {
+		const std::wstring prefix = L"scheduler/" + to_wstring(stats.name) + L"/";
+		values.emplace_back(prefix + L"queue_depth", stats.queue_depth.load());
+		values.emplace_back(prefix + L"max_queue_depth", stats.max_queue_depth.load());
+		values.emplace_back(prefix + L"executed", static_cast<int64_t>(stats.executed.load()));
+		add_histogram(prefix + L"queue_wait_ns", stats.queue_wait_ns);
+		add_histogram(prefix + L"run_ns", stats.run_ns);
+	});
+	Instrumentation::for_each_entity([&](EntityStats const& stats) {
+		const std::wstring prefix = L"entity/" + to_wstring(to_string(stats.id)) + L"/";
+		values.emplace_back(prefix + L"messages_received", static_cast<int64_t>(stats.messages_received.load()));
+		values.emplace_back(prefix + L"bytes_received", static_cast<int64_t>(stats.bytes_received.load()));
+		values.emplace_back(prefix + L"messages_sent", static_cast<int64_t>(stats.messages_sent.load()));
+		values.emplace_back(prefix + L"bytes_sent", static_cast<int64_t>(stats.bytes_sent.load()));
+		add_histogram(prefix + L"queue_wait_ns", stats.queue_wait_ns);
+		add_histogram(prefix + L"handler_ns", stats.handler_ns);
+	});
+	for (auto& value : values)
+	{
+		map.set(std::move(value.first), value.second);
+	}
+}
+}	 // namespace instrumentation
+}	 // namespace rd
+
+#endif	  // RD_CPP_INSTRUMENTATION_MODEL_H
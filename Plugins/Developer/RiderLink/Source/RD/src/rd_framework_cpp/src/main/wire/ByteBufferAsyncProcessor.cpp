@@ -1,6 +1,7 @@
 #include "ByteBufferAsyncProcessor.h"
 
 #include "util/guards.h"
+#include "util/logging.h"
 #include <util/thread_util.h>
 
 #include "spdlog/sinks/stdout_color_sinks.h"
@@ -37,14 +38,14 @@ bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set
 		std::lock_guard<decltype(lock)> guard(lock);
 		if (state == StateKind::Initialized)
 		{
-			logger->debug("Can't {} \'{}\', because it hasn't been started yet", std::string(action), id);
+			RD_LOG_DEBUG(logger, "Can't {} \'{}\', because it hasn't been started yet", std::string(action), id);
 			cleanup0();
 			return true;
 		}
 
 		if (state >= state_to_set)
 		{
-			logger->debug("Trying to {} async processor \'{}' but it's in state {}", std::string(action), id, to_string(state));
+			RD_LOG_DEBUG(logger, "Trying to {} async processor \'{}' but it's in state {}", std::string(action), id, to_string(state));
 			return true;
 		}
 
@@ -58,7 +59,7 @@ bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set
 
 	if (status == std::future_status::timeout)
 	{
-		logger->error("Couldn't wait async thread during time: {}", to_string(timeout));
+		RD_LOG_ERROR(logger, "Couldn't wait async thread during time: {}", to_string(timeout));
 		success = false;
 	}
 
@@ -70,10 +71,14 @@ bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set
 void ByteBufferAsyncProcessor::add_data(std::vector<Buffer::ByteArray>&& new_data)
 {
 	std::lock_guard<decltype(queue_lock)> guard(queue_lock);
-	std::move(new_data.begin(), new_data.end(), std::back_inserter(queue));
-	//		for (auto &&item : new_data) {
-	//			queue.emplace(std::move(item));
-	//		}
+	for (auto&& item : new_data)
+	{
+		// emptied by a coalescing put, no message is empty
+		if (!item.empty())
+		{
+			queue.emplace_back(std::move(item));
+		}
+	}
 }
 
 bool ByteBufferAsyncProcessor::reprocess()
@@ -81,12 +86,12 @@ bool ByteBufferAsyncProcessor::reprocess()
 	{
 		std::lock_guard<decltype(queue_lock)> guard(queue_lock);
 
-		logger->debug("{}: reprocessing started", id);
+		RD_LOG_DEBUG(logger, "{}: reprocessing started", id);
 
 		std::unique_lock<decltype(processing_lock)> ul(processing_lock);
 		processing_cv.wait(ul, [this]() -> bool { return !in_processing; });
 
-		logger->debug("{}: reprocessing waited for main processing", id);
+		RD_LOG_DEBUG(logger, "{}: reprocessing waited for main processing", id);
 
 		while (current_seqn <= acknowledged_seqn)
 		{
@@ -112,7 +117,7 @@ void ByteBufferAsyncProcessor::process()
 		std::unique_lock<decltype(processing_lock)> ul(processing_lock);
 		util::bool_guard bool_guard(in_processing);
 
-		logger->debug("{}: processing started", id);
+		RD_LOG_DEBUG(logger, "{}: processing started", id);
 
 		while (!queue.empty() && processor(queue.front(), max_sent_seqn + 1))
 		{
@@ -149,7 +154,7 @@ void ByteBufferAsyncProcessor::ThreadProc()
 				}
 				cv.wait(lock);
 
-				logger->debug("{}'s ThreadProc waited for notify", id);
+				RD_LOG_DEBUG(logger, "{}'s ThreadProc waited for notify", id);
 
 				if (state >= StateKind::Terminating)
 				{
@@ -158,6 +163,7 @@ void ByteBufferAsyncProcessor::ThreadProc()
 			}
 			add_data(std::move(data));
 			data.clear();
+			coalesced.clear();
 		}
 
 		try
@@ -166,7 +172,7 @@ void ByteBufferAsyncProcessor::ThreadProc()
 		}
 		catch (std::exception const& e)
 		{
-			logger->error("Exception while processing byte queue | {}", e.what());
+			RD_LOG_ERROR(logger, "Exception while processing byte queue | {}", e.what());
 		}
 	}
 }
@@ -178,7 +184,7 @@ void ByteBufferAsyncProcessor::start()
 
 		if (state != StateKind::Initialized)
 		{
-			logger->debug("Trying to START async processor {} but it's in state {}", id, to_string(state));
+			RD_LOG_DEBUG(logger, "Trying to START async processor {} but it's in state {}", id, to_string(state));
 			return;
 		}
 
@@ -212,21 +218,46 @@ void ByteBufferAsyncProcessor::put(Buffer::ByteArray new_data)
 	cv.notify_all();
 }
 
+void ByteBufferAsyncProcessor::put(Buffer::ByteArray new_data, int64_t coalescing_key)
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+
+		if (state >= StateKind::Stopping)
+		{
+			return;
+		}
+		// the stale message is dropped rather than overwritten, so the new one still follows everything put before it
+		auto it = coalesced.find(coalescing_key);
+		if (it != coalesced.end())
+		{
+			data[it->second].clear();
+			it->second = data.size();
+		}
+		else
+		{
+			coalesced.emplace(coalescing_key, data.size());
+		}
+		data.emplace_back(std::move(new_data));
+	}
+	cv.notify_all();
+}
+
 void ByteBufferAsyncProcessor::pause(const std::string& reason)
 {
 	std::lock_guard<decltype(lock)> guard(lock);
 
 	++interrupt_balance;
 
-	logger->debug("{} paused with reason={},state={}", id, reason, to_string(state));
+	RD_LOG_DEBUG(logger, "{} paused with reason={},state={}", id, reason, to_string(state));
 
 	auto current_thread_id = std::this_thread::get_id();
 	if (current_thread_id != async_thread_id)
 	{
-		logger->debug(id + "{} paused from another thread : {}", id, to_string(current_thread_id));
+		RD_LOG_DEBUG(logger, id + "{} paused from another thread : {}", id, to_string(current_thread_id));
 		std::unique_lock<decltype(processing_lock)> ul(processing_lock);
 		processing_cv.wait(ul, [this]() -> bool { return !in_processing; });
-		logger->debug("{}: pausing waited for main processing", id);
+		RD_LOG_DEBUG(logger, "{}: pausing waited for main processing", id);
 	}
 }
 
@@ -239,7 +270,7 @@ void ByteBufferAsyncProcessor::resume()
 
 		--interrupt_balance;
 
-		logger->debug("{} resumed", id);
+		RD_LOG_DEBUG(logger, "{} resumed", id);
 	}
 
 	cv.notify_all();
@@ -251,12 +282,12 @@ void ByteBufferAsyncProcessor::acknowledge(sequence_number_t seqn)
 
 	if (seqn > acknowledged_seqn)
 	{
-		logger->trace("{}: new acknowledged seqn: {}", this->id, seqn);
+		RD_LOG_TRACE(logger, "{}: new acknowledged seqn: {}", this->id, seqn);
 		acknowledged_seqn = seqn;
 	}
 	else
 	{
-		logger->error("Acknowledge {} called, while next seqn MUST BE greater than {}", seqn, acknowledged_seqn);
+		RD_LOG_ERROR(logger, "Acknowledge {} called, while next seqn MUST BE greater than {}", seqn, acknowledged_seqn);
 	}
 }
 
@@ -15,6 +15,7 @@
 #include <condition_variable>
 #include <future>
 #include <list>
+#include <unordered_map>
 
 #include <rd_framework_export.h>
 
@@ -53,6 +54,8 @@ private:
 	std::future<void> async_future;
 
 	std::vector<Buffer::ByteArray> data;
+	// coalescing key -> index in [data] of the message that newer puts with this key replace
+	std::unordered_map<int64_t, size_t> coalesced;
 	std::mutex queue_lock;
 	std::deque<Buffer::ByteArray> queue{};
 	std::deque<Buffer::ByteArray> pending_queue{};
@@ -94,6 +97,12 @@ public:
 
 	void put(Buffer::ByteArray new_data);
 
+	/**
+	 * \brief Puts [new_data] at the tail and, if a message with the same [coalescing_key] is still waiting to be picked up
+	 * by the processing thread, drops that message. Messages put in between keep their order before [new_data].
+	 */
+	void put(Buffer::ByteArray new_data, int64_t coalescing_key);
+
 	void pause(const std::string& reason);
 
 	void resume();
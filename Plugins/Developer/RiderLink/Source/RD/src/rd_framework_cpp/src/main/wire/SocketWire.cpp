@@ -1,6 +1,8 @@
 #include "wire/SocketWire.h"
 
 #include <util/thread_util.h>
+#include "util/instrumentation.h"
+#include "util/logging.h"
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 
@@ -47,21 +49,21 @@ void SocketWire::Base::receiverProc() const
 		{
 			if (!socket_provider->IsSocketValid())
 			{
-				logger->debug("{}: stop receive messages because socket disconnected", this->id);
+				RD_LOG_DEBUG(logger, "{}: stop receive messages because socket disconnected", this->id);
 				//					async_send_buffer.terminate();
 				break;
 			}
 
 			if (!read_and_dispatch_message())
 			{
-				logger->debug("{}: connection was gracefully shutdown", id);
+				RD_LOG_DEBUG(logger, "{}: connection was gracefully shutdown", id);
 				//					async_send_buffer.terminate();
 				break;
 			}
 		}
 		catch (std::exception const& ex)
 		{
-			logger->error("{} caught processing | {}", this->id, ex.what());
+			RD_LOG_ERROR(logger, "{} caught processing | {}", this->id, ex.what());
 			//				async_send_buffer.terminate();
 			break;
 		}
@@ -91,19 +93,19 @@ bool SocketWire::Base::send0(Buffer::ByteArray const& msg, sequence_number_t seq
 																					 ": failed to send package over the network"
 																					 ", reason: " +
 																					 socket_provider->DescribeError());
-		logger->info("{}: were sent {} bytes", this->id, msglen);
+		RD_LOG_TRACE(logger, "{}: were sent {} bytes", this->id, msglen);
 		//        RD_ASSERT_MSG(socketProvider->Flush(), "{}: failed to flush");
 		return true;
 	}
 	catch (std::exception const& e)
 	{
 		//			async_send_buffer.pause("send0");
-		logger->warn("Send0 failed due to: | {}", e.what());
+		RD_LOG_WARN(logger, "Send0 failed due to: | {}", e.what());
 		return false;
 	}
 }
 
-void SocketWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const
+Buffer::ByteArray SocketWire::Base::pack(RdId const& rd_id, std::function<void(Buffer& buffer)> const& writer) const
 {
 	RD_ASSERT_MSG(!rd_id.isNull(), "{}: id mustn't be null");
 
@@ -118,7 +120,26 @@ void SocketWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer
 	local_send_buffer.rewind();
 	local_send_buffer.write_integral<int32_t>(len - 4);
 	local_send_buffer.set_position(len);
-	async_send_buffer.put(std::move(local_send_buffer).getRealArray());
+	if (instrumentation::Instrumentation::is_enabled())
+	{
+		instrumentation::Instrumentation::on_sent(rd_id, len);
+	}
+	return std::move(local_send_buffer).getRealArray();
+}
+
+void SocketWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const
+{
+	async_send_buffer.put(pack(rd_id, writer));
+}
+
+void SocketWire::Base::send_coalesced(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const
+{
+	async_send_buffer.put(pack(rd_id, writer), rd_id.get_hash());
+}
+
+void SocketWire::Base::send_packed(RdId const&, Buffer::ByteArray message) const
+{
+	async_send_buffer.put(std::move(message));
 }
 
 void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_socket)
@@ -153,16 +174,16 @@ void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_so
 	});
 	const auto status = heartbeat.wait_for(timeout);
 
-	logger->debug("{}: waited for heartbeat to stop with status: {}", this->id, status);
+	RD_LOG_DEBUG(logger, "{}: waited for heartbeat to stop with status: {}", this->id, status);
 
 	if (!socket_provider->IsSocketValid())
 	{
-		logger->debug("{}: socket was already shut down", this->id);
+		RD_LOG_DEBUG(logger, "{}: socket was already shut down", this->id);
 	}
 	else if (!socket_provider->Shutdown(CSimpleSocket::Both))
 	{
 		// double close?
-		logger->warn("{}: possibly double close after disconnect", this->id);
+		RD_LOG_WARN(logger, "{}: possibly double close after disconnect", this->id);
 	}
 }
 
@@ -205,34 +226,34 @@ bool SocketWire::Base::read_from_socket(Buffer::word_t* res, int32_t msglen) con
 			{
 				hi = lo = receiver_buffer.begin();
 			}
-			logger->info("{}: receive started", this->id);
+			RD_LOG_TRACE(logger, "{}: receive started", this->id);
 			int32_t read = socket_provider->Receive(static_cast<int32_t>(receiver_buffer.end() - hi), &*hi);
 			if (read == -1)
 			{
 				auto err = socket_provider->GetSocketError();
 				if (err == CSimpleSocket::SocketInvalidSocket)
 				{
-					logger->info("{}: socket was shut down for receiving", this->id);
+					RD_LOG_INFO(logger, "{}: socket was shut down for receiving", this->id);
 					return false;
 				}
-				logger->error("{}: error has occurred while receiving", this->id);
+				RD_LOG_ERROR(logger, "{}: error has occurred while receiving", this->id);
 				return false;
 			}
 			if (read == 0)
 			{
-				logger->info("{}: socket was shut down for receiving", this->id);
+				RD_LOG_INFO(logger, "{}: socket was shut down for receiving", this->id);
 				return false;
 			}
 			hi += read;
 			if (read > 0)
 			{
-				logger->info("{}: receive finished: {} bytes read", this->id, read);
+				RD_LOG_TRACE(logger, "{}: receive finished: {} bytes read", this->id, read);
 			}
 		}
 	}
 	if (ptr != msglen)
 	{
-		logger->error("read invalid number of bytes from socket, expected: {}, actual: {}", msglen, ptr);
+		RD_LOG_ERROR(logger, "read invalid number of bytes from socket, expected: {}, actual: {}", msglen, ptr);
 		assert(false);
 	}
 	return true;
@@ -270,7 +291,7 @@ std::pair<int, sequence_number_t> SocketWire::Base::read_header() const
 			{
 				if (!heartbeatAlive.get())
 				{	 // only on change
-					logger->trace(
+					RD_LOG_TRACE(logger, 
 						"Connection is alive after receiving PING {}: "
 						"received_timestamp: {}, "
 						"received_counterpart_timestamp: {}, "
@@ -305,18 +326,18 @@ int32_t SocketWire::Base::read_package() const
 	const auto pair = read_header();
 	if (pair == INVALID_HEADER)
 	{
-		logger->debug("{}: failed to read header", this->id);
+		RD_LOG_DEBUG(logger, "{}: failed to read header", this->id);
 		return -1;
 	}
 	const auto len = pair.first;
 	const auto seqn = pair.second;
 
-	logger->debug("{}: read len={}, seqn={}, max_received_seqn={}", this->id, len, seqn, max_received_seqn);
+	RD_LOG_DEBUG(logger, "{}: read len={}, seqn={}, max_received_seqn={}", this->id, len, seqn, max_received_seqn);
 
 	receive_pkg.require_available(len);
 	if (!read_data_from_socket(receive_pkg.data(), len))
 	{
-		logger->debug("{}: failed to read package", this->id);
+		RD_LOG_DEBUG(logger, "{}: failed to read package", this->id);
 		return -1;
 	}
 	send_ack(seqn);
@@ -326,7 +347,7 @@ int32_t SocketWire::Base::read_package() const
 	}
 	max_received_seqn = seqn;
 
-	logger->info("{}: was received package, bytes={}, seqn={}", this->id, len, seqn);
+	RD_LOG_TRACE(logger, "{}: was received package, bytes={}, seqn={}", this->id, len, seqn);
 	return len;
 }
 
@@ -335,29 +356,33 @@ bool SocketWire::Base::read_and_dispatch_message() const
 	sz = (sz == -1 ? receive_pkg.read_integral<int32_t>() : sz);
 	if (sz == -1)
 	{
-		logger->debug("{}: sz == -1", this->id);
+		RD_LOG_DEBUG(logger, "{}: sz == -1", this->id);
 		return false;
 	}
 	id_ = (id_ == -1 ? receive_pkg.read_integral<RdId::hash_t>() : id_);
 	if (id_ == -1)
 	{
-		logger->error("id == -1");
+		RD_LOG_ERROR(logger, "id == -1");
 		return false;
 	}
-	logger->trace("{}: message info: sz={}, id={}", this->id, sz, id_);
+	RD_LOG_TRACE(logger, "{}: message info: sz={}, id={}", this->id, sz, id_);
 	const RdId rd_id{id_};
 	sz -= 8;	// RdId
 	message.require_available(sz);
 
 	if (!receive_pkg.read(message.data() + message.get_position(), sz - message.get_position()))
 	{
-		logger->error("{}: constructing message failed", this->id);
+		RD_LOG_ERROR(logger, "{}: constructing message failed", this->id);
 		return false;
 	}
 
-	logger->debug("{}: message received", this->id);
+	RD_LOG_DEBUG(logger, "{}: message received", this->id);
+	if (instrumentation::Instrumentation::is_enabled())
+	{
+		instrumentation::Instrumentation::on_received(rd_id, static_cast<size_t>(sz));
+	}
 	message_broker.dispatch(rd_id, std::move(message));
-	logger->debug("{}: message dispatched", this->id);
+	RD_LOG_DEBUG(logger, "{}: message dispatched", this->id);
 
 	sz = -1;
 	id_ = -1;
@@ -377,7 +402,7 @@ void SocketWire::Base::ping() const
 	{
 		if (heartbeatAlive.get())
 		{	 // only on change
-			logger->trace(
+			RD_LOG_TRACE(logger, 
 				"Disconnect detected while sending PING {}: "
 				"current_timestamp: {}, "
 				"counterpart_timestamp: {}, "
@@ -396,7 +421,7 @@ void SocketWire::Base::ping() const
 			int32_t sent = socket_provider->Send(ping_pkg_header.data(), ping_pkg_header.get_position());
 			if (sent == 0 && !socket_provider->IsSocketValid())
 			{
-				logger->debug("{}: failed to send ping over the network, reason: socket was shut down for sending", this->id);
+				RD_LOG_DEBUG(logger, "{}: failed to send ping over the network, reason: socket was shut down for sending", this->id);
 				return;
 			}
 			RD_ASSERT_THROW_MSG(sent == PACKAGE_HEADER_LENGTH,
@@ -407,13 +432,13 @@ void SocketWire::Base::ping() const
 	}
 	catch (std::exception const& e)
 	{
-		logger->warn("{}: exception raised during PING | {}", this->id, e.what());
+		RD_LOG_WARN(logger, "{}: exception raised during PING | {}", this->id, e.what());
 	}
 }
 
 bool SocketWire::Base::send_ack(sequence_number_t seqn) const
 {
-	logger->trace("{} send ack {}", id, seqn);
+	RD_LOG_TRACE(logger, "{} send ack {}", id, seqn);
 	try
 	{
 		ack_buffer.rewind();
@@ -431,7 +456,7 @@ bool SocketWire::Base::send_ack(sequence_number_t seqn) const
 	}
 	catch (std::exception const& e)
 	{
-		logger->warn("{}: exception raised during ACK, seqn = {} | {}", id, seqn, e.what());
+		RD_LOG_WARN(logger, "{}: exception raised during ACK, seqn = {} | {}", id, seqn, e.what());
 		return false;
 	}
 }
@@ -470,7 +495,7 @@ SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint1
 
 					// https://stackoverflow.com/questions/22417228/prevent-tcp-socket-connection-retries
 					// HKLM\SYSTEM\CurrentControlSet\Services\Tcpip\Parameters\TcpMaxConnectRetransmissions
-					logger->info("{}: connecting 127.0.0.1: {}", this->id, this->port);
+					RD_LOG_INFO(logger, "{}: connecting 127.0.0.1: {}", this->id, this->port);
 					RD_ASSERT_THROW_MSG(socket->Open("127.0.0.1", this->port),
 						fmt::format("{}: failed to open ActiveSocket, reason: {}", this->id, socket->DescribeError()));
 					{
@@ -479,7 +504,7 @@ SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint1
 						{
 							if (!socket->Close())
 							{
-								logger->error("{} failed to close socket, reason: {}", this->id, socket->DescribeError());
+								RD_LOG_ERROR(logger, "{} failed to close socket, reason: {}", this->id, socket->DescribeError());
 							}
 							return;
 						}
@@ -507,35 +532,35 @@ SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint1
 		}
 		catch (std::exception const& e)
 		{
-			logger->info("{}: closed with exception: {}", this->id, e.what());
+			RD_LOG_INFO(logger, "{}: closed with exception: {}", this->id, e.what());
 		}
-		logger->debug("{}: thread expired", this->id);
+		RD_LOG_DEBUG(logger, "{}: thread expired", this->id);
 	});
 
 	lifetime->add_action([this]() {
-		logger->info("{}: starts terminating lifetime", this->id);
+		RD_LOG_INFO(logger, "{}: starts terminating lifetime", this->id);
 
 		const bool send_buffer_stopped = async_send_buffer.stop(timeout);
-		logger->debug("{}: send buffer stopped, success: {}", this->id, send_buffer_stopped);
+		RD_LOG_DEBUG(logger, "{}: send buffer stopped, success: {}", this->id, send_buffer_stopped);
 
 		{
 			std::lock_guard<decltype(lock)> guard(lock);
-			logger->debug("{}: closing socket", this->id);
+			RD_LOG_DEBUG(logger, "{}: closing socket", this->id);
 
 			if (socket != nullptr)
 			{
 				if (!socket->Close())
 				{
-					logger->error("{}: failed to close socket", this->id);
+					RD_LOG_ERROR(logger, "{}: failed to close socket", this->id);
 				}
 			}
 		}
 		cv.notify_all();
 
-		logger->debug("{}: waiting for receiver thread", this->id);
-		logger->debug("{}: is thread joinable? {}", this->id, thread.joinable());
+		RD_LOG_DEBUG(logger, "{}: waiting for receiver thread", this->id);
+		RD_LOG_DEBUG(logger, "{}: is thread joinable? {}", this->id, thread.joinable());
 		thread.join();
-		logger->info("{}: termination finished", this->id);
+		RD_LOG_INFO(logger, "{}: termination finished", this->id);
 	});
 }
 
@@ -560,7 +585,7 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 	this->port = ss->GetServerPort();
 	RD_ASSERT_MSG(this->port != 0, fmt::format("{}: port wasn't chosen", this->id));
 
-	logger->info("{}: listening 127.0.0.1/{}", this->id, this->port);
+	RD_LOG_INFO(logger, "{}: listening 127.0.0.1/{}", this->id, this->port);
 	Lifetime lifetime = serverLifetimeDefinition.lifetime;
 
 	thread = std::thread([this, lifetime]() mutable {
@@ -570,7 +595,7 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 		{
 			try
 			{
-				logger->info("{}: accepting started", this->id);
+				RD_LOG_INFO(logger, "{}: accepting started", this->id);
 				
 				// [HACK]: Fix RIDER-51111.
 				// winsock blocking accept hangs after creating new process with createprocess with inheritHandles=true
@@ -582,7 +607,7 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 				RD_ASSERT_THROW_MSG(
 					accepted != nullptr, fmt::format("{}: accepting failed, reason: {}", this->id, ss->DescribeError()));
 				socket.reset(accepted);
-				logger->info("{}: accepted passive socket {}/{}", this->id, socket->GetClientAddr(), socket->GetClientPort());
+				RD_LOG_INFO(logger, "{}: accepted passive socket {}/{}", this->id, socket->GetClientAddr(), socket->GetClientPort());
 				RD_ASSERT_THROW_MSG(socket->DisableNagleAlgoritm(),
 					fmt::format("{}: tcpNoDelay failed, reason: {}", this->id, socket->DescribeError()));
 
@@ -590,54 +615,54 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 					std::lock_guard<decltype(lock)> guard(lock);
 					if (lifetime->is_terminated())
 					{
-						logger->debug("{}: closing passive socket", this->id);
+						RD_LOG_DEBUG(logger, "{}: closing passive socket", this->id);
 						if (!socket->Close())
 						{
-							logger->error("{}: failed to close socket", this->id);
+							RD_LOG_ERROR(logger, "{}: failed to close socket", this->id);
 						}
-						logger->info("{}: close passive socket", this->id);
+						RD_LOG_INFO(logger, "{}: close passive socket", this->id);
 					}
 				}
 
-				logger->debug("{}: setting socket provider", this->id);
+				RD_LOG_DEBUG(logger, "{}: setting socket provider", this->id);
 				set_socket_provider(socket);
 			}
 			catch (std::exception const& e)
 			{
-				logger->info("{}: closed with exception: {}", this->id, e.what());
+				RD_LOG_INFO(logger, "{}: closed with exception: {}", this->id, e.what());
 			}
 		}
-		logger->debug("{}: thread expired", this->id);
+		RD_LOG_DEBUG(logger, "{}: thread expired", this->id);
 	});
 
 	lifetime->add_action([this] {
-		logger->info("{}: start terminating lifetime", this->id);
+		RD_LOG_INFO(logger, "{}: start terminating lifetime", this->id);
 
 		const bool send_buffer_stopped = async_send_buffer.stop(timeout);
-		logger->debug("{}: send buffer stopped, success: {}", this->id, send_buffer_stopped);
+		RD_LOG_DEBUG(logger, "{}: send buffer stopped, success: {}", this->id, send_buffer_stopped);
 
-		logger->debug("{}: closing server socket", this->id);
+		RD_LOG_DEBUG(logger, "{}: closing server socket", this->id);
 		if (!ss->Close())
 		{
-			logger->error("{}: failed to close server socket", this->id);
+			RD_LOG_ERROR(logger, "{}: failed to close server socket", this->id);
 		}
 
 		{
 			std::lock_guard<decltype(lock)> guard(lock);
-			logger->debug("{}: closing socket", this->id);
+			RD_LOG_DEBUG(logger, "{}: closing socket", this->id);
 			if (socket != nullptr)
 			{
 				if (!socket->Close())
 				{
-					logger->error("{}: failed to close socket", this->id);
+					RD_LOG_ERROR(logger, "{}: failed to close socket", this->id);
 				}
 			}
 		}
 
-		logger->debug("{}: waiting for receiver thread", this->id);
-		logger->debug("{}: is thread joinable? {}", this->id, thread.joinable());
+		RD_LOG_DEBUG(logger, "{}: waiting for receiver thread", this->id);
+		RD_LOG_DEBUG(logger, "{}: is thread joinable? {}", this->id, thread.joinable());
 		thread.join();
-		logger->info("{}: termination finished", this->id);
+		RD_LOG_INFO(logger, "{}: termination finished", this->id);
 	});
 }
 
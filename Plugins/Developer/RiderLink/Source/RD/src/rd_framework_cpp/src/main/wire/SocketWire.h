@@ -124,8 +124,14 @@ public:
 
 		bool send0(Buffer::ByteArray const& msg, sequence_number_t seqn) const;
 
+		Buffer::ByteArray pack(RdId const& rd_id, std::function<void(Buffer& buffer)> const& writer) const override;
+
 		void send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const override;
 
+		void send_coalesced(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const override;
+
+		void send_packed(RdId const& rd_id, Buffer::ByteArray message) const override;
+
 		static bool connection_established(int32_t timestamp, int32_t acknowledged_timestamp);
 
 		std::future<void> start_heartbeat(Lifetime lifetime);
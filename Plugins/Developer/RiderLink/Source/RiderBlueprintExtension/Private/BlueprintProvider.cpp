@@ -3,32 +3,151 @@
 #include "Async/Async.h"
 #include "AssetData.h"
 #include "AssetEditorMessages.h"
+#include "AssetRegistryModule.h"
 #include "BlueprintEditor.h"
 #include "MessageEndpointBuilder.h"
 #include "MessageEndpoint.h"
 #include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/PackageName.h"
+#include "Misc/ScopeRWLock.h"
 #if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 23
 #include "Toolkits/AssetEditorManager.h"
 #endif
 
 #include "Runtime/Launch/Resources/Version.h"
+#if ENGINE_MAJOR_VERSION >= 5
+#include "Containers/StringView.h"
+#endif
 
-void BluePrintProvider::AddAsset(FAssetData const& AssetData) {
-#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 23
-    UObject* cls = AssetData.GetAsset();
+#include <atomic>
+
+namespace {
+    // Case-insensitive like the default FString keys, but the hash is computed the same way over a whole string and
+    // over a view into a longer one, so a package name can be looked up without copying it out of an object path.
+    struct FPackageKeyFuncs : TDefaultMapKeyFuncs<FString, FString, false> {
+        using TDefaultMapKeyFuncs<FString, FString, false>::Matches;
+
+        static uint32 HashOf(TCHAR const* Chars, int32 Len) {
+            uint32 Hash = 2166136261u;
+            for (int32 Index = 0; Index < Len; ++Index) {
+                Hash = (Hash ^ static_cast<uint32>(FChar::ToLower(Chars[Index]))) * 16777619u;
+            }
+            return Hash;
+        }
+
+        static uint32 GetKeyHash(FString const& Key) {
+            return HashOf(*Key, Key.Len());
+        }
+
+#if ENGINE_MAJOR_VERSION >= 5
+        static bool Matches(FString const& Key, FStringView View) {
+            return Key.Len() == View.Len() && FCString::Strnicmp(*Key, View.GetData(), View.Len()) == 0;
+        }
+#endif
+    };
+
+    FRWLock IndexLock;
+    // package name -> object path of the blueprint in it
+    TMap<FString, FString, FDefaultSetAllocator, FPackageKeyFuncs> BlueprintPackages;
+    std::atomic<bool> bIndexComplete{false};
+    BluePrintProvider::FOnIndexChanged IndexChanged;
+
+    bool IsBlueprintAsset(FAssetData const& AssetData) {
+        // only the class name is looked up, the asset itself is not loaded
+        UClass* Class = AssetData.GetClass();
+        return Class && Class->IsChildOf(UBlueprint::StaticClass());
+    }
+
+    // Length of "/Game/Dir/BP_Name" in "/Game/Dir/BP_Name.BP_Name_C:Subobject"
+    int32 PackageLength(FString const& Path) {
+        int32 Index = 0;
+        while (Index < Path.Len() && Path[Index] != TEXT('.') && Path[Index] != TEXT(':')) {
+            ++Index;
+        }
+        return Index;
+    }
+
+    // Called for every path-like token of every log line: doesn't allocate and only locks for package paths
+    bool IsIndexedPackage(FString const& Path) {
+        if (Path.IsEmpty() || Path[0] != TEXT('/')) return false;
+
+        const int32 Len = PackageLength(Path);
+#if ENGINE_MAJOR_VERSION >= 5
+        const uint32 Hash = FPackageKeyFuncs::HashOf(*Path, Len);
+        FRWScopeLock Lock(IndexLock, SLT_ReadOnly);
+        return BlueprintPackages.FindByHash(Hash, FStringView(*Path, Len)) != nullptr;
 #else
-    UObject* cls = AssetData.FastGetAsset();
+        FRWScopeLock Lock(IndexLock, SLT_ReadOnly);
+        return Len == Path.Len() ? BlueprintPackages.Contains(Path) : BlueprintPackages.Contains(Path.Left(Len));
 #endif
-    if (cls) {
-        UBlueprint* Blueprint = Cast<UBlueprint>(cls);
-        if (Blueprint && Blueprint->IsValidLowLevel()) {
+    }
+}
 
+void BluePrintProvider::IndexAssets(IAssetRegistry const& AssetRegistry) {
+    TArray<FAssetData> Assets;
+    AssetRegistry.GetAssetsByClass(UBlueprint::StaticClass()->GetFName(), Assets, true);
+    {
+        FRWScopeLock Lock(IndexLock, SLT_Write);
+        BlueprintPackages.Reserve(Assets.Num());
+        for (FAssetData const& AssetData : Assets) {
+            BlueprintPackages.Add(AssetData.PackageName.ToString(), AssetData.ObjectPath.ToString());
         }
     }
+    bIndexComplete = !AssetRegistry.IsLoadingAssets();
+    IndexChanged.Broadcast();
+}
+
+void BluePrintProvider::AddAsset(FAssetData const& AssetData) {
+    if (!IsBlueprintAsset(AssetData)) return;
+
+    {
+        FRWScopeLock Lock(IndexLock, SLT_Write);
+        BlueprintPackages.Add(AssetData.PackageName.ToString(), AssetData.ObjectPath.ToString());
+    }
+    IndexChanged.Broadcast();
+}
+
+void BluePrintProvider::RemoveAsset(FAssetData const& AssetData) {
+    int32 Removed;
+    {
+        FRWScopeLock Lock(IndexLock, SLT_Write);
+        Removed = BlueprintPackages.Remove(AssetData.PackageName.ToString());
+    }
+    if (Removed > 0) IndexChanged.Broadcast();
+}
+
+void BluePrintProvider::RenameAsset(FAssetData const& AssetData, FString const& OldObjectPath) {
+    int32 Removed;
+    {
+        FRWScopeLock Lock(IndexLock, SLT_Write);
+        Removed = BlueprintPackages.Remove(FPackageName::ObjectPathToPackageName(OldObjectPath));
+    }
+    if (Removed > 0) IndexChanged.Broadcast();
+    AddAsset(AssetData);
+}
+
+BluePrintProvider::FOnIndexChanged& BluePrintProvider::OnIndexChanged() {
+    return IndexChanged;
 }
 
 bool BluePrintProvider::IsBlueprint(FString const& pathName) {
-    return FPackageName::IsValidObjectPath(pathName);
+    if (IsIndexedPackage(pathName)) return true;
+    return !bIndexComplete && FPackageName::IsValidObjectPath(pathName);
+}
+
+bool BluePrintProvider::TryGetPathName(FString const& path, FString& OutPathName) {
+    FString Package = path.Left(PackageLength(path));
+    if (!FPackageName::IsValidLongPackageName(Package) &&
+        !FPackageName::TryConvertFilenameToLongPackageName(path, Package)) {
+        return false;
+    }
+
+    FRWScopeLock Lock(IndexLock, SLT_ReadOnly);
+    if (FString const* PathName = BlueprintPackages.Find(Package)) {
+        OutPathName = *PathName;
+        return true;
+    }
+    return false;
 }
 
 void BluePrintProvider::OpenBlueprint(FString const& AssetPathName, TSharedPtr<FMessageEndpoint, ESPMode::ThreadSafe> const& messageEndpoint) {
@@ -3,6 +3,7 @@
 #include "BlueprintProvider.hpp"
 #include "IRiderLink.hpp"
 #include "Model/RdEditorProtocol/RdEditorModel/RdEditorModel.Generated.h"
+#include "task/RdTaskAwait.h"
 
 #include "AssetRegistryModule.h"
 #include "Engine/Blueprint.h"
@@ -10,6 +11,7 @@
 #include "HAL/PlatformProcess.h"
 #include "MessageEndpoint.h"
 #include "MessageEndpointBuilder.h"
+#include "Misc/ScopeLock.h"
 #include "Modules/ModuleManager.h"
 
 #define LOCTEXT_NAMESPACE "RiderLink"
@@ -18,21 +20,31 @@ DEFINE_LOG_CATEGORY(FLogRiderBlueprintExtensionModule);
 
 IMPLEMENT_MODULE(FRiderBlueprintExtensionModule, RiderBlueprintExtension);
 
-static void AllowSetForeGroundForEditor(JetBrains::EditorPlugin::RdEditorModel const & unrealToBackendModel) {
+// Rider asks about the same few paths over and over while highlighting logs and code
+static constexpr size_t PathCacheCapacity = 4096;
+static constexpr std::chrono::milliseconds PathCacheTtl{60000};
+
+template <typename F>
+static void AllowSetForeGroundForEditor(rd::Lifetime Lifetime, JetBrains::EditorPlugin::RdEditorModel const & unrealToBackendModel, F&& OnFinished) {
     static const int32 CurrentProcessId = FPlatformProcess::GetCurrentProcessId();
     try {
-        const rd::WiredRdTask<bool> Task = unrealToBackendModel.get_allowSetForegroundWindow().sync(CurrentProcessId);
-        if (Task.is_faulted()) {
-            UE_LOG(FLogRiderBlueprintExtensionModule, Error, TEXT("AllowSetForeGroundForEditor failed: %hs "), rd::to_string(Task.value_or_throw()).c_str());
-        }
-        else if (Task.is_succeeded()) {
-            if (!(Task.value_or_throw().unwrap())) {
-                UE_LOG(FLogRiderBlueprintExtensionModule, Error, TEXT("AllowSetForeGroundForEditor failed: %hs "), rd::to_string(Task.value_or_throw()).c_str());
-            }
-        }
+        // Don't block the model thread waiting for the IDE, continue when the response arrives
+        rd::advise_result(unrealToBackendModel.get_allowSetForegroundWindow().start(CurrentProcessId), Lifetime, nullptr,
+            [OnFinished = std::forward<F>(OnFinished)](auto const& Result) {
+                if (Result.is_faulted()) {
+                    UE_LOG(FLogRiderBlueprintExtensionModule, Error, TEXT("AllowSetForeGroundForEditor failed: %hs "), rd::to_string(Result).c_str());
+                }
+                else if (Result.is_succeeded()) {
+                    if (!(Result.unwrap())) {
+                        UE_LOG(FLogRiderBlueprintExtensionModule, Error, TEXT("AllowSetForeGroundForEditor failed: %hs "), rd::to_string(Result).c_str());
+                    }
+                }
+                OnFinished();
+            });
     }
     catch (std::exception const &e) {
         UE_LOG(FLogRiderBlueprintExtensionModule, Error, TEXT("AllowSetForeGroundForEditor failed: %hs "), rd::to_string(e).c_str());
+        OnFinished();
     }
 }
 
@@ -47,47 +59,74 @@ void FRiderBlueprintExtensionModule::StartupModule()
 
     MessageEndpoint = FMessageEndpoint::Builder(FName("FAssetEditorManager")).Build();
 
-    AssetRegistryModule->Get().OnAssetAdded().AddLambda([](const FAssetData& AssetData) {
-        // TO-DO: Fix loading uasset's on 4.23-
-        // BluePrintProvider::AddAsset(AssetData);
+    IndexChangedHandle = BluePrintProvider::OnIndexChanged().AddRaw(this, &FRiderBlueprintExtensionModule::InvalidatePathCaches);
+
+    IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+    AssetAddedHandle = AssetRegistry.OnAssetAdded().AddStatic(&BluePrintProvider::AddAsset);
+    AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddStatic(&BluePrintProvider::RemoveAsset);
+    AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddStatic(&BluePrintProvider::RenameAsset);
+    // Assets found before the handlers were added are taken from the registry, once now and once it has finished loading
+    FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddLambda([&AssetRegistry]() {
+        BluePrintProvider::IndexAssets(AssetRegistry);
     });
+    BluePrintProvider::IndexAssets(AssetRegistry);
 
     RiderLinkModule.ViewModel(ModuleLifetimeDef.lifetime, [this] (rd::Lifetime ModelLifetime, JetBrains::EditorPlugin::RdEditorModel const& UnrealToBackendModel)
     {
         UnrealToBackendModel.get_openBlueprint().advise(
             ModelLifetime,
-            [this, &UnrealToBackendModel](
+            [this, ModelLifetime, &UnrealToBackendModel](
             JetBrains::EditorPlugin::BlueprintReference const& s)
             {
-                try
+                AllowSetForeGroundForEditor(ModelLifetime, UnrealToBackendModel, [this, PathName = s.get_pathName()]()
                 {
-                    AllowSetForeGroundForEditor(UnrealToBackendModel);
-
-                    auto Window = FGlobalTabmanager::Get()->GetRootWindow();
-                    if (!Window.IsValid()) return;
-
-                    if (Window->IsWindowMinimized())
+                    try
                     {
-                        Window->Restore();
+                        auto Window = FGlobalTabmanager::Get()->GetRootWindow();
+                        if (!Window.IsValid()) return;
+
+                        if (Window->IsWindowMinimized())
+                        {
+                            Window->Restore();
+                        }
+                        else
+                        {
+                            Window->HACK_ForceToFront();
+                        }
+                        BluePrintProvider::OpenBlueprint(PathName, MessageEndpoint);
                     }
-                    else
+                    catch (std::exception const& e)
                     {
-                        Window->HACK_ForceToFront();
+                        std::cerr << rd::to_string(e);
                     }
-                    BluePrintProvider::OpenBlueprint(
-                        s.get_pathName(), MessageEndpoint);
-                }
-                catch (std::exception const& e)
-                {
-                    std::cerr << rd::to_string(e);
-                }
+                });
             }
         );
 
+        // Answers only change with the blueprint index, which drops the cached ones when it changes
+        UnrealToBackendModel.get_isBlueprintPathName().enable_cache(PathCacheCapacity, PathCacheTtl);
+        UnrealToBackendModel.get_getPathNameByPath().enable_cache(PathCacheCapacity, PathCacheTtl);
+        {
+            FScopeLock Lock(&PathCachesLock);
+            PathCachesModel = &UnrealToBackendModel;
+        }
+        ModelLifetime->add_action([this]()
+        {
+            FScopeLock Lock(&PathCachesLock);
+            PathCachesModel = nullptr;
+        });
+
         UnrealToBackendModel.get_isBlueprintPathName().set([](FString const& pathName) -> bool
         {
             return BluePrintProvider::IsBlueprint(pathName);
         });
+
+        UnrealToBackendModel.get_getPathNameByPath().set([](FString const& path) -> rd::optional<FString>
+        {
+            FString PathName;
+            if (!BluePrintProvider::TryGetPathName(path, PathName)) return rd::nullopt;
+            return PathName;
+        });
     });
     UE_LOG(FLogRiderBlueprintExtensionModule, Verbose, TEXT("STARTUP FINISH"));
 }
@@ -95,6 +134,24 @@ void FRiderBlueprintExtensionModule::StartupModule()
 void FRiderBlueprintExtensionModule::ShutdownModule()
 {
     UE_LOG(FLogRiderBlueprintExtensionModule, Verbose, TEXT("SHUTDOWN START"));
+    if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(AssetRegistryConstants::ModuleName))
+    {
+        IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+        AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+        AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+        AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+        AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+    }
+    BluePrintProvider::OnIndexChanged().Remove(IndexChangedHandle);
     ModuleLifetimeDef.terminate();
     UE_LOG(FLogRiderBlueprintExtensionModule, Verbose, TEXT("SHUTDOWN FINISH"));
 }
+
+void FRiderBlueprintExtensionModule::InvalidatePathCaches()
+{
+    FScopeLock Lock(&PathCachesLock);
+    if (!PathCachesModel) return;
+
+    PathCachesModel->get_isBlueprintPathName().invalidate_cache();
+    PathCachesModel->get_getPathNameByPath().invalidate_cache();
+}
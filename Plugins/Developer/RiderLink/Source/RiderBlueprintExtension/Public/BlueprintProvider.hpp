@@ -4,14 +4,42 @@
 
 struct FAssetData;
 class FMessageEndpoint;
+class IAssetRegistry;
 class UBlueprint;
 
 class RIDERBLUEPRINTEXTENSION_API BluePrintProvider {
 public:
+    DECLARE_MULTICAST_DELEGATE(FOnIndexChanged);
+
+    /**
+     * Blueprint packages are kept in an index, which is filled from the asset registry once and then kept current
+     * with AddAsset, RemoveAsset and RenameAsset. Until it is complete, paths missing from it are only checked for
+     * being valid object paths.
+     */
+    static void IndexAssets(IAssetRegistry const& AssetRegistry);
 
     static void AddAsset(FAssetData const& AssetData);
 
+    static void RemoveAsset(FAssetData const& AssetData);
+
+    static void RenameAsset(FAssetData const& AssetData, FString const& OldObjectPath);
+
+    /**
+     * Broadcast on the thread that changed the index, after the change, whenever IsBlueprint or TryGetPathName may
+     * answer differently than before.
+     */
+    static FOnIndexChanged& OnIndexChanged();
+
+    /**
+     * Whether pathName is in a blueprint package: the package name, the object path or a path of a subobject.
+     * Thread safe.
+     */
     static bool IsBlueprint(FString const& pathName);
 
+    /**
+     * Finds the object path of the blueprint in the package given by its name or file name. Thread safe.
+     */
+    static bool TryGetPathName(FString const& path, FString& OutPathName);
+
     static void OpenBlueprint(FString const& path, TSharedPtr<FMessageEndpoint, ESPMode::ThreadSafe> const& messageEndpoint);
 };
@@ -2,12 +2,19 @@
 
 #include "lifetime/LifetimeDefinition.h"
 
+#include "HAL/CriticalSection.h"
 #include "Logging/LogMacros.h"
 #include "Logging/LogVerbosity.h"
 #include "MessageEndpoint.h"
 #include "Modules/ModuleInterface.h"
 #include "Templates/SharedPointer.h"
 
+namespace JetBrains {
+namespace EditorPlugin {
+class RdEditorModel;
+}
+}
+
 DECLARE_LOG_CATEGORY_EXTERN(FLogRiderBlueprintExtensionModule, Log, All);
 
 class FRiderBlueprintExtensionModule : public IModuleInterface
@@ -21,6 +28,16 @@ public:
     virtual void ShutdownModule() override;
     virtual bool SupportsDynamicReloading() override { return true; };
 private:
+    void InvalidatePathCaches();
+
     TSharedPtr<FMessageEndpoint, ESPMode::ThreadSafe> MessageEndpoint;
+    FDelegateHandle AssetAddedHandle;
+    FDelegateHandle AssetRemovedHandle;
+    FDelegateHandle AssetRenamedHandle;
+    FDelegateHandle FilesLoadedHandle;
+    FDelegateHandle IndexChangedHandle;
+    // model whose path queries are answered from caches, guarded by PathCachesLock
+    FCriticalSection PathCachesLock;
+    JetBrains::EditorPlugin::RdEditorModel const* PathCachesModel = nullptr;
     rd::LifetimeDefinition ModuleLifetimeDef;
 };
@@ -1,5 +1,6 @@
 #include "ProtocolFactory.h"
 
+#include "intern/InternDictionary.h"
 #include "scheduler/base/IScheduler.h"
 #include "wire/SocketWire.h"
 
@@ -10,6 +11,8 @@
 #else
 #include "HAL/PlatformFilemanager.h"
 #endif
+#include "HAL/PlatformProcess.h"
+#include "Interfaces/IPluginManager.h"
 #include "Misc/App.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
@@ -27,6 +30,7 @@
 #endif
 
 #include "spdlog/sinks/daily_file_sink.h"
+#include "util/async_sink.h"
 
 static FString GetLocalAppdataFolder()
 {
@@ -66,6 +70,27 @@ static FString GetPathToPortsFolder()
     return FPaths::Combine(*MiscFilesFolder, TEXT("Ports"));
 }
 
+// Bytes of messages kept in memory until Rider connects to the model, older ones go to a file
+static constexpr size_t ExtWireMemoryLimit = 8 * 1024 * 1024;
+
+static FString GetIntermediateFile(const TCHAR* FileName)
+{
+    const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("RiderLink"));
+    if(!Plugin.IsValid()) return {};
+
+    return FPaths::Combine(Plugin->GetBaseDir(), TEXT("Intermediate"), FileName);
+}
+
+#if defined(ENABLE_INTERN_DICTIONARY) && ENABLE_INTERN_DICTIONARY == 1
+// Strings kept in the intern dictionary between sessions
+static constexpr size_t InternDictionarySize = 1024;
+
+static FString GetInternDictionaryPath()
+{
+    return GetIntermediateFile(TEXT("InternDictionary.bin"));
+}
+#endif
+
 static FString GetProjectName()
 {
     FString ProjectNameNoExtension = FApp::GetProjectName();
@@ -81,14 +106,19 @@ static FString GetLogFile()
 }
 
 
+static std::shared_ptr<rd::util::async_sink> AsyncFileSink;
+
 void ProtocolFactory::InitRdLogging()
 {
     spdlog::set_level(spdlog::level::err);
 #if defined(ENABLE_LOG_FILE) && ENABLE_LOG_FILE == 1
     const FString LogFile = GetLogFile();
     const FString Msg = TEXT("[RiderLink] Path to log file: ") + LogFile;
-    auto FileLogger = std::make_shared<spdlog::sinks::daily_file_sink_mt>(*LogFile, 23, 59);
+    // Writing to the file happens on a separate thread, so logging doesn't slow down the protocol
+    auto FileLogger = std::make_shared<rd::util::async_sink>(
+        std::make_shared<spdlog::sinks::daily_file_sink_mt>(*LogFile, 23, 59));
     FileLogger->set_level(spdlog::level::trace);
+    AsyncFileSink = FileLogger;
     spdlog::apply_all([FileLogger](std::shared_ptr<spdlog::logger> Logger)
     {
         Logger->sinks().push_back(FileLogger);
@@ -96,6 +126,14 @@ void ProtocolFactory::InitRdLogging()
 #endif
 }
 
+void ProtocolFactory::ShutdownRdLogging()
+{
+    if (AsyncFileSink)
+    {
+        AsyncFileSink->stop();
+    }
+}
+
 std::shared_ptr<rd::SocketWire::Server> ProtocolFactory::CreateWire(rd::IScheduler* Scheduler, rd::Lifetime SocketLifetime)
 {
     const FString ProjectName = GetProjectName();
@@ -110,6 +148,13 @@ TUniquePtr<rd::Protocol> ProtocolFactory::CreateProtocol(rd::IScheduler* Schedul
     const FString ProjectName = GetProjectName();
 
     auto protocol = MakeUnique<rd::Protocol>(rd::Identities::SERVER, Scheduler, wire, SocketLifetime);
+#if defined(ENABLE_INTERN_DICTIONARY) && ENABLE_INTERN_DICTIONARY == 1
+    const FString InternDictionaryPath = GetInternDictionaryPath();
+    if (!InternDictionaryPath.IsEmpty())
+    {
+        protocol->set_intern_dictionary(rd::InternDictionary::load(TCHAR_TO_UTF8(*InternDictionaryPath)));
+    }
+#endif
 
     auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
     const FString PortFullDirectoryPath = GetPathToPortsFolder();
@@ -123,3 +168,27 @@ TUniquePtr<rd::Protocol> ProtocolFactory::CreateProtocol(rd::IScheduler* Schedul
     }
     return protocol;
 }
+
+void ProtocolFactory::SaveInternDictionary(rd::Protocol const& Protocol)
+{
+#if defined(ENABLE_INTERN_DICTIONARY) && ENABLE_INTERN_DICTIONARY == 1
+    const FString InternDictionaryPath = GetInternDictionaryPath();
+    if (InternDictionaryPath.IsEmpty()) return;
+
+    const std::vector<std::wstring> Strings = Protocol.frequent_interned_strings(InternDictionarySize);
+    if (Strings.empty()) return;
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(InternDictionaryPath), true);
+    rd::InternDictionary::save(TCHAR_TO_UTF8(*InternDictionaryPath), Strings);
+#endif
+}
+
+void ProtocolFactory::InitExtWire(rd::ExtWire& Wire)
+{
+    Wire.memory_limit = ExtWireMemoryLimit;
+    const FString SpillPath = GetIntermediateFile(*FString::Printf(TEXT("ExtWireQueue-%u.bin"), FPlatformProcess::GetCurrentProcessId()));
+    if (SpillPath.IsEmpty()) return;
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(SpillPath), true);
+    Wire.spill_path = TCHAR_TO_UTF8(*SpillPath);
+}
@@ -1,12 +1,16 @@
 ﻿#pragma once
 
 #include <protocol/Protocol.h>
+#include "ext/ExtWire.h"
 #include "wire/SocketWire.h"
 
 #include "Templates/UniquePtr.h"
 
 namespace ProtocolFactory {
     void InitRdLogging();
+    void ShutdownRdLogging();
     std::shared_ptr<rd::SocketWire::Server> CreateWire(rd::IScheduler* Scheduler, rd::Lifetime SocketLifetime);
     TUniquePtr<rd::Protocol> CreateProtocol(rd::IScheduler* Scheduler, rd::Lifetime SocketLifetime, std::shared_ptr<rd::SocketWire::Server> wire);
+    void SaveInternDictionary(rd::Protocol const& Protocol);
+    void InitExtWire(rd::ExtWire& Wire);
 };
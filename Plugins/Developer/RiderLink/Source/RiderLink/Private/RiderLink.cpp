@@ -3,7 +3,9 @@
 #include "ProtocolFactory.h"
 #include "UE4Library/UE4Library.Generated.h"
 
-#include "Misc/ScopeRWLock.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeExit.h"
+#include "Misc/ScopeLock.h"
 #include "Modules/ModuleManager.h"
 #include "HAL/Platform.h"
 
@@ -16,7 +18,13 @@ IMPLEMENT_MODULE(FRiderLinkModule, RiderLink);
 void FRiderLinkModule::ShutdownModule()
 {
 	UE_LOG(FLogRiderLinkModule, Verbose, TEXT("RiderLink SHUTDOWN START"));
+	if (Protocol.IsValid())
+	{
+		ProtocolFactory::SaveInternDictionary(*Protocol);
+	}
+	RetireLiveModel();
 	ModuleLifetimeDef.terminate();
+	ProtocolFactory::ShutdownRdLogging();
 	UE_LOG(FLogRiderLinkModule, Verbose, TEXT("RiderLink SHUTDOWN FINISH"));
 }
 
@@ -54,9 +62,14 @@ void FRiderLinkModule::InitProtocol()
 		{
 			if (!IsConnected) return;
 
-			FRWScopeLock LockOnConnect(ModelLock, SLT_Write);
+			RetireLiveModel();
 			EditorModel = MakeUnique<JetBrains::EditorPlugin::RdEditorModel>();
+			ProtocolFactory::InitExtWire(EditorModel->get_ext_wire());
 			EditorModel->connect(ConnectionLifetime, Protocol.Get());
+			// Until Rider receives the model only the last value of a property is worth sending, play state and mode changes
+			// are events and all of them are kept
+			EditorModel->get_ext_wire().keep_latest(
+				dynamic_cast<rd::RdPropertyBase<bool> const&>(EditorModel->get_isGameControlModuleInitialized()));
 			JetBrains::EditorPlugin::UE4Library::serializersOwner.registerSerializersCore(
 				EditorModel->get_serialization_context().get_serializers()
 			);
@@ -64,15 +77,29 @@ void FRiderLinkModule::InitProtocol()
 			{
 				Scheduler.queue([&]()mutable
 				{
-                    FRWScopeLock LockOnDisconnect(ModelLock, SLT_Write);
-                    RdIsModelAlive.set(false);
+					RetireLiveModel();
+					RdIsModelAlive.set(false);
 				});
 			});
 			RdIsModelAlive.set(true);
+			LiveModel.store(EditorModel.Get());
 		});
 	});
 }
 
+void FRiderLinkModule::RetireLiveModel()
+{
+	FScopeLock Lock(&RetireLock);
+	LiveModel.store(nullptr);
+	// readers that come in after the flip count in the other slot and see no model,
+	// so only the slot of the readers already inside drains, however busy FireAsyncAction is
+	const uint32 Epoch = LiveModelEpoch.fetch_add(1);
+	while (LiveModelReaders[Epoch % 2].load() != 0)
+	{
+		FPlatformProcess::Yield();
+	}
+}
+
 bool FRiderLinkModule::SupportsDynamicReloading() { return true; }
 
 
@@ -100,14 +127,24 @@ void FRiderLinkModule::QueueAction(TFunction<void()> Handler)
 
 bool FRiderLinkModule::FireAsyncAction(TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Handler)
 {
-	FRWScopeLock Lock(ModelLock, SLT_ReadOnly);
-	if(!RdIsModelAlive.has_value()) return false;
-	
-	if(RdIsModelAlive.get())
+	uint32 Epoch;
+	for (;;)
 	{
-		Handler(*EditorModel.Get());
+		Epoch = LiveModelEpoch.load();
+		++LiveModelReaders[Epoch % 2];
+		// a retire that flipped the epoch in between may not wait for this slot any more
+		if (LiveModelEpoch.load() == Epoch) break;
+		--LiveModelReaders[Epoch % 2];
 	}
-	return RdIsModelAlive.get();
+	ON_SCOPE_EXIT
+	{
+		--LiveModelReaders[Epoch % 2];
+	};
+	JetBrains::EditorPlugin::RdEditorModel const* Model = LiveModel.load();
+	if (Model == nullptr) return false;
+
+	Handler(*Model);
+	return true;
 }
 
 #undef LOCTEXT_NAMESPACE
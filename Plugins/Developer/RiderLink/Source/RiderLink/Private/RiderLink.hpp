@@ -7,11 +7,14 @@
 #include "wire/SocketWire.h"
 
 #include "Logging/LogMacros.h"
+#include "HAL/CriticalSection.h"
 #include "Logging/LogVerbosity.h"
 #include "Modules/ModuleManager.h"
 
 #include "RdEditorModel/RdEditorModel.Generated.h"
 
+#include <atomic>
+
 namespace rd
 {
 	class Protocol;
@@ -43,6 +46,7 @@ public:
 
 private:
 	void InitProtocol();
+	void RetireLiveModel();
 
 	rd::LifetimeDefinition ModuleLifetimeDef{rd::Lifetime::Eternal()};
 	rd::SingleThreadScheduler Scheduler{ModuleLifetimeDef.lifetime, "MainScheduler"};
@@ -50,5 +54,11 @@ private:
 	TUniquePtr<rd::Protocol> Protocol;
 	rd::RdProperty<bool> RdIsModelAlive;
 	TUniquePtr<JetBrains::EditorPlugin::RdEditorModel> EditorModel;
-	FRWLock ModelLock;
+	// EditorModel while it is connected, read by FireAsyncAction on any thread without locking.
+	// Readers are counted in the slot of the current epoch, so the model is not replaced or freed while one of them
+	// still uses it. Retiring the model flips the epoch and waits for the old slot only.
+	std::atomic<JetBrains::EditorPlugin::RdEditorModel const*> LiveModel{nullptr};
+	std::atomic<uint32> LiveModelEpoch{0};
+	std::atomic<int32> LiveModelReaders[2] = {{0}, {0}};
+	FCriticalSection RetireLock;
 };
@@ -17,12 +17,15 @@ public class RiderLink : ModuleRules
 
 		PublicDependencyModuleNames.Add("Core");
 		PublicDependencyModuleNames.Add("RD");
+		PrivateDependencyModuleNames.Add("Projects");
 		string[] Paths = {
 			"Public/Model/Library",
 			"Public/Model/RdEditorProtocol",
 		};
 		
 		PrivateDefinitions.Add("ENABLE_LOG_FILE=0");
+		// Rider doesn't announce intern dictionaries yet, so they are neither loaded nor saved by default
+		PrivateDefinitions.Add("ENABLE_INTERN_DICTIONARY=0");
 
 		foreach(var Item in Paths)
 		{
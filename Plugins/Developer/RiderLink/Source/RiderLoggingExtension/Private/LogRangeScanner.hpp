@@ -0,0 +1,124 @@
+#pragma once
+
+#include "CoreTypes.h"
+
+namespace LoggingExtensionImpl
+{
+/**
+ * Finds the ranges that the patterns
+ *   [^\s]*\/[^\s]+                           (paths)
+ *   [0-9a-z_A-Z]+::~?[0-9a-z_A-Z]+          (methods)
+ * match in a log line, in one pass and without allocating. The ranges are the ones FRegexMatcher::FindNext reports
+ * for these patterns, with \s being the Unicode White_Space property as in ICU.
+ *
+ * Both patterns only match inside a run of non-space characters: a path is such a run with a '/' before its last
+ * character, and a method starts at the first word character of a word run followed by "::".
+ */
+class FLogRangeScanner
+{
+	enum : uint8
+	{
+		Word = 1,
+		Space = 2,
+		Slash = 4,
+		Colon = 8,
+		Tilde = 16
+	};
+
+	static uint8 ClassOf(TCHAR C)
+	{
+		struct FTable
+		{
+			uint8 Classes[128] = {};
+
+			FTable()
+			{
+				for (int32 Char = '0'; Char <= '9'; ++Char) Classes[Char] = Word;
+				for (int32 Char = 'a'; Char <= 'z'; ++Char) Classes[Char] = Word;
+				for (int32 Char = 'A'; Char <= 'Z'; ++Char) Classes[Char] = Word;
+				Classes['_'] = Word;
+				for (int32 Char = 0x09; Char <= 0x0D; ++Char) Classes[Char] = Space;
+				Classes[' '] = Space;
+				Classes['/'] = Slash;
+				Classes[':'] = Colon;
+				Classes['~'] = Tilde;
+			}
+		};
+		static const FTable Table;
+
+		const uint32 Code = static_cast<uint32>(C);
+		if (Code < 128) return Table.Classes[Code];
+		return IsUnicodeSpace(Code) ? Space : 0;
+	}
+
+	static bool IsUnicodeSpace(uint32 Code)
+	{
+		return Code == 0x85 || Code == 0xA0 || Code == 0x1680 || (Code >= 0x2000 && Code <= 0x200A) ||
+			Code == 0x2028 || Code == 0x2029 || Code == 0x202F || Code == 0x205F || Code == 0x3000;
+	}
+
+	// If "::~?name" starts at Text[Separator], returns the end of the name, otherwise -1
+	static int32 MatchMethodName(const TCHAR* Text, int32 Separator, int32 Length)
+	{
+		if (Separator + 1 >= Length || !(ClassOf(Text[Separator + 1]) & Colon)) return -1;
+
+		int32 Name = Separator + 2;
+		if (Name < Length && ClassOf(Text[Name]) & Tilde) ++Name;
+		if (Name >= Length || !(ClassOf(Text[Name]) & Word)) return -1;
+
+		int32 NameEnd = Name + 1;
+		while (NameEnd < Length && ClassOf(Text[NameEnd]) & Word) ++NameEnd;
+		return NameEnd;
+	}
+
+public:
+	/**
+	 * Calls OnPath(Begin, End) and OnMethod(Begin, End) for the matches in Text[0, Length), in order of their position.
+	 */
+	template <typename FPathFunc, typename FMethodFunc>
+	static void Scan(const TCHAR* Text, int32 Length, FPathFunc&& OnPath, FMethodFunc&& OnMethod)
+	{
+		int32 Index = 0;
+		while (Index < Length)
+		{
+			if (ClassOf(Text[Index]) & Space)
+			{
+				++Index;
+				continue;
+			}
+
+			const int32 TokenBegin = Index;
+			int32 FirstSlash = -1;
+			// start of the word run a method match would begin with
+			int32 MethodBegin = -1;
+			for (; Index < Length; ++Index)
+			{
+				const uint8 Class = ClassOf(Text[Index]);
+				if (Class & Space) break;
+				if (Class & Slash && FirstSlash < 0) FirstSlash = Index;
+
+				if (Class & Word)
+				{
+					if (MethodBegin < 0) MethodBegin = Index;
+					continue;
+				}
+				if (MethodBegin >= 0 && Class & Colon)
+				{
+					const int32 NameEnd = MatchMethodName(Text, Index, Length);
+					if (NameEnd >= 0)
+					{
+						OnMethod(MethodBegin, NameEnd);
+						// the match holds no slashes or spaces, and the search for the next one resumes after it
+						Index = NameEnd - 1;
+					}
+				}
+				MethodBegin = -1;
+			}
+			if (FirstSlash >= 0 && FirstSlash + 1 < Index)
+			{
+				OnPath(TokenBegin, Index);
+			}
+		}
+	}
+};
+}
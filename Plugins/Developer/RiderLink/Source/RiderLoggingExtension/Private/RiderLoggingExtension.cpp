@@ -2,92 +2,380 @@
 
 #include "BlueprintProvider.hpp"
 #include "IRiderLink.hpp"
+#include "LogRangeScanner.hpp"
 #include "Model/Library/UE4Library/LogMessageInfo.Generated.h"
 #include "Model/Library/UE4Library/StringRange.Generated.h"
 #include "Model/Library/UE4Library/UnrealLogEvent.Generated.h"
 
-#include "Internationalization/Regex.h"
+#include "HAL/PlatformTime.h"
 #include "Misc/DateTime.h"
+#include "Misc/ScopeLock.h"
 #include "Modules/ModuleManager.h"
 
+#include "reactive/Timer.h"
+
+#include <atomic>
+#include <unordered_map>
+
 #define LOCTEXT_NAMESPACE "RiderLink"
 
 DEFINE_LOG_CATEGORY(FLogRiderLoggingExtensionModule);
 
 IMPLEMENT_MODULE(FRiderLoggingExtensionModule, RiderLoggingExtension);
 
+FRiderLoggingExtensionModule::FRiderLoggingExtensionModule() = default;
+
+FRiderLoggingExtensionModule::~FRiderLoggingExtensionModule() = default;
+
 namespace LoggingExtensionImpl
 {
-static TArray<rd::Wrapper<JetBrains::EditorPlugin::StringRange>> GetPathRanges(
-	const FRegexPattern& Pattern,
-	const FString& Str)
+// Lines longer than this are sent as several events
+static constexpr int32 MaxChunkLength = 1024;
+// A batch is sent once it holds this much text, or is this old, or no more messages are queued.
+// While anything is pending, the batcher is also flushed this often when nothing is logged.
+static constexpr int32 FlushBatchBytes = 64 * 1024;
+static constexpr double FlushBatchSeconds = 0.05;
+// A line repeated within this time after it was sent is only counted, and the count is sent when the time is over
+static constexpr double RepeatWindowSeconds = 1.0;
+static constexpr int32 MaxRecentLines = 4096;
+// Token bucket per category: lines over the rate are dropped and reported at most once per interval
+static constexpr double CategoryLinesPerSecond = 1000;
+static constexpr double CategoryLineBurst = 5000;
+static constexpr double SuppressedReportSeconds = 1.0;
+
+/**
+ * Log lines waiting to be sent to Rider together. Lines of the same message share one LogMessageInfo.
+ * Repeated lines are collapsed into one with a repeat count, and every category is rate limited.
+ * Only used on the logging scheduler, except for the statistics counters.
+ */
+class FLogBatcher
 {
-	using JetBrains::EditorPlugin::StringRange;
-	FRegexMatcher Matcher(Pattern, Str);
-	TArray<rd::Wrapper<StringRange>> Ranges;
-	while (Matcher.FindNext())
-	{
-		const int Start = Matcher.GetMatchBeginning();
-		const int End = Matcher.GetMatchEnding();
-		FString PathName = Str.Mid(Start, End - Start - 1);
-		if (BluePrintProvider::IsBlueprint(PathName))
-			Ranges.Emplace(StringRange(Start, End));
+	struct FPendingLine
+	{
+		int32 InfoIndex;
+		FString Text;
+		TArray<rd::Wrapper<JetBrains::EditorPlugin::StringRange>> PathRanges;
+		TArray<rd::Wrapper<JetBrains::EditorPlugin::StringRange>> MethodRanges;
+		int32 RepeatCount;
+	};
+
+	struct FLineKey
+	{
+		ELogVerbosity::Type Type;
+		FString Category;
+		FString Text;
+
+		bool operator==(const FLineKey& Other) const
+		{
+			return Type == Other.Type && Category.Equals(Other.Category, ESearchCase::CaseSensitive) &&
+				Text.Equals(Other.Text, ESearchCase::CaseSensitive);
+		}
+
+		friend uint32 GetTypeHash(const FLineKey& Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Key.Text), GetTypeHash(Key.Category)), ::GetTypeHash(static_cast<int32>(Key.Type)));
+		}
+	};
+
+	struct FRecentLine
+	{
+		JetBrains::EditorPlugin::LogMessageInfo Info;
+		double SentAt;
+		// the line in Lines that repeats are added to, while the batch it is in is pending
+		int32 Batch;
+		int32 Line;
+		int32 Unsent;
+	};
+
+	struct FCategoryBucket
+	{
+		double Tokens;
+		double RefilledAt;
+		double ReportedAt;
+		int32 Suppressed;
+	};
+
+public:
+	void Add(const JetBrains::EditorPlugin::LogMessageInfo& MessageInfo, const FString& Message)
+	{
+		const double Now = FPlatformTime::Seconds();
+		const TCHAR* Line = *Message;
+		const TCHAR* const End = Line + Message.Len();
+		while (Line < End)
+		{
+			const TCHAR* LineEnd = Line;
+			while (LineEnd < End && *LineEnd != TEXT('\n'))
+			{
+				++LineEnd;
+			}
+			for (const TCHAR* Chunk = Line; Chunk < LineEnd; Chunk += MaxChunkLength)
+			{
+				AddLine(MessageInfo, Chunk, FMath::Min<int32>(MaxChunkLength, LineEnd - Chunk), Now);
+			}
+			if (LineEnd == End) break;
+			Line = LineEnd + 1;
+		}
 	}
-	return Ranges;
-}
 
-static TArray<rd::Wrapper<JetBrains::EditorPlugin::StringRange>> GetMethodRanges(
-	const FRegexPattern& Pattern,
-	const FString& Str)
-{
-	using JetBrains::EditorPlugin::StringRange;
-	FRegexMatcher Matcher(Pattern, Str);
-	TArray<rd::Wrapper<StringRange>> Ranges;
-	while (Matcher.FindNext())
+	// Lines, repeat counts or suppressed lines that a later flush still has to send
+	bool HasPending() const
 	{
-		Ranges.Emplace(StringRange(Matcher.GetMatchBeginning(), Matcher.GetMatchEnding()));
+		if (Lines.Num() > 0 || RecentLines.Num() > 0) return true;
+		for (const auto& Entry : Buckets)
+		{
+			if (Entry.Value.Suppressed > 0) return true;
+		}
+		return false;
 	}
-	return Ranges;
-}
 
-static const FRegexPattern PathPattern = FRegexPattern(TEXT("[^\\s]*/[^\\s]+"));
-static const FRegexPattern MethodPattern = FRegexPattern(TEXT("[0-9a-z_A-Z]+::~?[0-9a-z_A-Z]+"));
+	bool ShouldFlush() const
+	{
+		return PendingBytes >= FlushBatchBytes ||
+			(Lines.Num() > 0 && FPlatformTime::Seconds() - OpenedAt >= FlushBatchSeconds);
+	}
 
-static bool SendMessageToRider(const JetBrains::EditorPlugin::LogMessageInfo& MessageInfo, const FString& Message)
-{
-	return IRiderLinkModule::Get().FireAsyncAction(
-	[&MessageInfo, &Message] (JetBrains::EditorPlugin::RdEditorModel const& RdEditorModel)
-	{
-		rd::ISignal<JetBrains::EditorPlugin::UnrealLogEvent> const& UnrealLog = RdEditorModel.get_unrealLog();
-		UnrealLog.fire({
-			MessageInfo,
-			Message,
-			GetPathRanges(PathPattern, Message),
-			GetMethodRanges(MethodPattern, Message)
+	void Flush()
+	{
+		const double Now = FPlatformTime::Seconds();
+		SendRepeatCounts(Now);
+		ReportSuppressed(Now);
+		if (Lines.Num() == 0) return;
+
+		// The model has no batched log event yet, so every line is its own UnrealLogEvent
+		IRiderLinkModule::Get().FireAsyncAction(
+		[this] (JetBrains::EditorPlugin::RdEditorModel const& RdEditorModel)
+		{
+			rd::ISignal<JetBrains::EditorPlugin::UnrealLogEvent> const& UnrealLog = RdEditorModel.get_unrealLog();
+			for (FPendingLine& Pending : Lines)
+			{
+				// UnrealLogEvent has no repeat count, so it goes into the text after the ranges
+				if (Pending.RepeatCount > 1)
+				{
+					Pending.Text += FString::Printf(TEXT(" (x%d)"), Pending.RepeatCount);
+				}
+				UnrealLog.fire({
+					Infos[Pending.InfoIndex],
+					MoveTemp(Pending.Text),
+					MoveTemp(Pending.PathRanges),
+					MoveTemp(Pending.MethodRanges)
+				});
+			}
 		});
-	});
-}
+		Infos.Reset();
+		Lines.Reset();
+		InfoIndexes.clear();
+		PendingBytes = 0;
+		++Batch;
+	}
 
-void SendMessageInChunks(FString* Msg, const JetBrains::EditorPlugin::LogMessageInfo& MessageInfo)
-{
-	static int NUMBER_OF_CHUNKS = 1024;
-	while (!Msg->IsEmpty())
+	void LogStatistics() const
 	{
-		SendMessageToRider(MessageInfo, Msg->Left(NUMBER_OF_CHUNKS));
-		*Msg = Msg->RightChop(NUMBER_OF_CHUNKS);
+		UE_LOG(FLogRiderLoggingExtensionModule, Verbose, TEXT("Collapsed %llu repeated log lines, dropped %llu over the category rate"),
+			CollapsedLines.load(std::memory_order_relaxed), SuppressedLines.load(std::memory_order_relaxed));
+
+		const double Megabytes = ScannedBytes.load(std::memory_order_relaxed) / (1024.0 * 1024.0);
+		const double Seconds = FPlatformTime::ToSeconds64(ScanCycles.load(std::memory_order_relaxed));
+		if (Seconds > 0)
+		{
+			UE_LOG(FLogRiderLoggingExtensionModule, Verbose, TEXT("Scanned %.1f MB of log text for links at %.1f MB/s"),
+				Megabytes, Megabytes / Seconds);
+		}
 	}
-}
 
-void ScheduledSendMessage(FString* Msg, const JetBrains::EditorPlugin::LogMessageInfo& MessageInfo)
+private:
+	void AddLine(const JetBrains::EditorPlugin::LogMessageInfo& MessageInfo, const TCHAR* Text, int32 Length, double Now)
+	{
+		FLineKey Key{MessageInfo.get_type(), MessageInfo.get_category(), FString(Length, Text)};
+		FRecentLine* Recent = RecentLines.Find(Key);
+		if (Recent && Now - Recent->SentAt < RepeatWindowSeconds)
+		{
+			if (Recent->Batch == Batch)
+			{
+				++Lines[Recent->Line].RepeatCount;
+			}
+			else
+			{
+				Recent->Info = MessageInfo;
+				++Recent->Unsent;
+			}
+			CollapsedLines.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		if (!TakeToken(MessageInfo.get_category(), Now))
+		{
+			SuppressedLines.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		// a line seen again after its window also carries the repeats that were not sent yet
+		const int32 RepeatCount = Recent ? 1 + Recent->Unsent : 1;
+		const int32 Line = AddPending(MessageInfo, Key.Text, RepeatCount, Now);
+		if (Recent)
+		{
+			*Recent = FRecentLine{MessageInfo, Now, Batch, Line, 0};
+		}
+		else if (RecentLines.Num() < MaxRecentLines)
+		{
+			RecentLines.Add(MoveTemp(Key), FRecentLine{MessageInfo, Now, Batch, Line, 0});
+		}
+	}
+
+	bool TakeToken(const FString& Category, double Now)
+	{
+		FCategoryBucket* Bucket = Buckets.Find(Category);
+		if (!Bucket)
+		{
+			Bucket = &Buckets.Add(Category, FCategoryBucket{CategoryLineBurst, Now, Now, 0});
+		}
+		Bucket->Tokens = FMath::Min(CategoryLineBurst, Bucket->Tokens + (Now - Bucket->RefilledAt) * CategoryLinesPerSecond);
+		Bucket->RefilledAt = Now;
+		if (Bucket->Tokens < 1)
+		{
+			++Bucket->Suppressed;
+			return false;
+		}
+		Bucket->Tokens -= 1;
+		return true;
+	}
+
+	// Sends the repeats of lines whose window is over, and forgets those lines
+	void SendRepeatCounts(double Now)
+	{
+		for (auto It = RecentLines.CreateIterator(); It; ++It)
+		{
+			FRecentLine& Recent = It.Value();
+			if (Now - Recent.SentAt < RepeatWindowSeconds) continue;
+
+			if (Recent.Unsent > 0)
+			{
+				AddPending(Recent.Info, It.Key().Text, Recent.Unsent, Now);
+			}
+			It.RemoveCurrent();
+		}
+	}
+
+	void ReportSuppressed(double Now)
+	{
+		for (auto& Entry : Buckets)
+		{
+			FCategoryBucket& Bucket = Entry.Value;
+			if (Bucket.Suppressed == 0 || Now - Bucket.ReportedAt < SuppressedReportSeconds) continue;
+
+			const JetBrains::EditorPlugin::LogMessageInfo Info{ELogVerbosity::Warning, Entry.Key, rd::optional<rd::DateTime>()};
+			AddPending(Info, FString::Printf(TEXT("RiderLink: %d lines of %s were not sent, the category logs more than %.0f lines per second"),
+				Bucket.Suppressed, *Entry.Key, CategoryLinesPerSecond), 1, Now);
+			Bucket.Suppressed = 0;
+			Bucket.ReportedAt = Now;
+		}
+	}
+
+	int32 IndexOf(const JetBrains::EditorPlugin::LogMessageInfo& MessageInfo)
+	{
+		const auto It = InfoIndexes.find(MessageInfo);
+		if (It != InfoIndexes.end()) return It->second;
+
+		const int32 Index = Infos.Emplace(MessageInfo);
+		InfoIndexes.emplace(MessageInfo, Index);
+		return Index;
+	}
+
+	int32 AddPending(const JetBrains::EditorPlugin::LogMessageInfo& MessageInfo, const FString& Text, int32 RepeatCount, double Now)
+	{
+		using JetBrains::EditorPlugin::StringRange;
+		if (Lines.Num() == 0)
+		{
+			OpenedAt = Now;
+		}
+		TArray<rd::Wrapper<StringRange>> PathRanges;
+		TArray<rd::Wrapper<StringRange>> MethodRanges;
+		const uint64 ScanStart = FPlatformTime::Cycles64();
+		FLogRangeScanner::Scan(*Text, Text.Len(),
+		[this, &Text, &PathRanges](int32 Begin, int32 End)
+		{
+			PathName.Reset();
+			PathName.AppendChars(*Text + Begin, End - Begin - 1);
+			if (BluePrintProvider::IsBlueprint(PathName))
+				PathRanges.Emplace(StringRange(Begin, End));
+		},
+		[&MethodRanges](int32 Begin, int32 End)
+		{
+			MethodRanges.Emplace(StringRange(Begin, End));
+		});
+		ScanCycles.fetch_add(FPlatformTime::Cycles64() - ScanStart, std::memory_order_relaxed);
+		ScannedBytes.fetch_add(Text.Len() * sizeof(TCHAR), std::memory_order_relaxed);
+		PendingBytes += Text.Len() * static_cast<int32>(sizeof(TCHAR));
+		return Lines.Add(FPendingLine{IndexOf(MessageInfo), Text, MoveTemp(PathRanges), MoveTemp(MethodRanges), RepeatCount});
+	}
+
+	TArray<rd::Wrapper<JetBrains::EditorPlugin::LogMessageInfo>> Infos;
+	TArray<FPendingLine> Lines;
+	std::unordered_map<JetBrains::EditorPlugin::LogMessageInfo, int32, rd::hash<JetBrains::EditorPlugin::LogMessageInfo>> InfoIndexes;
+	int32 PendingBytes = 0;
+	double OpenedAt = 0;
+	// number of the pending batch
+	int32 Batch = 0;
+	TMap<FLineKey, FRecentLine> RecentLines;
+	TMap<FString, FCategoryBucket> Buckets;
+	// reused for the blueprint check of path candidates
+	FString PathName;
+	std::atomic<uint64> CollapsedLines{0};
+	std::atomic<uint64> SuppressedLines{0};
+	std::atomic<uint64> ScannedBytes{0};
+	std::atomic<uint64> ScanCycles{0};
+};
+
+/**
+ * Flushes the batcher on the logging scheduler every FlushBatchSeconds while it has something pending, so the last
+ * lines of a burst, repeat counts and suppressed line reports are sent even when nothing else is logged.
+ */
+class FFlushTimer final : public rd::Timer::Task
 {
-	FString ToSend;
-	while (Msg->Split("\n", &ToSend, Msg))
+public:
+	FFlushTimer(rd::IScheduler& Scheduler, FLogBatcher& Batcher) : Scheduler(Scheduler), Batcher(Batcher)
 	{
-		SendMessageInChunks(&ToSend, MessageInfo);
 	}
 
-	SendMessageInChunks(Msg, MessageInfo);
-}
+	// Called on the logging scheduler after the batcher was changed
+	void Arm()
+	{
+		FScopeLock Lock(&CriticalSection);
+		if (bArmed || bStopped || !Batcher.HasPending()) return;
+
+		bArmed = true;
+		rd::Timer::shared().schedule(this, rd::Timer::clock::now() +
+			std::chrono::duration_cast<rd::Timer::clock::duration>(std::chrono::duration<double>(FlushBatchSeconds)));
+	}
+
+	void Stop()
+	{
+		{
+			FScopeLock Lock(&CriticalSection);
+			bStopped = true;
+		}
+		rd::Timer::shared().cancel(this);
+	}
+
+	virtual void on_timer() override
+	{
+		Scheduler.queue([this]()
+		{
+			{
+				FScopeLock Lock(&CriticalSection);
+				bArmed = false;
+			}
+			Batcher.Flush();
+			Arm();
+		});
+	}
+
+private:
+	rd::IScheduler& Scheduler;
+	FLogBatcher& Batcher;
+	FCriticalSection CriticalSection;
+	bool bArmed = false;
+	bool bStopped = false;
+};
 }
 
 
@@ -103,6 +391,8 @@ void FRiderLoggingExtensionModule::StartupModule()
 
 	ModuleLifetimeDef = IRiderLinkModule::Get().CreateNestedLifetimeDefinition();
 	LoggingScheduler = MakeUnique<rd::SingleThreadScheduler>(ModuleLifetimeDef.lifetime, "LoggingScheduler");
+	Batcher = MakeUnique<LoggingExtensionImpl::FLogBatcher>();
+	FlushTimer = MakeUnique<LoggingExtensionImpl::FFlushTimer>(*LoggingScheduler, *Batcher);
 	ModuleLifetimeDef.lifetime->bracket(
 	[this]()
 	{
@@ -118,9 +408,16 @@ void FRiderLoggingExtensionModule::StartupModule()
 			}
 			const FString PlainName = Name.GetPlainNameString();
 			const JetBrains::EditorPlugin::LogMessageInfo MessageInfo{Type, PlainName, DateTime};
-			LoggingScheduler->queue([Msg = FString(msg), MessageInfo]() mutable
+			++QueuedMessages;
+			LoggingScheduler->queue([this, Msg = FString(msg), MessageInfo]()
 			{
-				LoggingExtensionImpl::ScheduledSendMessage(&Msg, MessageInfo);
+				Batcher->Add(MessageInfo, Msg);
+				// the last queued message sends whatever has piled up, so a burst goes out in a few batches
+				if (--QueuedMessages == 0 || Batcher->ShouldFlush())
+				{
+					Batcher->Flush();
+				}
+				FlushTimer->Arm();
 			});
 		});
 	},
@@ -128,6 +425,7 @@ void FRiderLoggingExtensionModule::StartupModule()
 	{
 		if (OutputDevice.onSerializeMessage.IsBound())
 			OutputDevice.onSerializeMessage.Unbind();
+		FlushTimer->Stop();
 	});
 
 	UE_LOG(FLogRiderLoggingExtensionModule, Verbose, TEXT("STARTUP FINISH"));
@@ -136,6 +434,8 @@ void FRiderLoggingExtensionModule::StartupModule()
 void FRiderLoggingExtensionModule::ShutdownModule()
 {
 	UE_LOG(FLogRiderLoggingExtensionModule, Verbose, TEXT("SHUTDOWN START"));
+	if (Batcher)
+		Batcher->LogStatistics();
 	ModuleLifetimeDef.terminate();
 	UE_LOG(FLogRiderLoggingExtensionModule, Verbose, TEXT("SHUTDOWN FINISH"));
 }
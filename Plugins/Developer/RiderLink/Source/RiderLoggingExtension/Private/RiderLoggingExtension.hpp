@@ -11,13 +11,21 @@
 #include "Modules/ModuleInterface.h"
 #include "scheduler/SingleThreadScheduler.h"
 
+#include <atomic>
+
 DECLARE_LOG_CATEGORY_EXTERN(FLogRiderLoggingExtensionModule, Log, All);
 
+namespace LoggingExtensionImpl
+{
+class FLogBatcher;
+class FFlushTimer;
+}
+
 class FRiderLoggingExtensionModule : public IModuleInterface
 {
 public:
-    FRiderLoggingExtensionModule() = default;
-    virtual ~FRiderLoggingExtensionModule() override = default;
+    FRiderLoggingExtensionModule();
+    virtual ~FRiderLoggingExtensionModule() override;
 
     /** IModuleInterface implementation */
     virtual void StartupModule() override;
@@ -25,7 +33,11 @@ public:
     virtual bool SupportsDynamicReloading() override { return true; }
 
 private:
+    // declared first, so they outlive the tasks still queued on the scheduler
+    TUniquePtr<LoggingExtensionImpl::FLogBatcher> Batcher;
+    TUniquePtr<LoggingExtensionImpl::FFlushTimer> FlushTimer;
     TUniquePtr<rd::SingleThreadScheduler> LoggingScheduler;
+    std::atomic<int32> QueuedMessages{0};
     FRiderOutputDevice OutputDevice;
     rd::LifetimeDefinition ModuleLifetimeDef;
 };
@@ -0,0 +1,220 @@
+#include "LogRangeScanner.hpp"
+
+#include "HAL/PlatformTime.h"
+#include "Interfaces/IPluginManager.h"
+#include "Internationalization/Regex.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace LoggingExtensionImpl
+{
+namespace Tests
+{
+using FRanges = TArray<TPair<int32, int32>>;
+
+// The patterns FLogRangeScanner replaced
+static const TCHAR* PathPattern = TEXT("[^\\s]*/[^\\s]+");
+static const TCHAR* MethodPattern = TEXT("[0-9a-z_A-Z]+::~?[0-9a-z_A-Z]+");
+
+static FRanges FindWithRegex(const FRegexPattern& Pattern, const FString& Line)
+{
+	FRegexMatcher Matcher(Pattern, Line);
+	FRanges Ranges;
+	while (Matcher.FindNext())
+	{
+		Ranges.Emplace(Matcher.GetMatchBeginning(), Matcher.GetMatchEnding());
+	}
+	return Ranges;
+}
+
+static void FindWithScanner(const FString& Line, FRanges& Paths, FRanges& Methods)
+{
+	FLogRangeScanner::Scan(*Line, Line.Len(),
+	[&Paths](int32 Begin, int32 End)
+	{
+		Paths.Emplace(Begin, End);
+	},
+	[&Methods](int32 Begin, int32 End)
+	{
+		Methods.Emplace(Begin, End);
+	});
+}
+
+static FString Describe(const FRanges& Ranges)
+{
+	FString Result;
+	for (const TPair<int32, int32>& Range : Ranges)
+	{
+		Result += FString::Printf(TEXT("[%d, %d) "), Range.Key, Range.Value);
+	}
+	return Result.IsEmpty() ? TEXT("none") : Result;
+}
+
+// \t is a tab and \uXXXX a UTF-16 code unit, everything else is taken as is
+static FString Decode(const FString& Line)
+{
+	FString Result;
+	Result.Reserve(Line.Len());
+	for (int32 Index = 0; Index < Line.Len(); ++Index)
+	{
+		if (Line[Index] == TEXT('\\') && Index + 1 < Line.Len() && Line[Index + 1] == TEXT('t'))
+		{
+			Result.AppendChar(TEXT('\t'));
+			++Index;
+		}
+		else if (Line[Index] == TEXT('\\') && Index + 5 < Line.Len() && Line[Index + 1] == TEXT('u'))
+		{
+			Result.AppendChar(static_cast<TCHAR>(FParse::HexNumber(*Line.Mid(Index + 2, 4))));
+			Index += 5;
+		}
+		else
+		{
+			Result.AppendChar(Line[Index]);
+		}
+	}
+	return Result;
+}
+
+static bool LoadCorpus(FAutomationTestBase& Test, TArray<FString>& Lines)
+{
+	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("RiderLink"));
+	if (!Plugin.IsValid())
+	{
+		Test.AddError(TEXT("RiderLink plugin not found"));
+		return false;
+	}
+
+	const FString CorpusPath = FPaths::Combine(
+		Plugin->GetBaseDir(), TEXT("Source"), TEXT("RiderLoggingExtension"), TEXT("Private"), TEXT("Tests"), TEXT("LogRangeCorpus.txt"));
+	TArray<FString> FileLines;
+	if (!FFileHelper::LoadFileToStringArray(FileLines, *CorpusPath))
+	{
+		Test.AddError(FString::Printf(TEXT("Can't read %s"), *CorpusPath));
+		return false;
+	}
+	for (const FString& Line : FileLines)
+	{
+		if (Line.IsEmpty() || Line[0] == TEXT('#')) continue;
+		Lines.Add(Decode(Line));
+	}
+	return true;
+}
+
+// Short lines of the characters the patterns care about, white space of all kinds and a surrogate pair
+static TArray<FString> MakeRandomLines(int32 Count)
+{
+	const TArray<TCHAR> Alphabet = {
+		TEXT('a'), TEXT('Z'), TEXT('_'), TEXT('0'), TEXT('/'), TEXT(':'), TEXT(':'), TEXT('~'), TEXT(' '), TEXT('\t'),
+		TEXT('.'), TEXT('\\'), TEXT('('), 0x000B, 0x001C, 0x0085, 0x00A0, 0x00C4, 0x200B, 0x2028, 0x3000, 0xD83D, 0xDE00
+	};
+	FRandomStream Random(46);
+	TArray<FString> Lines;
+	for (int32 LineIndex = 0; LineIndex < Count; ++LineIndex)
+	{
+		FString Line;
+		const int32 Length = Random.RandRange(0, 24);
+		for (int32 Index = 0; Index < Length; ++Index)
+		{
+			Line.AppendChar(Alphabet[Random.RandRange(0, Alphabet.Num() - 1)]);
+		}
+		Lines.Add(MoveTemp(Line));
+	}
+	return Lines;
+}
+}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLogRangeScannerMatchesRegexTest, "RiderLink.LoggingExtension.LogRangeScanner.MatchesRegex",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FLogRangeScannerMatchesRegexTest::RunTest(const FString& Parameters)
+{
+	using namespace LoggingExtensionImpl::Tests;
+
+	TArray<FString> Lines;
+	if (!LoadCorpus(*this, Lines)) return false;
+	Lines.Append(MakeRandomLines(20000));
+
+	const FRegexPattern Path(PathPattern);
+	const FRegexPattern Method(MethodPattern);
+	int32 Mismatches = 0;
+	for (const FString& Line : Lines)
+	{
+		FRanges Paths, Methods;
+		FindWithScanner(Line, Paths, Methods);
+		const FRanges RegexPaths = FindWithRegex(Path, Line);
+		const FRanges RegexMethods = FindWithRegex(Method, Line);
+		if (Paths != RegexPaths)
+		{
+			AddError(FString::Printf(TEXT("Paths of \"%s\": scanner %s, regex %s"), *Line.ReplaceCharWithEscapedChar(),
+				*Describe(Paths), *Describe(RegexPaths)));
+		}
+		if (Methods != RegexMethods)
+		{
+			AddError(FString::Printf(TEXT("Methods of \"%s\": scanner %s, regex %s"), *Line.ReplaceCharWithEscapedChar(),
+				*Describe(Methods), *Describe(RegexMethods)));
+		}
+		if ((Paths != RegexPaths || Methods != RegexMethods) && ++Mismatches == 20)
+		{
+			AddError(TEXT("Too many mismatches, stopping"));
+			break;
+		}
+	}
+	return Mismatches == 0;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLogRangeScannerThroughputTest, "RiderLink.LoggingExtension.LogRangeScanner.Throughput",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FLogRangeScannerThroughputTest::RunTest(const FString& Parameters)
+{
+	using namespace LoggingExtensionImpl::Tests;
+
+	TArray<FString> Lines;
+	if (!LoadCorpus(*this, Lines)) return false;
+
+	int64 Bytes = 0;
+	for (const FString& Line : Lines)
+	{
+		Bytes += Line.Len() * sizeof(TCHAR);
+	}
+	const int32 Rounds = FMath::Max<int32>(1, static_cast<int32>(8 * 1024 * 1024 / FMath::Max<int64>(Bytes, 1)));
+	const double Megabytes = static_cast<double>(Bytes) * Rounds / (1024.0 * 1024.0);
+
+	int64 Found = 0;
+	double Start = FPlatformTime::Seconds();
+	for (int32 Round = 0; Round < Rounds; ++Round)
+	{
+		for (const FString& Line : Lines)
+		{
+			FRanges Paths, Methods;
+			FindWithScanner(Line, Paths, Methods);
+			Found += Paths.Num() + Methods.Num();
+		}
+	}
+	const double ScannerSeconds = FPlatformTime::Seconds() - Start;
+
+	const FRegexPattern Path(PathPattern);
+	const FRegexPattern Method(MethodPattern);
+	Start = FPlatformTime::Seconds();
+	for (int32 Round = 0; Round < Rounds; ++Round)
+	{
+		for (const FString& Line : Lines)
+		{
+			Found -= FindWithRegex(Path, Line).Num() + FindWithRegex(Method, Line).Num();
+		}
+	}
+	const double RegexSeconds = FPlatformTime::Seconds() - Start;
+
+	AddInfo(FString::Printf(TEXT("%.1f MB of log lines: FLogRangeScanner %.1f MB/s, FRegexMatcher %.1f MB/s"), Megabytes,
+		Megabytes / FMath::Max(ScannerSeconds, 1e-9), Megabytes / FMath::Max(RegexSeconds, 1e-9)));
+	TestTrue(TEXT("Scanner and regex find the same number of ranges"), Found == 0);
+	return true;
+}
+
+#endif
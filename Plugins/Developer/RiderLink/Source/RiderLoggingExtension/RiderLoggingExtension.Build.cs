@@ -19,7 +19,8 @@ public class RiderLoggingExtension : ModuleRules
 			"Core",
 			"RD",
 			"RiderLink",
-			"RiderBlueprintExtension"
+			"RiderBlueprintExtension",
+			"Projects"
 		});
 	}
 }
@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>
+
+#include "lifetime/LifetimeDefinition.h"
+
+#include <vector>
+
+using namespace rd;
+
+static void BM_LifetimeNestedTerminate(benchmark::State& state)
+{
+	LifetimeDefinition outer;
+	std::vector<std::unique_ptr<LifetimeDefinition>> definitions;
+	for (auto _ : state)
+	{
+		for (int64_t i = 0; i < state.range(0); ++i)
+		{
+			definitions.push_back(std::make_unique<LifetimeDefinition>(outer.lifetime));
+		}
+		definitions.clear();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LifetimeNestedTerminate)->Arg(1000)->Arg(10000);
+
+// The pattern of WiredRdTaskImpl: each call adds a cancellation action and removes it when the task is destroyed.
+static void BM_LifetimeRemoveAction(benchmark::State& state)
+{
+	LifetimeDefinition definition;
+	std::vector<LifetimeImpl::ActionHandle> handles;
+	for (auto _ : state)
+	{
+		for (int64_t i = 0; i < state.range(0); ++i)
+		{
+			handles.push_back(definition.lifetime->add_action([] {}));
+		}
+		for (auto const& handle : handles)
+		{
+			definition.lifetime->remove_action(handle);
+		}
+		handles.clear();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LifetimeRemoveAction)->Arg(1000)->Arg(10000);
@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include "reactive/base/SignalX.h"
+#include "lifetime/LifetimeDefinition.h"
+
+using namespace rd;
+
+static void BM_SignalFire(benchmark::State& state)
+{
+	Signal<int> signal;
+	LifetimeDefinition definition;
+	int64_t sum = 0;
+	for (int64_t i = 0; i < state.range(0); ++i)
+	{
+		signal.advise(definition.lifetime, [&sum](int const& value) { sum += value; });
+	}
+	for (auto _ : state)
+	{
+		signal.fire(1);
+	}
+	benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(BM_SignalFire)->Arg(0)->Arg(1)->Arg(10)->Arg(1000);
+
+// Every round terminates the listeners it advised, so the array is regularly compacted.
+static void BM_SignalAdviseTerminate(benchmark::State& state)
+{
+	Signal<int> signal;
+	LifetimeDefinition outer;
+	for (auto _ : state)
+	{
+		LifetimeDefinition definition(outer.lifetime);
+		for (int64_t i = 0; i < state.range(0); ++i)
+		{
+			signal.advise(definition.lifetime, [](int const&) {});
+		}
+	}
+}
+BENCHMARK(BM_SignalAdviseTerminate)->Arg(1)->Arg(100);
@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include "reactive/ViewableMap.h"
+
+#include <random>
+#include <vector>
+
+using namespace rd;
+
+static void BM_ViewableMapSetRemove(benchmark::State& state)
+{
+	ViewableMap<int, int> map;
+	const int size = static_cast<int>(state.range(0));
+	for (auto _ : state)
+	{
+		for (int i = 0; i < size; ++i)
+		{
+			map.set(i, i);
+		}
+		for (int i = 0; i < size; ++i)
+		{
+			map.remove(i);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ViewableMapSetRemove)->Arg(1000)->Arg(100000);
+
+static void BM_ViewableMapRandomGet(benchmark::State& state)
+{
+	ViewableMap<int, int> map;
+	const int size = static_cast<int>(state.range(0));
+	for (int i = 0; i < size; ++i)
+	{
+		map.set(i, i);
+	}
+	std::mt19937 random(42);
+	std::vector<int> keys(4096);
+	for (auto& key : keys)
+	{
+		key = static_cast<int>(random() % size);
+	}
+	size_t next = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(map.get(keys[next++ % keys.size()]));
+	}
+}
+BENCHMARK(BM_ViewableMapRandomGet)->Arg(1000)->Arg(100000);
+
+static void BM_ViewableMapView(benchmark::State& state)
+{
+	const int size = static_cast<int>(state.range(0));
+	for (auto _ : state)
+	{
+		ViewableMap<int, int> map;
+		LifetimeDefinition definition;
+		int64_t views = 0;
+		map.view(definition.lifetime, [&views](Lifetime, std::pair<int const*, int const*>) { ++views; });
+		for (int i = 0; i < size; ++i)
+		{
+			map.set(i, i);
+		}
+		for (int i = 0; i < size; ++i)
+		{
+			map.remove(i);
+		}
+		benchmark::DoNotOptimize(views);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ViewableMapView)->Arg(10000);
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include "util/append_only_vector.h"
+
+#include <string>
+
+using namespace rd;
+using namespace rd::util;
+
+// segments of 4 elements, so the ring of segments wraps and grows quickly
+using small_vector = append_only_vector<std::string, 2>;
+
+TEST(append_only_vector, push_and_read)
+{
+	small_vector vector;
+	for (int i = 0; i < 100; ++i)
+	{
+		EXPECT_EQ(static_cast<size_t>(i), vector.push_back(std::to_string(i)));
+	}
+	EXPECT_EQ(100u, vector.size());
+	for (int i = 0; i < 100; ++i)
+	{
+		EXPECT_EQ(std::to_string(i), vector[i]);
+	}
+	EXPECT_EQ(nullptr, vector.find(100));
+}
+
+TEST(append_only_vector, set_skips_indexes)
+{
+	small_vector vector;
+	EXPECT_TRUE(vector.set(9, "9"));
+	EXPECT_EQ(10u, vector.size());
+	EXPECT_EQ("9", vector[9]);
+	EXPECT_EQ("", vector[8]);
+	EXPECT_EQ(nullptr, vector.find(3));
+}
+
+TEST(append_only_vector, free_below)
+{
+	small_vector vector;
+	for (int i = 0; i < 10; ++i)
+	{
+		vector.push_back(std::to_string(i));
+	}
+	// only whole segments are freed
+	vector.free_below(6);
+	EXPECT_EQ(nullptr, vector.find(3));
+	EXPECT_EQ("4", vector[4]);
+	EXPECT_EQ(10u, vector.size());
+	EXPECT_FALSE(vector.set(2, "2"));
+
+	// a sliding window reuses the slots of freed segments, elements keep their indexes
+	for (size_t i = 10; i < 1000; ++i)
+	{
+		vector.push_back(std::to_string(i));
+		if (i % 10 == 0)
+		{
+			vector.free_below(i - 10);
+		}
+	}
+	EXPECT_EQ(nullptr, vector.find(979));
+	for (int i = 980; i < 1000; ++i)
+	{
+		EXPECT_EQ(std::to_string(i), vector[i]);
+	}
+
+	vector.clear();
+	EXPECT_EQ(0u, vector.size());
+	EXPECT_EQ(0u, vector.push_back("0"));
+	EXPECT_EQ("0", vector[0]);
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include "lifetime/LifetimeDefinition.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+TEST(lifetime, actions_run_in_reverse_order)
+{
+	std::vector<int> log;
+	{
+		LifetimeDefinition definition;
+		for (int i = 0; i < 3; ++i)
+		{
+			definition.lifetime->add_action([&log, i] { log.push_back(i); });
+		}
+		EXPECT_TRUE(log.empty());
+	}
+
+	EXPECT_EQ((std::vector<int>{2, 1, 0}), log);
+}
+
+// Enough removals to sweep the tombstones several times; handles of surviving actions stay valid.
+TEST(lifetime, remove_action)
+{
+	std::vector<int> log;
+	LifetimeDefinition definition;
+	std::vector<LifetimeImpl::ActionHandle> handles;
+	for (int i = 0; i < 1000; ++i)
+	{
+		handles.push_back(definition.lifetime->add_action([&log, i] { log.push_back(i); }));
+	}
+	for (int i = 0; i < 1000; ++i)
+	{
+		if (i % 10 != 0)
+		{
+			definition.lifetime->remove_action(handles[i]);
+			definition.lifetime->add_action([] {});
+			definition.lifetime->remove_action(definition.lifetime->add_action([&log] { log.push_back(-1); }));
+		}
+	}
+	definition.lifetime->remove_action(handles[1]);
+	definition.terminate();
+
+	std::vector<int> expected;
+	for (int i = 990; i >= 0; i -= 10)
+	{
+		expected.push_back(i);
+	}
+	EXPECT_EQ(expected, log);
+}
+
+TEST(lifetime, remove_action_after_terminate)
+{
+	int32_t calls = 0;
+	LifetimeDefinition definition;
+	auto handle = definition.lifetime->add_action([&calls] { ++calls; });
+	definition.terminate();
+	definition.lifetime->remove_action(handle);
+
+	EXPECT_EQ(1, calls);
+}
+
+TEST(lifetime, eternal_remove_action)
+{
+	int32_t calls = 0;
+	auto handle = Lifetime::Eternal()->add_action([&calls] { ++calls; });
+	Lifetime::Eternal()->remove_action(handle);
+
+	EXPECT_EQ(0, calls);
+}
+
+TEST(lifetime, nested_terminated_first)
+{
+	std::vector<int> log;
+	LifetimeDefinition parent;
+	parent.lifetime->add_action([&log] { log.push_back(0); });
+	LifetimeDefinition child(parent.lifetime);
+	child.lifetime->add_action([&log] { log.push_back(1); });
+	parent.lifetime->add_action([&log] { log.push_back(2); });
+
+	child.terminate();
+	EXPECT_EQ((std::vector<int>{1}), log);
+	parent.terminate();
+	EXPECT_EQ((std::vector<int>{1, 2, 0}), log);
+}
+
+// A nested lifetime detaching itself while the last reference to its parent goes away on another thread.
+TEST(lifetime, nested_terminate_races_parent_release)
+{
+	for (int round = 0; round < 200; ++round)
+	{
+		auto parent = std::make_unique<LifetimeDefinition>();
+		std::vector<std::unique_ptr<LifetimeDefinition>> children;
+		for (int i = 0; i < 16; ++i)
+		{
+			children.push_back(std::make_unique<LifetimeDefinition>(parent->lifetime));
+		}
+
+		std::thread release([&parent] { parent.reset(); });
+		for (auto& child : children)
+		{
+			child->terminate();
+		}
+		release.join();
+	}
+}
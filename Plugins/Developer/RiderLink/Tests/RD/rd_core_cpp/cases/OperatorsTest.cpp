@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include "reactive/operators.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+using namespace rd;
+using namespace rd::reactive;
+
+namespace
+{
+/**
+ * \brief Scheduler which keeps queued actions until the test runs them, so timed operators emit only at known points.
+ */
+class ManualScheduler
+{
+	std::mutex lock;
+	std::condition_variable cv;
+	std::deque<std::function<void()>> actions;
+
+public:
+	void queue(std::function<void()> action)
+	{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			actions.push_back(std::move(action));
+		}
+		cv.notify_all();
+	}
+
+	/**
+	 * \brief Waits up to [timeout] for an action to be queued without running it.
+	 */
+	bool wait_queued(std::chrono::milliseconds timeout = std::chrono::seconds(10))
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		return cv.wait_for(guard, timeout, [this] { return !actions.empty(); });
+	}
+
+	/**
+	 * \brief Waits up to [timeout] for an action to be queued, then runs all queued actions on the calling thread.
+	 * \return number of actions run.
+	 */
+	size_t run_queued(std::chrono::milliseconds timeout = std::chrono::seconds(10))
+	{
+		std::deque<std::function<void()>> ready;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			cv.wait_for(guard, timeout, [this] { return !actions.empty(); });
+			ready.swap(actions);
+		}
+		for (auto& action : ready)
+		{
+			action();
+		}
+		return ready.size();
+	}
+};
+
+const auto period = std::chrono::milliseconds(20);
+
+template <typename T>
+class Log
+{
+public:
+	std::vector<T> values;
+
+	Log(Lifetime lifetime, ISource<T> const& source)
+	{
+		source.advise(lifetime, [this](T const& value) { values.push_back(value); });
+	}
+};
+}	 // namespace
+
+TEST(operators, map_filter_distinct)
+{
+	LifetimeDefinition definition;
+	Signal<int> source;
+	auto doubled = map(definition.lifetime, source, [](int value) { return value * 2; });
+	auto big = filter(definition.lifetime, *doubled, [](int value) { return value > 2; });
+	auto changed = distinct_until_changed(definition.lifetime, *big);
+	Log<int> doubled_log(definition.lifetime, *doubled);
+	Log<int> changed_log(definition.lifetime, *changed);
+
+	for (int value : {1, 2, 2, 3, 3, 2})
+	{
+		source.fire(value);
+	}
+	EXPECT_EQ((std::vector<int>{2, 4, 4, 6, 6, 4}), doubled_log.values);
+	EXPECT_EQ((std::vector<int>{4, 6, 4}), changed_log.values);
+
+	definition.terminate();
+	source.fire(5);
+	EXPECT_EQ(6u, doubled_log.values.size());
+}
+
+TEST(operators, buffer_count)
+{
+	LifetimeDefinition definition;
+	Signal<int> source;
+	auto groups = buffer(definition.lifetime, source, 3);
+	Log<std::vector<int>> log(definition.lifetime, *groups);
+
+	for (int value = 1; value <= 7; ++value)
+	{
+		source.fire(value);
+	}
+	EXPECT_EQ((std::vector<std::vector<int>>{{1, 2, 3}, {4, 5, 6}}), log.values);
+}
+
+TEST(operators, debounce)
+{
+	Timer timer;
+	ManualScheduler scheduler;
+	LifetimeDefinition definition;
+	Signal<int> source;
+	auto latest = debounce(definition.lifetime, source, scheduler, period, timer);
+	Log<int> log(definition.lifetime, *latest);
+
+	source.fire(1);
+	source.fire(2);
+	source.fire(3);
+	EXPECT_TRUE(log.values.empty());
+	EXPECT_EQ(1u, scheduler.run_queued());
+	EXPECT_EQ((std::vector<int>{3}), log.values);
+
+	source.fire(4);
+	EXPECT_EQ(1u, scheduler.run_queued());
+	EXPECT_EQ((std::vector<int>{3, 4}), log.values);
+
+	definition.terminate();
+}
+
+TEST(operators, throttle)
+{
+	Timer timer;
+	ManualScheduler scheduler;
+	LifetimeDefinition definition;
+	Signal<int> source;
+	auto throttled = throttle(definition.lifetime, source, scheduler, period, timer);
+	Log<int> log(definition.lifetime, *throttled);
+
+	// even the first value of a window is emitted on the scheduler
+	source.fire(1);
+	EXPECT_TRUE(log.values.empty());
+	EXPECT_EQ(1u, scheduler.run_queued());
+	EXPECT_EQ((std::vector<int>{1}), log.values);
+
+	// within the window only the latest value is kept
+	source.fire(2);
+	source.fire(3);
+	EXPECT_EQ(1u, scheduler.run_queued());
+	EXPECT_EQ((std::vector<int>{1, 3}), log.values);
+
+	// a window without values closes it, the next value opens a new one
+	EXPECT_EQ(1u, scheduler.run_queued());
+	source.fire(4);
+	EXPECT_EQ(1u, scheduler.run_queued());
+	EXPECT_EQ((std::vector<int>{1, 3, 4}), log.values);
+
+	definition.terminate();
+}
+
+TEST(operators, buffer_period)
+{
+	Timer timer;
+	ManualScheduler scheduler;
+	LifetimeDefinition definition;
+	Signal<int> source;
+	auto groups = buffer(definition.lifetime, source, scheduler, period, timer);
+	Log<std::vector<int>> log(definition.lifetime, *groups);
+
+	source.fire(1);
+	source.fire(2);
+	EXPECT_EQ(1u, scheduler.run_queued());
+	source.fire(3);
+	EXPECT_EQ(1u, scheduler.run_queued());
+	EXPECT_EQ((std::vector<std::vector<int>>{{1, 2}, {3}}), log.values);
+
+	definition.terminate();
+}
+
+// terminating the lifetime drops the ticks already queued and disarms the timer
+TEST(operators, termination)
+{
+	Timer timer;
+	ManualScheduler scheduler;
+	Signal<int> source;
+	std::vector<std::vector<int>> buffered;
+	std::vector<int> debounced;
+
+	LifetimeDefinition buffer_definition;
+	auto groups = buffer(buffer_definition.lifetime, source, scheduler, period, timer);
+	groups->advise(Lifetime::Eternal(), [&buffered](std::vector<int> const& value) { buffered.push_back(value); });
+	source.fire(1);
+	ASSERT_TRUE(scheduler.wait_queued());
+	buffer_definition.terminate();
+	EXPECT_EQ(1u, scheduler.run_queued());
+	EXPECT_TRUE(buffered.empty());
+
+	LifetimeDefinition debounce_definition;
+	const auto long_period = std::chrono::milliseconds(300);
+	auto latest = debounce(debounce_definition.lifetime, source, scheduler, long_period, timer);
+	latest->advise(Lifetime::Eternal(), [&debounced](int const& value) { debounced.push_back(value); });
+	source.fire(2);
+	debounce_definition.terminate();
+	EXPECT_EQ(0u, scheduler.run_queued(long_period * 2));
+	source.fire(3);
+	EXPECT_EQ(0u, scheduler.run_queued(long_period * 2));
+	EXPECT_TRUE(debounced.empty());
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include "reactive/base/SignalX.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+TEST(signal, advise_and_terminate)
+{
+	Signal<int> signal;
+	std::vector<int> log;
+	{
+		LifetimeDefinition definition;
+		signal.advise(definition.lifetime, [&log](int const& value) { log.push_back(value); });
+		signal.fire(1);
+		signal.fire(2);
+	}
+	signal.fire(3);
+
+	EXPECT_EQ((std::vector<int>{1, 2}), log);
+}
+
+TEST(signal, priority_listeners_fire_first)
+{
+	Signal<int> signal;
+	std::vector<int> log;
+	signal.advise(Lifetime::Eternal(), [&log](int const& value) { log.push_back(value); });
+	priorityAdviseSection([&] { signal.advise(Lifetime::Eternal(), [&log](int const& value) { log.push_back(-value); }); });
+	signal.fire(1);
+
+	EXPECT_EQ((std::vector<int>{-1, 1}), log);
+}
+
+// Advising from a handler outgrows the array several times while the fire still walks the first one, which must stay alive.
+TEST(signal, advise_during_fire_replaces_array)
+{
+	Signal<int> signal;
+	LifetimeDefinition definition;
+	std::vector<int> log;
+	int32_t added = 0;
+	signal.advise(definition.lifetime, [&](int const& value) {
+		log.push_back(value);
+		for (int i = 0; i < 100; ++i)
+		{
+			signal.advise(definition.lifetime, [&added](int const&) { ++added; });
+		}
+	});
+	signal.advise(definition.lifetime, [&log](int const& value) { log.push_back(-value); });
+
+	signal.fire(1);
+	EXPECT_EQ((std::vector<int>{1, -1}), log);
+	EXPECT_EQ(0, added);
+
+	signal.fire(2);
+	EXPECT_EQ((std::vector<int>{1, -1, 2, -2}), log);
+	EXPECT_EQ(100, added);
+}
+
+// Terminated listeners are dropped when the array is compacted, including the one being executed.
+TEST(signal, compaction_during_fire_drops_terminated_listeners)
+{
+	Signal<int> signal;
+	LifetimeDefinition outer;
+	std::vector<std::unique_ptr<LifetimeDefinition>> definitions;
+	int32_t calls = 0;
+	for (int i = 0; i < 8; ++i)
+	{
+		definitions.push_back(std::make_unique<LifetimeDefinition>(outer.lifetime));
+		signal.advise(definitions.back()->lifetime, [&, i](int const&) {
+			++calls;
+			definitions[i]->terminate();
+			for (int j = 0; j < 16; ++j)
+			{
+				signal.advise(outer.lifetime, [&calls](int const&) { ++calls; });
+			}
+		});
+	}
+
+	signal.fire(0);
+	EXPECT_EQ(8, calls);
+
+	calls = 0;
+	signal.fire(0);
+	EXPECT_EQ(8 * 16, calls);
+}
+
+TEST(signal, concurrent_fire_and_advise)
+{
+	Signal<int> signal;
+	std::atomic<bool> done{false};
+	std::atomic<int64_t> received{0};
+
+	std::vector<std::thread> firing;
+	for (int t = 0; t < 2; ++t)
+	{
+		firing.emplace_back([&] {
+			while (!done)
+			{
+				signal.fire(1);
+			}
+		});
+	}
+
+	LifetimeDefinition outer;
+	for (int round = 0; round < 200; ++round)
+	{
+		LifetimeDefinition definition(outer.lifetime);
+		for (int i = 0; i < 20; ++i)
+		{
+			signal.advise(definition.lifetime, [&received](int const& value) { received += value; });
+		}
+	}
+	std::atomic<int64_t> after{0};
+	signal.advise(outer.lifetime, [&after](int const& value) { after += value; });
+	while (after == 0)
+	{
+		std::this_thread::yield();
+	}
+	done = true;
+	for (auto& thread : firing)
+	{
+		thread.join();
+	}
+
+	signal.fire(1);
+	EXPECT_GT(after, 0);
+}
+
+// Arrays replaced during a fire are freed when it finishes, with no later advise. Every array holding the listener keeps
+// a copy of its token.
+TEST(signal, replaced_arrays_freed_after_fire)
+{
+	Signal<int> signal;
+	LifetimeDefinition definition;
+	auto token = std::make_shared<int>(0);
+	signal.advise(definition.lifetime, [token](int const&) {});
+	bool advised = false;
+	signal.advise(definition.lifetime, [&](int const&) {
+		if (!advised)
+		{
+			advised = true;
+			for (int i = 0; i < 20; ++i)
+			{
+				signal.advise(definition.lifetime, [](int const&) {});
+			}
+		}
+	});
+
+	signal.fire(0);
+	// held here and by the current array
+	EXPECT_EQ(2, token.use_count());
+}
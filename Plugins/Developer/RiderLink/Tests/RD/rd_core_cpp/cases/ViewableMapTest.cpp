@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include "reactive/ViewableMap.h"
+#include "reactive/ViewableSet.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace rd;
+
+static_assert(ViewableMap<int, int>::inline_storage, "ViewableMap<int, int> is expected to store its entries in place");
+
+// Insertion order, values and events of the in-place storage against a vector model, with erased entries recycled.
+TEST(viewable_map, inline_storage_matches_model)
+{
+	ViewableMap<int, int> map;
+	std::vector<std::pair<int, int>> model;
+	std::map<int, int> mirror;
+	std::map<int, int> viewed;
+	LifetimeDefinition definition;
+	map.advise(definition.lifetime, [&mirror](ViewableMap<int, int>::Event const& e) {
+		if (e.get_new_value() != nullptr)
+		{
+			mirror[*e.get_key()] = *e.get_new_value();
+		}
+		else
+		{
+			EXPECT_EQ(mirror.at(*e.get_key()), *e.get_old_value());
+			mirror.erase(*e.get_key());
+		}
+	});
+	map.view(definition.lifetime, [&viewed](Lifetime lifetime, std::pair<int const*, int const*> entry) {
+		const int key = *entry.first;
+		viewed[key] = *entry.second;
+		lifetime->add_action([&viewed, key] { viewed.erase(key); });
+	});
+
+	std::mt19937 random(42);
+	for (int step = 0; step < 20000; ++step)
+	{
+		const int key = static_cast<int>(random() % 300);
+		auto it = std::find_if(model.begin(), model.end(), [key](std::pair<int, int> const& entry) { return entry.first == key; });
+		if (random() % 3 == 0)
+		{
+			const bool removed = static_cast<bool>(map.remove(key));
+			EXPECT_EQ(it != model.end(), removed);
+			if (it != model.end())
+			{
+				model.erase(it);
+			}
+		}
+		else
+		{
+			const int value = static_cast<int>(random());
+			map.set(key, value);
+			if (it != model.end())
+			{
+				it->second = value;
+			}
+			else
+			{
+				model.emplace_back(key, value);
+			}
+		}
+	}
+
+	std::vector<std::pair<int, int>> actual;
+	for (auto it = map.begin(); it != map.end(); ++it)
+	{
+		actual.emplace_back(it.key(), it.value());
+	}
+	EXPECT_EQ(model, actual);
+	EXPECT_EQ((std::map<int, int>(model.begin(), model.end())), mirror);
+	EXPECT_EQ(mirror, viewed);
+	for (auto const& entry : model)
+	{
+		ASSERT_NE(nullptr, map.get(entry.first));
+		EXPECT_EQ(entry.second, *map.get(entry.first));
+	}
+}
+
+TEST(viewable_set, inline_storage_matches_model)
+{
+	ViewableSet<int> set;
+	std::vector<int> model;
+	std::mt19937 random(7);
+	for (int step = 0; step < 20000; ++step)
+	{
+		const int value = static_cast<int>(random() % 300);
+		auto it = std::find(model.begin(), model.end(), value);
+		if (random() % 2 == 0)
+		{
+			EXPECT_EQ(it != model.end(), set.remove(value));
+			if (it != model.end())
+			{
+				model.erase(it);
+			}
+		}
+		else
+		{
+			EXPECT_EQ(it == model.end(), set.add(value));
+			if (it == model.end())
+			{
+				model.push_back(value);
+			}
+		}
+	}
+
+	EXPECT_EQ(model, std::vector<int>(set.begin(), set.end()));
+}
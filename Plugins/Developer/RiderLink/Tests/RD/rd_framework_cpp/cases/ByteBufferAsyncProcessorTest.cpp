@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include "wire/ByteBufferAsyncProcessor.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+class Received
+{
+	std::mutex lock;
+	std::condition_variable cv;
+	std::vector<uint8_t> values;
+
+public:
+	bool process(Buffer::ByteArray const& message)
+	{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			values.push_back(message.front());
+		}
+		cv.notify_all();
+		return true;
+	}
+
+	std::vector<uint8_t> wait_for(size_t count)
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		cv.wait_for(guard, std::chrono::seconds(10), [&] { return values.size() >= count; });
+		return values;
+	}
+};
+}	 // namespace
+
+// the newest message of a key follows everything put before it, e.g. an intern id announcement it refers to
+TEST(byte_buffer_async_processor, coalescing_put_keeps_order)
+{
+	Received received;
+	ByteBufferAsyncProcessor processor("coalescing", [&](Buffer::ByteArray const& message, sequence_number_t) {
+		return received.process(message);
+	});
+	processor.pause("test");
+	processor.start();
+
+	processor.put({1});
+	processor.put({2}, 10);
+	processor.put({3});
+	processor.put({4}, 10);
+	processor.put({5}, 20);
+	processor.put({6}, 10);
+	processor.put({7});
+
+	processor.resume();
+	EXPECT_EQ((std::vector<uint8_t>{1, 3, 5, 6, 7}), received.wait_for(5));
+
+	// only messages that are still waiting are dropped, acknowledged ones are not sent again on resume
+	processor.acknowledge(5);
+	processor.pause("test");
+	processor.put({8}, 10);
+	processor.put({9}, 10);
+	processor.resume();
+	EXPECT_EQ((std::vector<uint8_t>{1, 3, 5, 6, 7, 9}), received.wait_for(6));
+
+	processor.stop(std::chrono::milliseconds(1000));
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "ext/ExtWire.h"
+#include "impl/RdProperty.h"
+#include "impl/RdSignal.h"
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Records the messages it is given in order, as (id hash, first byte of the payload).
+ */
+class RecordingWire final : public IWire
+{
+public:
+	mutable std::vector<std::pair<int64_t, uint8_t>> sent;
+
+	void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const override
+	{
+		send_packed(id, pack(id, writer));
+	}
+
+	void send_packed(RdId const& id, Buffer::ByteArray message) const override
+	{
+		sent.emplace_back(id.get_hash(), message.front());
+	}
+
+	void advise(Lifetime /*lifetime*/, IRdReactive const* /*entity*/) const override
+	{
+	}
+};
+
+class ExtWireTest : public ::testing::TestWithParam<bool>
+{
+protected:
+	RecordingWire real;
+	ExtWire wire;
+	RdProperty<int> property;
+	RdId a{10};
+	RdId b{11};
+
+	ExtWireTest()
+	{
+		wire.realWire = &real;
+		statics(property, 1);
+		if (GetParam())
+		{
+			// messages are one byte, all but the newest one go to the spill file
+			wire.memory_limit = 1;
+			wire.spill_path = ::testing::TempDir() + "ExtWireTest.bin";
+		}
+	}
+
+	void send(RdId const& id, uint8_t value)
+	{
+		wire.send(id, [value](Buffer& buffer) { buffer.write_integral<uint8_t>(value); });
+	}
+};
+}	 // namespace
+
+// the newest value of a property follows the messages queued before it, e.g. an intern id it refers to
+TEST_P(ExtWireTest, keep_latest_keeps_order)
+{
+	wire.keep_latest(property);
+	send(property.rdid, 1);
+	send(a, 2);
+	send(property.rdid, 3);
+	send(b, 4);
+	send(property.rdid, 5);
+	send(a, 6);
+	EXPECT_TRUE(real.sent.empty());
+
+	wire.connected.set(true);
+	const int64_t p = property.rdid.get_hash();
+	EXPECT_EQ((std::vector<std::pair<int64_t, uint8_t>>{{a.get_hash(), 2}, {b.get_hash(), 4}, {p, 5}, {a.get_hash(), 6}}), real.sent);
+
+	// sent right away once connected
+	send(property.rdid, 7);
+	send(property.rdid, 8);
+	EXPECT_EQ(6u, real.sent.size());
+}
+
+TEST_P(ExtWireTest, keep_and_drop)
+{
+	wire.set_queue_policy(b, ExtWire::QueuePolicy::Drop);
+	send(a, 1);
+	send(b, 2);
+	send(a, 3);
+	wire.connected.set(true);
+	EXPECT_EQ((std::vector<std::pair<int64_t, uint8_t>>{{a.get_hash(), 1}, {a.get_hash(), 3}}), real.sent);
+}
+
+INSTANTIATE_TEST_SUITE_P(memory_and_spill_file, ExtWireTest, ::testing::Bool());
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include "util/instrumentation.h"
+
+#include <thread>
+#include <vector>
+
+using namespace rd;
+using namespace rd::instrumentation;
+
+TEST(Instrumentation, histogram)
+{
+	Histogram histogram;
+	for (uint64_t value = 0; value < 100; ++value)
+	{
+		histogram.record(value);
+	}
+	EXPECT_EQ(100u, histogram.count());
+	EXPECT_EQ(4950u, histogram.sum());
+	EXPECT_EQ(99u, histogram.max());
+	// lower bounds of the buckets, 4 per power of two above 16
+	EXPECT_EQ(0u, histogram.percentile(0));
+	EXPECT_EQ(48u, histogram.percentile(0.5));
+	EXPECT_EQ(96u, histogram.percentile(1));
+
+	histogram.reset();
+	EXPECT_EQ(0u, histogram.count());
+	EXPECT_EQ(0u, histogram.percentile(0.5));
+}
+
+TEST(Instrumentation, entity_counters)
+{
+	const RdId first(1000001);
+	const RdId second(1000002);
+	Instrumentation::reset();
+
+	EntityStats& stats = Instrumentation::entity(first);
+	EXPECT_EQ(&stats, &Instrumentation::entity(first));
+	EXPECT_EQ(first, stats.id);
+
+	// several threads account to the same entities at once
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&] {
+			for (int i = 0; i < 1000; ++i)
+			{
+				Instrumentation::on_sent(first, 10);
+				Instrumentation::on_received(second, 3);
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	EXPECT_EQ(4000u, stats.messages_sent.load());
+	EXPECT_EQ(40000u, stats.bytes_sent.load());
+	EXPECT_EQ(0u, stats.messages_received.load());
+	EXPECT_EQ(4000u, Instrumentation::entity(second).messages_received.load());
+	EXPECT_EQ(12000u, Instrumentation::entity(second).bytes_received.load());
+
+	Instrumentation::reset();
+	EXPECT_EQ(0u, stats.messages_sent.load());
+}
+
+TEST(Instrumentation, entities_beyond_limit_share_null_id)
+{
+	for (int64_t i = 0; i < static_cast<int64_t>(Instrumentation::MAX_ENTITIES) + 10; ++i)
+	{
+		Instrumentation::entity(RdId(2000000 + i));
+	}
+	EXPECT_EQ(RdId::Null(), Instrumentation::entity(RdId(3000000)).id);
+
+	size_t tracked = 0;
+	Instrumentation::for_each_entity([&tracked](EntityStats const&) { ++tracked; });
+	// and the shared entry for the rest
+	EXPECT_EQ(Instrumentation::MAX_ENTITIES + 1, tracked);
+}
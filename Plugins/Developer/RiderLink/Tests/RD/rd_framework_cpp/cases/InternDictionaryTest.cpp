@@ -0,0 +1,28 @@
+#include <gtest/gtest.h>
+
+#include "intern/InternDictionary.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace rd;
+
+TEST(InternDictionary, save_and_load)
+{
+	const std::string path = ::testing::TempDir() + "InternDictionaryTest.bin";
+	// the last one is outside the BMP, written as a surrogate pair
+	const std::vector<std::wstring> strings{L"", L"name", L"\u00e9t\u00e9", L"smile \U0001F600"};
+	ASSERT_TRUE(InternDictionary::save(path, strings));
+
+	const auto dictionary = InternDictionary::load(path);
+	std::remove(path.c_str());
+	ASSERT_NE(nullptr, dictionary);
+	ASSERT_EQ(strings.size(), dictionary->size());
+	for (size_t i = 0; i < strings.size(); ++i)
+	{
+		EXPECT_EQ(strings[i], *any::get<std::wstring>(dictionary->at(i)));
+		EXPECT_EQ(static_cast<int32_t>(i), dictionary->find(dictionary->at(i)));
+	}
+	EXPECT_EQ(1u, dictionary->get_uses(3));
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "util/RdFrameworkTestBase.h"
+
+#include "intern/InternRoot.h"
+
+#include <stdexcept>
+#include <string>
+
+using namespace rd;
+using namespace rd::test;
+
+namespace
+{
+class InternRootTest : public RdFrameworkTestBase
+{
+protected:
+	InternRoot client_root;
+	InternRoot server_root;
+
+	InternRootTest()
+	{
+		statics(client_root, 1);
+		statics(server_root, 1);
+		bindStatic(clientProtocol.get(), client_root, "root");
+		bindStatic(serverProtocol.get(), server_root, "root");
+	}
+
+	static int32_t intern(InternRoot const& root, std::wstring value)
+	{
+		return root.intern_value<std::wstring>(wrapper::make_wrapper<std::wstring>(std::move(value)));
+	}
+
+	static std::wstring un_intern(InternRoot const& root, int32_t id)
+	{
+		return *root.un_intern_value<std::wstring>(id);
+	}
+
+	// interns [count] values named [prefix] and a number on the client
+	void intern_all(std::wstring const& prefix, int count)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			intern(client_root, prefix + std::to_wstring(i));
+		}
+	}
+};
+}	 // namespace
+
+TEST_F(InternRootTest, values_are_shared)
+{
+	EXPECT_EQ(0, intern(client_root, L"a"));
+	EXPECT_EQ(0, intern(client_root, L"a"));
+	EXPECT_EQ(2, intern(client_root, L"b"));
+	process_all_messages();
+
+	// the server writes the client's id, seen from its side
+	EXPECT_EQ(L"b", un_intern(server_root, 2 ^ 1));
+	EXPECT_EQ(2 ^ 1, intern(server_root, L"b"));
+	EXPECT_EQ(0, intern(server_root, L"c"));
+	process_all_messages();
+	EXPECT_EQ(L"c", un_intern(client_root, 0 ^ 1));
+
+	AfterTest();
+}
+
+// the index and the values of both sides stay within a few generations
+TEST_F(InternRootTest, generations_free_values)
+{
+	client_root.capacity = 64;
+
+	// the 64th value starts a new generation, the server acknowledges it
+	intern_all(L"a", 64);
+	process_all_messages();
+	EXPECT_EQ(L"a5", un_intern(server_root, 10 ^ 1));
+	// dropped from both indexes, so interned again on either side it gets a new id
+	EXPECT_EQ(0, intern(server_root, L"a5"));
+	EXPECT_EQ(128, intern(client_root, L"a0"));
+	process_all_messages();
+	EXPECT_EQ(L"a0", un_intern(server_root, 128 ^ 1));
+
+	// the first generation stays resolvable until the next one is acknowledged
+	EXPECT_EQ(L"a1", un_intern(client_root, 2));
+	EXPECT_EQ(L"a1", un_intern(server_root, 2 ^ 1));
+	intern_all(L"b", 63);
+	process_all_messages();
+
+	EXPECT_THROW(un_intern(client_root, 2), std::runtime_error);
+	EXPECT_THROW(un_intern(server_root, 2 ^ 1), std::runtime_error);
+	EXPECT_EQ(L"a0", un_intern(client_root, 128));
+	EXPECT_EQ(L"a0", un_intern(server_root, 128 ^ 1));
+	EXPECT_EQ(L"b62", un_intern(server_root, 254 ^ 1));
+	// the server's own values have no generations of their own
+	EXPECT_EQ(L"a5", un_intern(client_root, 0 ^ 1));
+
+	AfterTest();
+}
+
+TEST_F(InternRootTest, generations_without_acknowledgement)
+{
+	client_root.capacity = 64;
+
+	// the server never answers, so the client keeps the values and only drops them from its index
+	intern_all(L"a", 64);
+	intern_all(L"b", 64);
+	intern_all(L"c", 64);
+	EXPECT_EQ(128 * 3, intern(client_root, L"a0"));
+	EXPECT_EQ(L"a1", un_intern(client_root, 2));
+
+	AfterTest();
+}
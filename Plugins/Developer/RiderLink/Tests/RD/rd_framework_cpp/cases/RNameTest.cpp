@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+
+#include "impl/RName.h"
+
+#include <string>
+
+using namespace rd;
+
+TEST(rname, members)
+{
+	const RName root("root");
+	EXPECT_EQ("root.model::child", to_string(root.sub("model", ".").sub("child", "::")));
+	EXPECT_EQ("", to_string(RName()));
+}
+
+// the key of an entry is formatted when its name is first printed, and only then
+TEST(rname, entry_formats_key_once)
+{
+	int calls = 0;
+	const RName map = RName("root").sub("map", ".");
+	const RName entry = map.sub_entry([&calls] {
+		++calls;
+		return std::to_string(42);
+	});
+	const RName child = entry.sub("value", ".");
+	EXPECT_EQ(0, calls);
+
+	EXPECT_EQ("root.map.[42].value", to_string(child));
+	EXPECT_EQ("root.map.[42]", to_string(entry));
+	EXPECT_EQ(1, calls);
+}
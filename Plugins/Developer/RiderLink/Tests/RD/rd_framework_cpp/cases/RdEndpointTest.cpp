@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include "util/RdFrameworkTestBase.h"
+
+#include "task/RdCall.h"
+#include "task/RdEndpoint.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace rd;
+using namespace rd::test;
+
+namespace
+{
+class RdEndpointTest : public RdFrameworkTestBase
+{
+protected:
+	static std::vector<bool> results(std::vector<RdTask<bool>> const& tasks)
+	{
+		std::vector<bool> values;
+		for (auto const& task : tasks)
+		{
+			EXPECT_TRUE(task.is_succeeded());
+			values.push_back(task.is_succeeded() && task.value_or_throw().unwrap());
+		}
+		return values;
+	}
+};
+}	 // namespace
+
+// std::vector<bool> hands out proxies instead of references, the batch handler result must still be iterable
+TEST_F(RdEndpointTest, bool_batch_handler)
+{
+	RdCall<std::wstring, bool> client_call;
+	RdEndpoint<std::wstring, bool> server_endpoint;
+	statics(client_call, 1);
+	statics(server_endpoint, 1);
+	server_endpoint.set_batch([](Lifetime, std::vector<std::wstring> const& paths) {
+		std::vector<bool> values;
+		for (auto const& path : paths)
+		{
+			values.push_back(path.rfind(L"/Game/", 0) == 0);
+		}
+		return values;
+	});
+	bindStatic(clientProtocol.get(), client_call, "call");
+	bindStatic(serverProtocol.get(), server_endpoint, "call");
+
+	auto tasks = client_call.start_batch({L"/Game/A", L"/Engine/B", L"/Game/C"});
+	process_all_messages();
+	EXPECT_EQ((std::vector<bool>{true, false, true}), results(tasks));
+
+	AfterTest();
+}
+
+TEST_F(RdEndpointTest, bool_batch_single_handler)
+{
+	RdCall<int, bool> client_call;
+	RdEndpoint<int, bool> server_endpoint;
+	statics(client_call, 1);
+	statics(server_endpoint, 1);
+	server_endpoint.set([](int const& value) { return value % 2 == 0; });
+	bindStatic(clientProtocol.get(), client_call, "call");
+	bindStatic(serverProtocol.get(), server_endpoint, "call");
+
+	auto tasks = client_call.start_batch({1, 2, 3, 4});
+	process_all_messages();
+	EXPECT_EQ((std::vector<bool>{false, true, false, true}), results(tasks));
+
+	AfterTest();
+}
+
+// generated models move their endpoints in the primary constructor
+TEST_F(RdEndpointTest, moved_endpoint_keeps_cache)
+{
+	int calls = 0;
+	RdEndpoint<int, bool> source([&calls](int const& value) {
+		++calls;
+		return value > 0;
+	});
+	source.enable_cache(4);
+	RdEndpoint<int, bool> server_endpoint(std::move(source));
+	RdCall<int, bool> client_call;
+	statics(client_call, 1);
+	statics(server_endpoint, 1);
+	bindStatic(clientProtocol.get(), client_call, "call");
+	bindStatic(serverProtocol.get(), server_endpoint, "call");
+
+	auto first = client_call.start(1);
+	process_all_messages();
+	auto second = client_call.start(1);
+	process_all_messages();
+	auto third = client_call.start(-1);
+	process_all_messages();
+
+	EXPECT_EQ((std::vector<bool>{true, true, false}), results({first, second, third}));
+	EXPECT_EQ(2, calls);
+
+	server_endpoint.invalidate_cache();
+	auto fourth = client_call.start(1);
+	process_all_messages();
+	EXPECT_TRUE(fourth.value_or_throw().unwrap());
+	EXPECT_EQ(3, calls);
+
+	AfterTest();
+}
+
+// a result set locally completes the task the same way a response does
+TEST_F(RdEndpointTest, local_completion_wakes_waiter)
+{
+	RdCall<int, bool> client_call;
+	statics(client_call, 1);
+	bindStatic(clientProtocol.get(), client_call, "call");
+
+	auto task = client_call.start(1);
+	std::thread completer([task] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		task.set(true);
+	});
+	task.wait(std::chrono::seconds(30));
+	completer.join();
+	EXPECT_TRUE(task.is_succeeded());
+
+	// completed once, later results are dropped
+	clientWire->drop_queued_messages();
+	task.cancel();
+	EXPECT_TRUE(task.is_succeeded());
+
+	AfterTest();
+}
+
+TEST_F(RdEndpointTest, sync_throws_when_faulted)
+{
+	RdCall<int, bool> client_call;
+	RdEndpoint<int, bool> server_endpoint;
+	statics(client_call, 1);
+	statics(server_endpoint, 1);
+	server_endpoint.set([](int const&) -> bool { throw std::runtime_error("handler failed"); });
+	bindStatic(clientProtocol.get(), client_call, "call");
+	bindStatic(serverProtocol.get(), server_endpoint, "call");
+
+	// the test wires only deliver on demand, so the request is answered while sync waits
+	std::thread responder([this] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		process_all_messages();
+	});
+	EXPECT_THROW(client_call.sync(1, std::chrono::seconds(30)), std::runtime_error);
+	responder.join();
+
+	AfterTest();
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include "util/RdFrameworkTestBase.h"
+
+#include "impl/RdMap.h"
+
+#include <map>
+
+using namespace rd;
+using namespace rd::test;
+
+namespace
+{
+/**
+ * \brief A master and a slave map, the slave acknowledges each change or, with the parameter set, all of them at once.
+ */
+class RdMapPendingAckTest : public RdFrameworkTestBase, public ::testing::WithParamInterface<bool>
+{
+protected:
+	RdMap<int, int> server_map;
+	RdMap<int, int> client_map;
+
+	RdMapPendingAckTest()
+	{
+		server_map.is_master = true;
+		client_map.batch_acks = GetParam();
+		statics(server_map, 1);
+		statics(client_map, 1);
+		bindStatic(serverProtocol.get(), server_map, "map");
+		bindStatic(clientProtocol.get(), client_map, "map");
+	}
+
+	static std::map<int, int> entries(RdMap<int, int> const& map)
+	{
+		std::map<int, int> result;
+		for (auto it = map.begin(); it != map.end(); ++it)
+		{
+			result.emplace(it.key(), it.value());
+		}
+		return result;
+	}
+};
+}	 // namespace
+
+// key 2 takes the entry erased for key 1 while both keys still wait for the slave's ACK
+TEST_P(RdMapPendingAckTest, rejects_slave_changes)
+{
+	server_map.set(1, 1);
+	server_map.remove(1);
+	server_map.set(2, 2);
+	client_map.set(1, 10);
+	client_map.set(2, 20);
+	client_map.set(3, 30);
+	clientWire->process_all_messages();
+
+	EXPECT_EQ(nullptr, server_map.get(1));
+	EXPECT_EQ(2, *server_map.get(2));
+	EXPECT_EQ(30, *server_map.get(3));
+
+	process_all_messages();
+	EXPECT_EQ((std::map<int, int>{{2, 2}, {3, 30}}), entries(client_map));
+	EXPECT_EQ(entries(server_map), entries(client_map));
+
+	// acknowledged, so the slave's changes to the same keys are accepted
+	client_map.set(1, 11);
+	client_map.set(2, 21);
+	process_all_messages();
+	EXPECT_EQ((std::map<int, int>{{1, 11}, {2, 21}, {3, 30}}), entries(server_map));
+
+	AfterTest();
+}
+
+// a key stays pending until every change of it is acknowledged
+TEST_P(RdMapPendingAckTest, several_changes_of_one_key)
+{
+	server_map.set(1, 1);
+	server_map.set(1, 2);
+	server_map.set(1, 3);
+	client_map.set(1, 10);
+	clientWire->process_all_messages();
+	EXPECT_EQ(3, *server_map.get(1));
+
+	process_all_messages();
+	EXPECT_EQ(3, *client_map.get(1));
+
+	client_map.set(1, 11);
+	process_all_messages();
+	EXPECT_EQ(11, *server_map.get(1));
+
+	AfterTest();
+}
+
+INSTANTIATE_TEST_SUITE_P(single_and_cumulative_acks, RdMapPendingAckTest, ::testing::Bool());
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include "util/RdFrameworkTestBase.h"
+
+#include "impl/RdMap.h"
+
+#include <map>
+
+using namespace rd;
+using namespace rd::test;
+
+static_assert(ViewableMap<int, int>::inline_storage, "RdMap<int, int> is expected to store its entries in place");
+
+namespace
+{
+class RdMapTest : public RdFrameworkTestBase
+{
+protected:
+	static std::map<int, int> entries(RdMap<int, int> const& map)
+	{
+		std::map<int, int> result;
+		for (auto it = map.begin(); it != map.end(); ++it)
+		{
+			result.emplace(it.key(), it.value());
+		}
+		return result;
+	}
+};
+}	 // namespace
+
+TEST_F(RdMapTest, recycled_entries_replicate)
+{
+	RdMap<int, int> server_map;
+	RdMap<int, int> client_map;
+	server_map.is_master = true;
+	statics(server_map, 1);
+	statics(client_map, 1);
+	bindStatic(serverProtocol.get(), server_map, "map");
+	bindStatic(clientProtocol.get(), client_map, "map");
+
+	for (int i = 0; i < 200; ++i)
+	{
+		server_map.set(i, i);
+		if (i % 3 == 0)
+		{
+			server_map.remove(i / 2);
+		}
+	}
+	process_all_messages();
+
+	EXPECT_EQ(entries(server_map), entries(client_map));
+
+	AfterTest();
+}
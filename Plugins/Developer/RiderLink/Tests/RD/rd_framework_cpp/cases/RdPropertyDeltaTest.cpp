@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+
+#include "util/RdFrameworkTestBase.h"
+
+#include "impl/RdProperty.h"
+#include "serialization/Delta.h"
+
+#include <string>
+
+using namespace rd;
+using namespace rd::test;
+
+namespace rd
+{
+namespace test
+{
+/**
+ * \brief Written by hand the way a generated struct would support differences.
+ */
+struct Point
+{
+	int32_t x = 0;
+	int32_t y = 0;
+	std::wstring label;
+
+	// number of differences applied in this process
+	static int patches;
+
+	static Point read(SerializationCtx& /*ctx*/, Buffer& buffer)
+	{
+		Point result;
+		result.x = buffer.read_integral<int32_t>();
+		result.y = buffer.read_integral<int32_t>();
+		result.label = buffer.read_wstring();
+		return result;
+	}
+
+	void write(SerializationCtx& /*ctx*/, Buffer& buffer) const
+	{
+		buffer.write_integral<int32_t>(x);
+		buffer.write_integral<int32_t>(y);
+		buffer.write_wstring(label);
+	}
+
+	void write_diff(SerializationCtx& /*ctx*/, Buffer& buffer, Point const& base) const
+	{
+		DeltaWriter writer(buffer);
+		writer.field(x, base.x, [&buffer](int32_t value) { buffer.write_integral<int32_t>(value); });
+		writer.field(y, base.y, [&buffer](int32_t value) { buffer.write_integral<int32_t>(value); });
+		writer.field(label, base.label, [&buffer](std::wstring const& value) { buffer.write_wstring(value); });
+	}
+
+	void patch(SerializationCtx& /*ctx*/, Buffer& buffer)
+	{
+		DeltaReader reader(buffer);
+		reader.field([&] { x = buffer.read_integral<int32_t>(); });
+		reader.field([&] { y = buffer.read_integral<int32_t>(); });
+		reader.field([&] { label = buffer.read_wstring(); });
+		++patches;
+	}
+
+	friend bool operator==(Point const& lhs, Point const& rhs)
+	{
+		return lhs.x == rhs.x && lhs.y == rhs.y && lhs.label == rhs.label;
+	}
+
+	friend bool operator!=(Point const& lhs, Point const& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	friend std::string to_string(Point const& value)
+	{
+		return "(" + std::to_string(value.x) + ", " + std::to_string(value.y) + ", " + rd::to_string(value.label) + ")";
+	}
+};
+
+int Point::patches = 0;
+
+static_assert(util::has_delta<Point>::value, "Point must support differences");
+}	 // namespace test
+}	 // namespace rd
+
+namespace
+{
+class RdPropertyDeltaTest : public RdFrameworkTestBase
+{
+protected:
+	RdProperty<Point> client_property{Point{}};
+	RdProperty<Point> server_property{Point{}};
+
+	RdPropertyDeltaTest()
+	{
+		Point::patches = 0;
+		statics(client_property, 1);
+		statics(server_property, 1);
+		client_property.send_deltas = true;
+		server_property.send_deltas = true;
+		bindStatic(clientProtocol.get(), client_property, "property");
+		bindStatic(serverProtocol.get(), server_property, "property");
+	}
+};
+}	 // namespace
+
+TEST_F(RdPropertyDeltaTest, full_value_then_patch)
+{
+	client_property.set(Point{1, 2, L"a"});
+	process_all_messages();
+	EXPECT_EQ((Point{1, 2, L"a"}), server_property.get());
+	EXPECT_EQ(0, Point::patches);
+
+	client_property.set(Point{1, 3, L"a"});
+	process_all_messages();
+	EXPECT_EQ((Point{1, 3, L"a"}), server_property.get());
+	EXPECT_EQ(1, Point::patches);
+
+	// the other way round the first value is sent in full again
+	server_property.set(Point{4, 3, L"b"});
+	process_all_messages();
+	EXPECT_EQ((Point{4, 3, L"b"}), client_property.get());
+	EXPECT_EQ(1, Point::patches);
+
+	AfterTest();
+}
+
+// a difference applies to the last value received from its sender, whatever the receiver set meanwhile
+TEST_F(RdPropertyDeltaTest, crossing_changes)
+{
+	client_property.set(Point{1, 1, L"a"});
+	server_property.set(Point{2, 2, L"b"});
+	process_all_messages();
+	EXPECT_EQ((Point{2, 2, L"b"}), client_property.get());
+	EXPECT_EQ((Point{1, 1, L"a"}), server_property.get());
+
+	client_property.set(Point{1, 5, L"a"});
+	process_all_messages();
+	EXPECT_EQ((Point{1, 5, L"a"}), server_property.get());
+	EXPECT_EQ(1, Point::patches);
+
+	AfterTest();
+}
+
+TEST_F(RdPropertyDeltaTest, gap_requests_resend)
+{
+	client_property.set(Point{1, 1, L"a"});
+	process_all_messages();
+	client_property.set(Point{1, 2, L"a"});
+	clientWire->drop_queued_messages();
+
+	// based on the dropped message, so the server asks for the full value
+	client_property.set(Point{1, 3, L"a"});
+	process_all_messages();
+	EXPECT_EQ((Point{1, 3, L"a"}), server_property.get());
+	EXPECT_EQ(0, Point::patches);
+
+	client_property.set(Point{7, 3, L"a"});
+	process_all_messages();
+	EXPECT_EQ((Point{7, 3, L"a"}), server_property.get());
+	EXPECT_EQ(1, Point::patches);
+
+	AfterTest();
+}
+
+// a rejected difference still is the base of the next one from the same side
+TEST_F(RdPropertyDeltaTest, rejected_version)
+{
+	client_property.is_master = true;
+	client_property.set(Point{0, 0, L"m"});
+	process_all_messages();
+	server_property.set(Point{1, 1, L"s"});
+	process_all_messages();
+	EXPECT_EQ((Point{1, 1, L"s"}), client_property.get());
+
+	client_property.set(Point{9, 9, L"m"});
+	server_property.set(Point{2, 1, L"s"});
+	process_all_messages();
+	EXPECT_EQ((Point{9, 9, L"m"}), client_property.get());
+	EXPECT_EQ((Point{9, 9, L"m"}), server_property.get());
+
+	server_property.set(Point{2, 5, L"s"});
+	process_all_messages();
+	EXPECT_EQ((Point{2, 5, L"s"}), client_property.get());
+
+	AfterTest();
+}
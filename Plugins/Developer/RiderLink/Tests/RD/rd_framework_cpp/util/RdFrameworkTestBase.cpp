@@ -0,0 +1,33 @@
+#include "RdFrameworkTestBase.h"
+
+namespace rd
+{
+namespace test
+{
+RdFrameworkTestBase::RdFrameworkTestBase()
+	: clientWire(std::make_shared<TestWire>(&clientScheduler))
+	, serverWire(std::make_shared<TestWire>(&serverScheduler))
+{
+	clientWire->counterpart = serverWire.get();
+	serverWire->counterpart = clientWire.get();
+
+	clientProtocol = std::make_unique<Protocol>(Identities::CLIENT, &clientScheduler, clientWire, clientLifetimeDef.lifetime);
+	serverProtocol = std::make_unique<Protocol>(Identities::SERVER, &serverScheduler, serverWire, serverLifetimeDef.lifetime);
+}
+
+void RdFrameworkTestBase::process_all_messages() const
+{
+	while (clientWire->queued_messages() > 0 || serverWire->queued_messages() > 0)
+	{
+		clientWire->process_all_messages();
+		serverWire->process_all_messages();
+	}
+}
+
+void RdFrameworkTestBase::AfterTest()
+{
+	clientLifetimeDef.terminate();
+	serverLifetimeDef.terminate();
+}
+}	 // namespace test
+}	 // namespace rd
@@ -0,0 +1,54 @@
+#ifndef RD_CPP_RDFRAMEWORKTESTBASE_H
+#define RD_CPP_RDFRAMEWORKTESTBASE_H
+
+#include <gtest/gtest.h>
+
+#include "TestWire.h"
+
+#include "lifetime/LifetimeDefinition.h"
+#include "protocol/Protocol.h"
+#include "scheduler/SimpleScheduler.h"
+
+#include <memory>
+
+namespace rd
+{
+namespace test
+{
+/**
+ * \brief A server and a client protocol connected by \a TestWire s. Entities declared in a test must be unbound with
+ * [AfterTest] before they are destroyed.
+ */
+class RdFrameworkTestBase : public ::testing::Test
+{
+protected:
+	SimpleScheduler clientScheduler;
+	SimpleScheduler serverScheduler;
+
+	LifetimeDefinition clientLifetimeDef;
+	LifetimeDefinition serverLifetimeDef;
+
+	std::shared_ptr<TestWire> clientWire;
+	std::shared_ptr<TestWire> serverWire;
+
+	std::unique_ptr<Protocol> clientProtocol;
+	std::unique_ptr<Protocol> serverProtocol;
+
+	RdFrameworkTestBase();
+
+	template <typename T>
+	T& bindStatic(Protocol* protocol, T& entity, string_view name)
+	{
+		Lifetime lifetime = protocol == serverProtocol.get() ? serverLifetimeDef.lifetime : clientLifetimeDef.lifetime;
+		entity.bind(lifetime, protocol, name);
+		return entity;
+	}
+
+	void process_all_messages() const;
+
+	void AfterTest();
+};
+}	 // namespace test
+}	 // namespace rd
+
+#endif	  // RD_CPP_RDFRAMEWORKTESTBASE_H
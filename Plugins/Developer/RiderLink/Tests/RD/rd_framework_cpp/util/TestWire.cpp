@@ -0,0 +1,40 @@
+#include "TestWire.h"
+
+namespace rd
+{
+namespace test
+{
+TestWire::TestWire(IScheduler* scheduler) : WireBase(scheduler)
+{
+	connected.set(true);
+}
+
+void TestWire::send(RdId const& id, std::function<void(Buffer& buffer)> writer) const
+{
+	Buffer buffer;
+	buffer.write_integral<int16_t>(0);	  // context, skipped by MessageBroker
+	writer(buffer);
+	msgQ.emplace_back(id, std::move(buffer).getRealArray());
+}
+
+void TestWire::process_all_messages() const
+{
+	while (!msgQ.empty())
+	{
+		auto message = std::move(msgQ.front());
+		msgQ.pop_front();
+		counterpart->message_broker.dispatch(message.first, Buffer(std::move(message.second)));
+	}
+}
+
+void TestWire::drop_queued_messages() const
+{
+	msgQ.clear();
+}
+
+size_t TestWire::queued_messages() const
+{
+	return msgQ.size();
+}
+}	 // namespace test
+}	 // namespace rd
@@ -0,0 +1,39 @@
+#ifndef RD_CPP_TESTWIRE_H
+#define RD_CPP_TESTWIRE_H
+
+#include "base/WireBase.h"
+
+#include <deque>
+#include <utility>
+
+namespace rd
+{
+namespace test
+{
+/**
+ * \brief In-process wire. Sent messages are queued until [process_all_messages] delivers them to the [counterpart].
+ */
+class TestWire : public WireBase
+{
+	mutable std::deque<std::pair<RdId, Buffer::ByteArray>> msgQ;
+
+public:
+	TestWire* counterpart = nullptr;
+
+	explicit TestWire(IScheduler* scheduler);
+
+	void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const override;
+
+	void process_all_messages() const;
+
+	/**
+	 * \brief Drops the queued messages as a lossy connection would.
+	 */
+	void drop_queued_messages() const;
+
+	size_t queued_messages() const;
+};
+}	 // namespace test
+}	 // namespace rd
+
+#endif	  // RD_CPP_TESTWIRE_H